@@ -105,6 +105,35 @@ LoopFillZerobss:
   cmp  r2, r3
   bcc  FillZerobss
 
+/* Copy the hot code from flash to ITCM */
+  ldr  r0, =_sitcm_text
+  ldr  r1, =_eitcm_text
+  ldr  r2, =_siitcm_text
+  b  LoopCopyItcm
+
+CopyItcm:
+  ldr  r3, [r2], #4
+  str  r3, [r0], #4
+
+LoopCopyItcm:
+  cmp  r0, r1
+  bcc  CopyItcm
+  dsb
+  isb
+
+/* Zero fill the DTCM bss segment. */
+  ldr  r2, =_sdtcm_bss
+  ldr  r1, =_edtcm_bss
+  movs  r3, #0
+  b  LoopFillZeroDtcm
+
+FillZeroDtcm:
+  str  r3, [r2], #4
+
+LoopFillZeroDtcm:
+  cmp  r2, r1
+  bcc  FillZeroDtcm
+
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
 /* Call static constructors */
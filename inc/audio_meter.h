@@ -0,0 +1,55 @@
+#ifndef AUDIO_METER_H
+#define AUDIO_METER_H
+
+#include <stdint.h>
+
+/* Histogram of the callback cost, 1% of the budget per bucket, the last one collects the rest */
+#define AUDIO_METER_BUCKETS 128
+
+/* Aggregated cost of the audio callbacks */
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+    uint32_t xruns; /* callbacks longer than the budget, the DMA caught up with them */
+    uint32_t hist[AUDIO_METER_BUCKETS];
+} audio_meter_stats_t;
+
+/*
+ * Written by the audio interrupt only, read by the main loop with a sequence lock: the writer
+ * never waits, the reader copies the stats again when an update ran during the copy.
+ */
+typedef struct
+{
+    uint32_t seq;            /* odd while the writer updates the stats */
+    uint32_t reset;          /* set by the reader, the writer clears the stats on its next update */
+    uint32_t budget;         /* cycles of one callback period */
+    uint32_t scale;          /* (cycles * scale) >> 32 is the histogram bucket */
+    audio_meter_stats_t stats;
+} audio_meter_t;
+
+/* Results in cycles and in percent of the budget (fixed point with two decimals) */
+typedef struct
+{
+    uint32_t count;
+    uint32_t xruns;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+    uint32_t load_x100; /* average */
+    uint32_t p99_x100;
+    uint32_t peak_x100;     /* worst callback */
+    int32_t headroom_x100;  /* budget left by the worst callback, negative after an xrun */
+} audio_meter_report_t;
+
+void audio_meter_init(audio_meter_t *meter, uint32_t budget);
+void audio_meter_set_budget(audio_meter_t *meter, uint32_t budget);
+void audio_meter_add(audio_meter_t *meter, uint32_t cycles);
+void audio_meter_snapshot(const audio_meter_t *meter, audio_meter_stats_t *stats);
+void audio_meter_reset(audio_meter_t *meter);
+void audio_meter_report(const audio_meter_stats_t *stats, uint32_t budget, audio_meter_report_t *report);
+
+#endif /*AUDIO_METER_H*/
@@ -0,0 +1,81 @@
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <stdint.h>
+
+#define BIQUAD_STAGES_MAX 4
+/* Channels filtered side by side, one per lane of the vectors */
+#define BIQUAD_LANES 4
+/* Every channel of a cascade, for biquad_f32_set() and biquad_q31_set() */
+#define BIQUAD_ALL UINT32_MAX
+/* Fractional bits of the coefficients of the Q31 cascade: Q2.29, from -4 to 4 */
+#define BIQUAD_Q31_SHIFT 29
+
+/* Designs of the RBJ Audio EQ Cookbook */
+typedef enum
+{
+    BIQUAD_LOWPASS,
+    BIQUAD_HIGHPASS,
+    BIQUAD_PEAK,
+    BIQUAD_LOWSHELF,
+    BIQUAD_HIGHSHELF,
+} biquad_type_t;
+
+/* Coefficients normalised by a0: y[n] = b0·x[n] + b1·x[n-1] + b2·x[n-2] - a1·y[n-1] - a2·y[n-2] */
+typedef struct
+{
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+} biquad_coef_t;
+
+/*
+ * Cascade of transposed direct form II sections over interleaved frames. The channels are the
+ * lanes: every array is [stage][lane], so one step of a section is the same operation on
+ * BIQUAD_LANES consecutive values, whatever the number of channels (the lanes above it stay idle).
+ */
+typedef struct
+{
+    float b0[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float b1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float b2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float a1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float a2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float s1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float s2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    uint32_t stages;
+    uint32_t channels;
+} biquad_f32_t;
+
+/*
+ * Same cascade in fixed point: samples and states in Q31, coefficients in Q2.29, 64-bit products.
+ * Without a vector form of these products the channels are filtered one after the other.
+ */
+typedef struct
+{
+    int32_t b0[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t b1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t b2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t a1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t a2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t s1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    int32_t s2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    uint32_t stages;
+    uint32_t channels;
+} biquad_q31_t;
+
+uint8_t biquad_design(biquad_coef_t *coef, biquad_type_t type, uint32_t rate, float f0, float q, float gain_db);
+
+uint8_t biquad_f32_init(biquad_f32_t *bq, uint32_t channels, uint32_t stages);
+uint8_t biquad_f32_set(biquad_f32_t *bq, uint32_t stage, uint32_t ch, const biquad_coef_t *coef);
+void biquad_f32_reset(biquad_f32_t *bq);
+void biquad_f32_process(biquad_f32_t *bq, const float *in, float *out, uint32_t frames);
+
+uint8_t biquad_q31_init(biquad_q31_t *bq, uint32_t channels, uint32_t stages);
+uint8_t biquad_q31_set(biquad_q31_t *bq, uint32_t stage, uint32_t ch, const biquad_coef_t *coef);
+void biquad_q31_reset(biquad_q31_t *bq);
+void biquad_q31_process(biquad_q31_t *bq, const int16_t *in, int16_t *out, uint32_t frames);
+
+#endif /*BIQUAD_H*/
@@ -0,0 +1,45 @@
+#ifndef CYCLE_BENCH_H
+#define CYCLE_BENCH_H
+
+#include <stdint.h>
+
+/* Free running 32-bit cycle counter (DWT->CYCCNT on the board, any mock on the host) */
+typedef uint32_t (*cycle_read_t)(void *ctx);
+
+typedef struct
+{
+    cycle_read_t read;
+    void *ctx;
+    uint32_t overhead; /* cycles of an empty measure, taken off every measure */
+} cycle_bench_t;
+
+/* Measures of the same piece of work */
+typedef struct
+{
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+    uint32_t count;
+} cycle_stats_t;
+
+/* Integer results (no float printf on the board), fixed point with two decimals */
+typedef struct
+{
+    uint32_t avg_x100;  /* average cycles per sample */
+    uint32_t max_x100;  /* worst cycles per sample */
+    uint32_t load_x100; /* average percent of the real-time budget */
+    uint32_t peak_x100; /* worst percent of the real-time budget */
+} cycle_report_t;
+
+void cycle_bench_init(cycle_bench_t *cb, cycle_read_t read, void *ctx);
+uint32_t cycle_bench_start(const cycle_bench_t *cb);
+uint32_t cycle_bench_elapsed(const cycle_bench_t *cb, uint32_t start);
+void cycle_bench_run(const cycle_bench_t *cb, void (*fn)(void *arg), void *arg, uint32_t repeats,
+                     cycle_stats_t *stats);
+
+void cycle_stats_reset(cycle_stats_t *stats);
+void cycle_stats_add(cycle_stats_t *stats, uint32_t cycles);
+uint32_t cycle_budget(uint32_t cycles_per_s, uint32_t rate, uint32_t frames);
+void cycle_stats_report(const cycle_stats_t *stats, uint32_t samples, uint32_t budget, cycle_report_t *report);
+
+#endif /*CYCLE_BENCH_H*/
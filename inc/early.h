@@ -0,0 +1,59 @@
+#ifndef EARLY_H
+#define EARLY_H
+
+#include <stdint.h>
+
+#include <reverb_mem.h>
+
+#define EARLY_TAPS_MAX 64
+
+/* One reflection: delay after the pre-delay, gain and one-pole low-pass */
+typedef struct
+{
+    float ms;
+    float gain;
+    float damp; /* y[n] = (1 - damp)·x[n] + damp·y[n-1], 0 for a plain tap */
+} early_tap_t;
+
+/* Pattern of reflections, independent from the sample rate */
+typedef struct
+{
+    float predelay_ms;
+    uint32_t taps;
+    early_tap_t tap[EARLY_TAPS_MAX];
+} early_config_t;
+
+/*
+ * Early reflections: up to EARLY_TAPS_MAX taps read from one shared line. The line is a float ring
+ * of the longest delay plus a block, followed by a copy of its first block, so the samples of a tap
+ * over a block are one contiguous segment. The plain taps are multiply-adds of segments into the
+ * block sum (the loop the compiler vectorises), a damped tap runs its one-pole filter along its
+ * segment.
+ */
+typedef struct
+{
+    float *buf;    /* ring of input samples, then a copy of its first block */
+    uint32_t len;  /* ring length */
+    uint32_t pos;  /* write index */
+    uint32_t block; /* maximum number of samples processed at once */
+    float *acc;    /* sum of the taps over a block */
+    uint32_t taps;
+    uint32_t delay[EARLY_TAPS_MAX]; /* in samples, pre-delay included */
+    float gain[EARLY_TAPS_MAX];
+    float damp[EARLY_TAPS_MAX];
+    float state[EARLY_TAPS_MAX]; /* last output of the one-pole filters */
+    early_config_t config;
+    uint32_t rate;
+} early_t;
+
+extern const early_config_t early_config_default;
+
+uint8_t early_init(early_t *er, const early_config_t *config, uint32_t rate, uint32_t max_rate, uint32_t block,
+                   reverb_arena_t *arena);
+uint8_t early_check(const early_t *er, const early_config_t *config, uint32_t rate);
+uint8_t early_set(early_t *er, const early_config_t *config, uint32_t rate);
+void early_reset(early_t *er);
+uint32_t early_reset_part(early_t *er, uint32_t from, uint32_t max);
+void early_process(early_t *er, const int32_t *in, int32_t *out, uint32_t n);
+
+#endif /*EARLY_H*/
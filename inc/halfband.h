@@ -0,0 +1,31 @@
+#ifndef HALFBAND_H
+#define HALFBAND_H
+
+#include <stdint.h>
+
+#include <reverb_mem.h>
+
+/* Pairs of non-zero coefficients around the centre tap: a 39 tap filter */
+#define HALFBAND_PAIRS 10
+#define HALFBAND_TAPS (4 * HALFBAND_PAIRS - 1)
+
+/*
+ * Half-band FIR stage which decimates or interpolates by 2 with its polyphase form: every other
+ * coefficient is zero, so a decimated sample costs HALFBAND_PAIRS multiplies (the pairs are
+ * symmetric) and an interpolated pair of samples as many, one of the pair being a plain delay.
+ * Passband to 0.2 of the high rate (ripple 0.0003), stopband from 0.3 at -69 dB. The history is
+ * kept between the calls, so a signal could be cut anywhere.
+ */
+typedef struct
+{
+    float *buf;   /* history followed by the samples of the current call */
+    uint32_t fill; /* samples of history (a decimator keeps one more when a call ends odd) */
+    uint32_t nmax; /* largest call */
+} halfband_t;
+
+uint8_t halfband_init(halfband_t *hb, uint32_t nmax, reverb_arena_t *arena);
+void halfband_reset(halfband_t *hb);
+uint32_t halfband_decimate(halfband_t *hb, const float *in, float *out, uint32_t n);
+void halfband_interpolate(halfband_t *hb, const float *in, float *out, uint32_t n);
+
+#endif /*HALFBAND_H*/
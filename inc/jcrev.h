@@ -0,0 +1,96 @@
+#ifndef JCREV_H
+#define JCREV_H
+
+#include <stdint.h>
+
+#include <early.h>
+#include <reverb_mem.h>
+
+#define JCREV_COMBS 4
+#define JCREV_ALLPASSES 3
+
+/* Highest sample rate an instance set up with jcrev_init_config() could be switched to */
+#define JCREV_RATE_MAX 48000
+
+/* Samples converted at once by jcrev_process_f32() (on the stack) */
+#define JCREV_F32_CHUNK 256
+
+/* Samples of the lines cleared by a bypassed block, per sample of the block (jcrev_set_gate()) */
+#define JCREV_GATE_CLEAR 16
+
+/* Gains and delays (in samples) of the filters */
+typedef struct
+{
+    float g_comb[JCREV_COMBS];
+    uint32_t m_comb[JCREV_COMBS];
+    float g_ap[JCREV_ALLPASSES];
+    uint32_t m_ap[JCREV_ALLPASSES];
+} jcrev_params_t;
+
+/* Gains and delays (in milliseconds) of the filters, independent from the sample rate */
+typedef struct
+{
+    float g_comb[JCREV_COMBS];
+    float ms_comb[JCREV_COMBS];
+    float g_ap[JCREV_ALLPASSES];
+    float ms_ap[JCREV_ALLPASSES];
+} jcrev_config_t;
+
+/* Settings of a running instance, changed with jcrev_update() */
+typedef struct
+{
+    jcrev_config_t config;
+    float dry;
+    float wet;
+    float volume;
+} jcrev_settings_t;
+
+/* One reverb instance, all its memory comes from the reverb_mem_t given to jcrev_init() */
+typedef struct
+{
+    jcrev_params_t params;
+    jcrev_config_t config; /* set by jcrev_init_config() */
+    uint32_t rate;         /* sample rate of params, 0 if set up with jcrev_init() */
+    delay_line_t comb[JCREV_COMBS];
+    delay_line_t ap[JCREV_ALLPASSES];
+    reverb_mem_t *mem;
+    int32_t *ap_out;   /* allpass chain output of the block */
+    int32_t *comb_sum; /* sum of the comb outputs of the block */
+    uint32_t block;    /* maximum number of samples processed at once */
+    float out_dry;     /* dry gain of the output stage, volume included */
+    float out_wet;     /* wet gain of the output stage, volume and comb scaling included */
+    jcrev_params_t prev; /* gains at the start of a transition, the delays are still in the lines */
+    float prev_dry;
+    float prev_wet;
+    int32_t *tap;  /* new tap of a slow line during a transition, NULL without slow lines */
+    uint8_t ramp;  /* the next block moves from prev to params (jcrev_update()) */
+    uint32_t gate;  /* RMS level of a silent block in LSB, 0 when the gate is off */
+    uint32_t hold;  /* quiet samples before the bypass (jcrev_set_gate()) */
+    uint32_t quiet; /* samples the input and the tail have been quiet */
+    uint8_t idle;   /* bypassed: the lines are not updated until the input rises */
+    uint32_t clear_line; /* line cleared by the bypassed blocks: allpasses, combs, early, then done */
+    uint32_t clear_pos;  /* samples of that line already cleared */
+    early_t *early;    /* reflections before the network, NULL without (jcrev_set_early()) */
+    float early_send;  /* level of the reflections in the network input */
+} jcrev_t;
+
+extern const jcrev_config_t jcrev_config_default;
+
+void jcrev_params_from_config(const jcrev_config_t *config, uint32_t rate, jcrev_params_t *params);
+uint8_t jcrev_init(jcrev_t *rv, const jcrev_params_t *params, uint32_t block, reverb_mem_t *mem);
+uint8_t jcrev_init_config(jcrev_t *rv, const jcrev_config_t *config, uint32_t rate, uint32_t block,
+                          reverb_mem_t *mem);
+uint8_t jcrev_init_config_max(jcrev_t *rv, const jcrev_config_t *config, uint32_t rate, uint32_t max_rate,
+                              uint32_t block, reverb_mem_t *mem);
+uint8_t jcrev_check_rate(const jcrev_t *rv, uint32_t rate);
+uint8_t jcrev_set_rate(jcrev_t *rv, uint32_t rate);
+void jcrev_set_output(jcrev_t *rv, float dry, float wet, float volume);
+uint8_t jcrev_update(jcrev_t *rv, const jcrev_settings_t *settings);
+uint8_t jcrev_load(jcrev_t *rv, const jcrev_settings_t *settings);
+void jcrev_set_gate(jcrev_t *rv, uint32_t level, uint32_t hold);
+uint8_t jcrev_set_early(jcrev_t *rv, early_t *er, float send);
+void jcrev_reset(jcrev_t *rv);
+void jcrev_process(jcrev_t *rv, const int16_t *in, int16_t *out, uint32_t n);
+void jcrev_process_f32(jcrev_t *rv, const float *in, float *out, uint32_t n);
+
+#endif /*JCREV_H*/
@@ -0,0 +1,17 @@
+#ifndef JCREV_HEAP_H
+#define JCREV_HEAP_H
+
+#include <stdint.h>
+
+#include <jcrev.h>
+
+/*
+ * Instances which own their memory (taken from the heap, every line in one block), for callers
+ * which cannot lay out a reverb_mem_t, e.g. the Python binding. The handle is a plain jcrev_t, the
+ * jcrev_* functions work on it; it is released with jcrev_destroy() only.
+ */
+jcrev_t *jcrev_create(const jcrev_config_t *config, uint32_t rate, uint32_t block);
+jcrev_t *jcrev_create_params(const jcrev_params_t *params, uint32_t block);
+void jcrev_destroy(jcrev_t *rv);
+
+#endif /*JCREV_HEAP_H*/
@@ -0,0 +1,28 @@
+#ifndef JCREV_MAILBOX_H
+#define JCREV_MAILBOX_H
+
+#include <stdint.h>
+
+#include <jcrev.h>
+
+/*
+ * Settings passed from one writer (the UI) to one reader (the audio context) through three slots:
+ * the writer fills its own slot and swaps it with the middle one, the reader swaps the middle one
+ * with its own slot when it holds newer settings. Neither side ever waits or copies under a lock,
+ * the reader always gets the last settings posted and an idle mailbox costs it one load.
+ */
+typedef struct
+{
+    jcrev_settings_t slot[3];
+    uint32_t middle; /* slot shared by both sides, JCREV_MAILBOX_FRESH when not read yet */
+    uint32_t back;   /* slot of the writer */
+    uint32_t front;  /* slot of the reader */
+} jcrev_mailbox_t;
+
+#define JCREV_MAILBOX_FRESH 4u
+
+void jcrev_mailbox_init(jcrev_mailbox_t *box, const jcrev_settings_t *settings);
+void jcrev_mailbox_post(jcrev_mailbox_t *box, const jcrev_settings_t *settings);
+const jcrev_settings_t *jcrev_mailbox_fetch(jcrev_mailbox_t *box);
+
+#endif /*JCREV_MAILBOX_H*/
@@ -0,0 +1,44 @@
+#ifndef JCREV_MULTIRATE_H
+#define JCREV_MULTIRATE_H
+
+#include <stdint.h>
+
+#include <halfband.h>
+#include <jcrev.h>
+
+/* Largest decimation of the reverb network, two half-band stages */
+#define JCREV_MULTIRATE_FACTOR_MAX 4
+
+/*
+ * JCRev whose network runs at 1/2 or 1/4 of the sample rate: the reverb send is band-limited and
+ * decimated by half-band stages, the allpass and comb filters run at the low rate with lines
+ * sized for it (2 or 4 times shorter), and their output is interpolated back by the same stages
+ * and mixed with the dry signal at the full rate. The wet signal is limited to 0.2 of the low
+ * rate and comes JCREV_MULTIRATE_LATENCY() samples after the one of a full rate instance.
+ */
+typedef struct
+{
+    jcrev_t rv;        /* network at the low rate, wet output only */
+    halfband_t dec[2]; /* full rate to half, half to quarter */
+    halfband_t up[2];  /* half to full rate, quarter to half */
+    uint32_t factor;   /* 2 or 4 */
+    uint32_t block;    /* maximum number of samples processed at once, full rate */
+    float dry;         /* dry gain, volume included */
+    float *work;       /* full rate samples of a block */
+    float *half;       /* half rate samples of a block */
+    int16_t *low;      /* network input and output */
+    float *wet;        /* interpolated wet signal waiting for its input samples */
+    uint32_t queued;   /* samples in wet */
+} jcrev_multirate_t;
+
+/* Extra delay of the wet signal in samples of the full rate: the half-band stages and the queue */
+#define JCREV_MULTIRATE_LATENCY(factor) \
+    ((factor) == 4 ? 6 * (2 * HALFBAND_PAIRS - 1) + 3 : 2 * (2 * HALFBAND_PAIRS - 1) + 1)
+
+uint8_t jcrev_multirate_init(jcrev_multirate_t *mr, const jcrev_config_t *config, uint32_t rate, uint32_t factor,
+                             uint32_t block, reverb_mem_t *mem);
+void jcrev_multirate_set_output(jcrev_multirate_t *mr, float dry, float wet, float volume);
+void jcrev_multirate_reset(jcrev_multirate_t *mr);
+void jcrev_multirate_process(jcrev_multirate_t *mr, const int16_t *in, int16_t *out, uint32_t n);
+
+#endif /*JCREV_MULTIRATE_H*/
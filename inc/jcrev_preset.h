@@ -0,0 +1,35 @@
+#ifndef JCREV_PRESET_H
+#define JCREV_PRESET_H
+
+#include <stdint.h>
+
+#include <jcrev.h>
+
+/*
+ * Switch between presets without a gap: two instances take the same input, the one heard and a
+ * spare. A preset is loaded into the spare outside the audio context (clearing its lines takes
+ * time), then the audio context runs it unheard for the warm-up, so its tail builds up, and fades
+ * from the old instance to the new one with equal-power gains. The old instance becomes the spare
+ * and keeps its memory: nothing is allocated after jcrev_preset_init().
+ */
+typedef struct
+{
+    jcrev_t inst[2];
+    reverb_mem_t *mem;
+    int16_t *mix;      /* output of the incoming instance, one block */
+    uint32_t warm;     /* samples the incoming instance runs before it is heard */
+    uint32_t fade;     /* samples of the crossfade */
+    uint32_t pos;      /* samples of the switch done, audio context only */
+    uint32_t pending;  /* set by jcrev_preset_load(), cleared by the audio context after the fade */
+    uint8_t active;    /* instance heard */
+    uint8_t run;       /* a switch is in progress, audio context only */
+} jcrev_preset_t;
+
+uint8_t jcrev_preset_init(jcrev_preset_t *pm, const jcrev_config_t *capacity, const jcrev_settings_t *settings,
+                          uint32_t rate, uint32_t block, uint32_t warm, uint32_t fade, reverb_mem_t *mem);
+uint8_t jcrev_preset_load(jcrev_preset_t *pm, const jcrev_settings_t *settings);
+uint8_t jcrev_preset_busy(const jcrev_preset_t *pm);
+uint8_t jcrev_preset_set_rate(jcrev_preset_t *pm, uint32_t rate);
+void jcrev_preset_process(jcrev_preset_t *pm, const int16_t *in, int16_t *out, uint32_t n);
+
+#endif /*JCREV_PRESET_H*/
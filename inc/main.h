@@ -29,8 +29,17 @@
 #include "lcd_log.h"
 
 /* Exported Defines ----------------------------------------------------------*/
-#define AUDIO_OUT_BUFFER_SIZE                      4*1024
 #define AUDIO_IN_PCM_BUFFER_SIZE                   4*1024//4*2304 /* buffer size in half-word */
+#define AUDIO_OUT_BUFFER_SIZE                      (2*AUDIO_IN_PCM_BUFFER_SIZE) /* buffer size in bytes, same period as input */
+
+/* Sample rate of the codec at start, AUDIO_REC_SetFrequency() switches it at run time */
+#define AUDIO_FREQUENCY                            BSP_AUDIO_FREQUENCY_16K
+
+/* D-cache line size of the Cortex-M7, DMA buffer halves must be multiple of it */
+#define AUDIO_CACHE_LINE_SIZE                      32
+
+/* Place a buffer in the non-cacheable region configured by MPU_Config() */
+#define AUDIO_DMA_NOCACHE(buf)                     buf __attribute__ ((section(".dma_nocache")))
 
 #define FILEMGR_LIST_DEPDTH                        24
 #define FILEMGR_FILE_NAME_SIZE                     40
@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    mem_dma.h
+  * @brief   Header for mem_dma.c module.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MEM_DMA_H
+#define __MEM_DMA_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* DMA2 streams 0, 1, 4, 5, 6 and 7 are taken by the audio BSP (SAI and DFSDM),
+   only DMA2 can do memory-to-memory transfers */
+#define MEM_DMA_STREAM                  DMA2_Stream2
+#define MEM_DMA_CHANNEL                 DMA_CHANNEL_0
+#define MEM_DMA_IRQ                     DMA2_Stream2_IRQn
+#define MEM_DMA_IRQHandler              DMA2_Stream2_IRQHandler
+
+/* Must preempt the audio callbacks which wait for the copies */
+#define MEM_DMA_IRQ_PREPRIO             (AUDIO_OUT_IRQ_PREPRIO - 1)
+
+/* Maximum number of queued copies */
+#define MEM_DMA_QUEUE_SIZE              32
+
+/* Exported variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_mem;
+
+/* Exported functions ------------------------------------------------------- */
+void MEM_DMA_Init(void);
+uint32_t MEM_DMA_Copy(void *ctx, void *dst, const void *src, size_t size);
+void MEM_DMA_Wait(void *ctx, uint32_t seq);
+uint32_t MEM_DMA_TakeStallCycles(void);
+
+#endif /* __MEM_DMA_H */
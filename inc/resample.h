@@ -0,0 +1,41 @@
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include <stdint.h>
+
+#include <reverb_mem.h>
+
+/* Zero crossings of the sinc on each side of its centre, in periods of the lower of the two rates */
+#define RESAMPLE_ZEROS 24
+/* Largest up or down factor once the ratio is reduced (22050 to 32000 is 640 / 441) */
+#define RESAMPLE_PHASES_MAX 1024
+
+/*
+ * Streaming sample rate converter by a rational factor L / M (the two rates divided by their
+ * greatest common divisor): a Kaiser windowed-sinc low-pass at L times the input rate, cut at
+ * 0.44 of the lower rate, stored as L phases of 'taps' coefficients computed once at init. An
+ * output sample is the dot product of one phase with the last 'taps' input samples, so nothing
+ * runs at the high rate. Passband to 0.4 of the lower rate within 0.1 dB, stopband from 0.5 at
+ * -82 dB.
+ * The history and the position of the next output are kept between the calls, so a signal could
+ * be cut anywhere: after N input samples in total, ceil(N · L / M) have come out.
+ */
+typedef struct
+{
+    float *coef;   /* L phases of taps coefficients, each one reversed (oldest sample first) */
+    float *buf;    /* taps - 1 samples of history followed by the samples of the current call */
+    uint32_t up;   /* L */
+    uint32_t down; /* M */
+    uint32_t taps; /* coefficients per phase, a multiple of 8 */
+    uint32_t nmax; /* largest call */
+    uint32_t index; /* input sample of the next output, from the start of the next call */
+    uint32_t phase; /* its phase, 0 to L - 1 */
+} resample_t;
+
+uint8_t resample_init(resample_t *rs, uint32_t in_rate, uint32_t out_rate, uint32_t nmax, reverb_arena_t *arena);
+void resample_reset(resample_t *rs);
+uint32_t resample_out_max(const resample_t *rs, uint32_t n);
+uint32_t resample_latency(const resample_t *rs);
+uint32_t resample_process(resample_t *rs, const float *in, float *out, uint32_t n);
+
+#endif /*RESAMPLE_H*/
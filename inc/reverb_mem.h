@@ -0,0 +1,76 @@
+#ifndef REVERB_MEM_H
+#define REVERB_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Every block handed out by an arena starts on a D-cache line */
+#define REVERB_MEM_ALIGN 32
+
+/* Default length (in samples) from which a delay line is placed in slow memory */
+#define REVERB_MEM_SLOW_THRESHOLD 2048
+
+/* Bump allocator over a caller provided memory block */
+typedef struct
+{
+    uint8_t *base;
+    size_t size;
+    size_t used;
+} reverb_arena_t;
+
+/*
+ * Asynchronous memory-to-memory copy. start() queues a copy and returns its sequence number, the
+ * copies complete in that order; wait(seq) returns once the copy seq and the ones before it are
+ * done (the numbers wrap around, they are compared by difference).
+ */
+typedef struct
+{
+    uint32_t (*start)(void *ctx, void *dst, const void *src, size_t size);
+    void (*wait)(void *ctx, uint32_t seq);
+    void *ctx;
+} reverb_copy_t;
+
+/* Two memory tiers used to place the delay lines */
+typedef struct
+{
+    reverb_arena_t fast;     /* zero wait state memory (DTCM on the board) */
+    reverb_arena_t slow;     /* large memory with a high latency (SDRAM on the board) */
+    reverb_copy_t copy;      /* moves blocks between the tiers, memcpy when not set */
+    uint32_t slow_threshold; /* lines of at least this many samples go to slow memory */
+    uint32_t seq;            /* sequence number of the last copy started */
+} reverb_mem_t;
+
+/*
+ * Ring of samples read 'delay' samples behind the write position. A line in slow memory is never
+ * read or written by the CPU: each block works on a window in fast memory which was prefetched
+ * during the previous block and is written back while the next one is computed.
+ */
+typedef struct
+{
+    int32_t *buf;       /* ring of samples */
+    uint32_t len;       /* ring length in samples */
+    uint32_t delay;     /* distance of the read tap in samples */
+    uint32_t pos;       /* write index */
+    int32_t *window[2]; /* fast copies of the delayed block, NULL for a line in fast memory */
+    uint32_t block;     /* window length in samples */
+    uint8_t cur;        /* window of the current block */
+    uint8_t primed;     /* window of the current block was prefetched */
+    uint32_t seq;       /* last copy of that prefetch, the only one fetch waits for */
+} delay_line_t;
+
+void reverb_arena_init(reverb_arena_t *arena, void *base, size_t size);
+void *reverb_arena_alloc(reverb_arena_t *arena, size_t size);
+void reverb_arena_reset(reverb_arena_t *arena);
+
+void reverb_mem_init(reverb_mem_t *mem, void *fast, size_t fast_size, void *slow, size_t slow_size);
+void reverb_mem_reset(reverb_mem_t *mem);
+void reverb_mem_wait(reverb_mem_t *mem);
+
+uint8_t delay_line_alloc(reverb_mem_t *mem, delay_line_t *line, uint32_t delay, uint32_t block);
+void delay_line_clear(delay_line_t *line);
+uint32_t delay_line_clear_part(delay_line_t *line, uint32_t from, uint32_t max);
+int32_t *delay_line_fetch(reverb_mem_t *mem, delay_line_t *line, uint32_t n);
+void delay_line_commit(reverb_mem_t *mem, delay_line_t *line, uint32_t n);
+void delay_line_read(reverb_mem_t *mem, delay_line_t *line, int32_t *dst, uint32_t delay, uint32_t n);
+
+#endif /*REVERB_MEM_H*/
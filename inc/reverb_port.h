@@ -0,0 +1,142 @@
+/**
+ * @file    reverb_port.h
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   target specific helpers of the reverb library
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#ifndef REVERB_PORT_H
+#define REVERB_PORT_H
+
+#include <stdint.h>
+
+/* ----- Memory placement ----------------------------------------------------------------------- */
+/*
+ * REVERB_ITCM puts a function into the zero wait state ITCM, REVERB_DTCM puts a zero-initialised
+ * object into DTCM. The sections are defined in STM32Reverb/LinkerScript.ld and filled by the
+ * startup code. On the host, or when built with REVERB_NO_TCM (to measure the flash/AXI SRAM
+ * baseline), both expand to nothing.
+ */
+#if defined(STM32F7) && !defined(REVERB_NO_TCM)
+#define REVERB_ITCM __attribute__((section(".itcm_text")))
+#define REVERB_DTCM __attribute__((section(".dtcm_bss")))
+#else
+#define REVERB_ITCM
+#define REVERB_DTCM
+#endif
+
+/* ----- Saturation ----------------------------------------------------------------------------- */
+/*
+ * Saturate to int16: a single SSAT on Cortex-M7, a clamp on the host which the compiler turns into
+ * packs (packssdw) when the loop is vectorised.
+ */
+#if defined(__ARM_FEATURE_SAT)
+#include <arm_acle.h>
+
+static inline int16_t reverb_sat16(int32_t x)
+{
+    return (int16_t)__ssat(x, 16);
+}
+#else
+static inline int16_t reverb_sat16(int32_t x)
+{
+    return (int16_t)((x < INT16_MIN) ? INT16_MIN : ((x > INT16_MAX) ? INT16_MAX : x));
+}
+#endif
+
+/* ----- Subnormal numbers ---------------------------------------------------------------------- */
+/*
+ * A float path calls reverb_fpu_enter() at its start and reverb_fpu_leave() at its end: in between
+ * subnormal operands and results are flushed to zero by the FPU (FTZ and DAZ in MXCSR on x86, FZ in
+ * FPSCR/FPCR on Arm), which avoids the slow microcoded operations of x86 and keeps the cost of a
+ * decaying signal flat. The caller's mode is restored, so an interrupted context or the host
+ * application never sees the change. REVERB_FPU_FLUSH is 0 where the mode cannot be set (or when
+ * built with REVERB_NO_FTZ); reverb_flush_denormal() then zeroes subnormals in software.
+ */
+#if defined(__SSE__) && !defined(REVERB_NO_FTZ)
+#include <xmmintrin.h>
+
+#define REVERB_FPU_FLUSH 1
+typedef uint32_t reverb_fpu_t;
+
+static inline reverb_fpu_t reverb_fpu_enter(void)
+{
+    uint32_t csr = _mm_getcsr();
+
+    _mm_setcsr(csr | 0x8040u); /* FTZ (bit 15) and DAZ (bit 6) */
+    return csr;
+}
+
+static inline void reverb_fpu_leave(reverb_fpu_t csr)
+{
+    _mm_setcsr(csr);
+}
+#elif defined(__arm__) && defined(__ARM_FP) && !defined(REVERB_NO_FTZ)
+#define REVERB_FPU_FLUSH 1
+typedef uint32_t reverb_fpu_t;
+
+static inline reverb_fpu_t reverb_fpu_enter(void)
+{
+    uint32_t fpscr;
+
+    __asm__ volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    __asm__ volatile("vmsr fpscr, %0" : : "r"(fpscr | (1u << 24)) : "memory"); /* FZ */
+    return fpscr;
+}
+
+static inline void reverb_fpu_leave(reverb_fpu_t fpscr)
+{
+    __asm__ volatile("vmsr fpscr, %0" : : "r"(fpscr) : "memory");
+}
+#elif defined(__aarch64__) && !defined(REVERB_NO_FTZ)
+#define REVERB_FPU_FLUSH 1
+typedef uint64_t reverb_fpu_t;
+
+static inline reverb_fpu_t reverb_fpu_enter(void)
+{
+    uint64_t fpcr;
+
+    __asm__ volatile("mrs %0, fpcr" : "=r"(fpcr));
+    __asm__ volatile("msr fpcr, %0" : : "r"(fpcr | (1u << 24)) : "memory"); /* FZ */
+    return fpcr;
+}
+
+static inline void reverb_fpu_leave(reverb_fpu_t fpcr)
+{
+    __asm__ volatile("msr fpcr, %0" : : "r"(fpcr) : "memory");
+}
+#else
+#define REVERB_FPU_FLUSH 0
+typedef uint32_t reverb_fpu_t;
+
+static inline reverb_fpu_t reverb_fpu_enter(void)
+{
+    return 0;
+}
+
+static inline void reverb_fpu_leave(reverb_fpu_t state)
+{
+    (void)state;
+}
+#endif
+
+/*
+ * Zero a subnormal float with an integer test of its exponent, without any float operation on it:
+ * the guard of the float inputs and of the float filter states where REVERB_FPU_FLUSH is 0.
+ */
+static inline float reverb_flush_denormal(float x)
+{
+    union
+    {
+        float f;
+        uint32_t u;
+    } v = {x};
+
+    return (v.u & 0x7f800000u) ? x : 0.0f;
+}
+
+#endif /*REVERB_PORT_H*/
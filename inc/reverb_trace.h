@@ -0,0 +1,126 @@
+/**
+ * @file    reverb_trace.h
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   binary trace ring of the reverb kernel, compiled in with REVERB_TRACE
+ *
+ * Each trace point writes one fixed-size event (stage, index, two values, timestamp) into a ring
+ * which keeps the last REVERB_TRACE_SIZE events: no formatting and no I/O in the kernel, so it
+ * runs at full speed. The ring is saved as it is in memory (reverb_trace_save() on the host, a
+ * debugger memory dump of reverb_trace on the board) and turned into Chrome trace JSON by
+ * tools/trace/reverb_trace_decode. Without REVERB_TRACE the trace points expand to nothing.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#ifndef REVERB_TRACE_H
+#define REVERB_TRACE_H
+
+#include <stdint.h>
+
+#define REVERB_TRACE_MAGIC 0x52545652u /* "RVTR" in a little endian dump */
+#define REVERB_TRACE_VERSION 1
+
+/* Events kept, a power of two */
+#ifndef REVERB_TRACE_SIZE
+#define REVERB_TRACE_SIZE 4096
+#endif
+
+#if (REVERB_TRACE_SIZE & (REVERB_TRACE_SIZE - 1)) != 0
+#error "REVERB_TRACE_SIZE must be a power of two"
+#endif
+
+/* Stages of the kernel, the meaning of index, a and b is given for each one */
+typedef enum
+{
+    REVERB_TRACE_INIT = 0, /* reverb_init(): -, samples in the history, - */
+    REVERB_TRACE_PUT,      /* reverb_put(): new head, input sample, output sample */
+    REVERB_TRACE_POP,      /* reverb_pop(): new tail, x, y */
+    REVERB_TRACE_GET,      /* reverb_get(): samples before the head, x, y */
+    REVERB_TRACE_ALLPASS,  /* allpass stage: delay, x, y */
+    REVERB_TRACE_COMB,     /* comb stage: delay (0 for comb0 which pops the tail), x, y */
+    REVERB_TRACE_OUTPUT,   /* reverb(): -, input sample, output before saturation */
+    REVERB_TRACE_STAGES
+} reverb_trace_stage_t;
+
+/* One event, 16 bytes */
+typedef struct
+{
+    uint32_t time; /* REVERB_TRACE_CLOCK_HZ ticks, wraps */
+    uint8_t stage;
+    uint8_t reserved;
+    uint16_t index;
+    int32_t a;
+    int32_t b;
+} reverb_trace_event_t;
+
+/* The ring and its header, saved as one block */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t event_size;
+    uint32_t size;     /* REVERB_TRACE_SIZE */
+    uint32_t clock_hz; /* rate of the event time */
+    uint32_t head;     /* events written since reverb_trace_reset(), the last size ones are kept */
+    uint32_t reserved[3];
+    reverb_trace_event_t events[REVERB_TRACE_SIZE];
+} reverb_trace_t;
+
+/*
+ * Time stamp of the events: the DWT cycle counter on the board (started by the application, see
+ * AUDIO_DWT_Init()), the monotonic clock in nanoseconds on the host. Both could be replaced by
+ * defining REVERB_TRACE_CLOCK() and REVERB_TRACE_CLOCK_HZ.
+ */
+#ifndef REVERB_TRACE_CLOCK
+#if defined(STM32F7)
+#define REVERB_TRACE_CLOCK() (*(volatile uint32_t *)0xE0001004u) /* DWT->CYCCNT */
+#define REVERB_TRACE_CLOCK_HZ 200000000u
+#else
+#include <time.h>
+
+static inline uint32_t reverb_trace_clock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#define REVERB_TRACE_CLOCK() reverb_trace_clock()
+#define REVERB_TRACE_CLOCK_HZ 1000000000u
+#endif
+#endif
+
+#ifdef REVERB_TRACE
+extern reverb_trace_t reverb_trace;
+
+/**
+ * @brief Record one event: the slot is written with a single store of the whole event, the
+ *        oldest one is overwritten when the ring is full. One writer only (the legacy kernel).
+ *
+ * @param stage reverb_trace_stage_t
+ * @param index stage specific index
+ * @param a first value
+ * @param b second value
+ */
+static inline void reverb_trace_event(uint8_t stage, uint16_t index, int32_t a, int32_t b)
+{
+    uint32_t head = reverb_trace.head;
+    reverb_trace_event_t e = {REVERB_TRACE_CLOCK(), stage, 0, index, a, b};
+
+    reverb_trace.events[head & (REVERB_TRACE_SIZE - 1)] = e;
+    reverb_trace.head = head + 1;
+}
+
+void reverb_trace_reset(void);
+const reverb_trace_t *reverb_trace_get(void);
+uint8_t reverb_trace_save(const char *path);
+
+#define REVERB_TRACE_EVENT(stage, index, a, b) reverb_trace_event((stage), (uint16_t)(index), (a), (b))
+#else
+#define REVERB_TRACE_EVENT(stage, index, a, b) ((void)0)
+#endif
+
+#endif /*REVERB_TRACE_H*/
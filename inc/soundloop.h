@@ -37,6 +37,7 @@
 /* Exported functions ------------------------------------------------------- */
 AUDIO_ErrorTypeDef AUDIO_REC_Process(void);
 AUDIO_ErrorTypeDef AUDIO_REC_Start(void);
+AUDIO_ErrorTypeDef AUDIO_REC_SetFrequency(uint32_t AudioFreq);
 AUDIO_ErrorTypeDef AUDIO_PLAYER_Init(void);
 
 #endif /* __SOUNDLOOP_H */
@@ -54,6 +54,7 @@ void DMA1_Stream2_IRQHandler(void);
 void AUDIO_DFSDMx_DMAx_TOP_LEFT_IRQHandler(void);
 void AUDIO_DFSDMx_DMAx_TOP_RIGHT_IRQHandler(void);
 void AUDIO_OUT_SAIx_DMAx_IRQHandler(void);
+void DMA2_Stream2_IRQHandler(void);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,50 @@
+#ifndef BOARD_SIM_H
+#define BOARD_SIM_H
+
+#include <stdint.h>
+
+#include <wavfile.h>
+
+/* Touches which could be queued on the command line */
+#define SIM_TOUCH_MAX 32
+
+/* Default throughput of the memory DMA (word copies between SDRAM and DTCM), in bytes per us */
+#define SIM_DMA_BYTES_PER_US 100
+
+/* The SAI plays interleaved stereo frames */
+#define SIM_OUT_CHANNELS 2
+
+/* Options of the virtual board */
+typedef struct
+{
+    uint8_t realtime;   /* DMA callbacks at the real cadence, else as soon as the main loop ran once */
+    uint8_t verbose;    /* print the text drawn on the LCD */
+    uint32_t jitter_us; /* maximum random delay of a DMA callback (realtime only) */
+    uint32_t tail_ms;   /* silence recorded after the end of the input file */
+    uint32_t dma_bytes_per_us; /* throughput of the memory DMA, 0 for copies done at once */
+} sim_config_t;
+
+/* Cost of the record DMA callbacks (the application processing) */
+typedef struct
+{
+    uint64_t callbacks;
+    uint64_t busy_ns;   /* time spent in the callbacks */
+    uint64_t max_ns;    /* longest callback */
+    uint64_t period_ns; /* DMA half buffer period */
+    uint32_t overruns;  /* callbacks longer than the period, the DMA would have caught up */
+    uint32_t late;      /* callbacks fired more than one period after their deadline */
+} sim_audio_stats_t;
+
+extern sim_config_t sim_config;
+
+uint8_t sim_audio_start(wav_file_t *in, const char *out_path);
+uint8_t sim_audio_stop(void);
+uint8_t sim_audio_started(void);
+uint8_t sim_audio_done(void);
+void sim_audio_stats(sim_audio_stats_t *stats);
+uint64_t sim_clock_ns(void);
+void sim_main_loop_done(void);
+
+uint8_t sim_touch_add(uint32_t ms, uint16_t x, uint16_t y);
+
+#endif /*BOARD_SIM_H*/
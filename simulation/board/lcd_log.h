@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file    lcd_log.h
+  * @brief   Host stand-in for the LCD log utility, the log goes to the console.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LCD_LOG_H
+#define __LCD_LOG_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "lcd_log_conf.h"
+
+/* Exported macro ------------------------------------------------------------*/
+#define LCD_UsrLog(...)     do { printf(__VA_ARGS__); } while (0)
+
+#define LCD_ErrLog(...)     do { fprintf(stderr, "ERROR: "); \
+                                 fprintf(stderr, __VA_ARGS__); } while (0)
+
+#define LCD_DbgLog(...)     do { printf(__VA_ARGS__); } while (0)
+
+/* Exported functions ------------------------------------------------------- */
+void LCD_LOG_Init(void);
+void LCD_LOG_SetHeader(uint8_t *Title);
+void LCD_LOG_UpdateDisplay(void);
+
+#endif /* __LCD_LOG_H */
@@ -0,0 +1,499 @@
+/**
+ * @file    sim_audio.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   audio BSP of the virtual board: a thread plays the part of the record and playback DMA,
+ *          the input comes from a wav file and the output goes to another one
+ *
+ * Every DMA period (half of the record buffer) the thread:
+ * - writes the playback half the SAI has just sent to the output file,
+ * - fills the record half from the input file,
+ * - calls the half/complete callbacks like the DMA interrupts do.
+ * The callbacks run with the "interrupt lock" held, the BSP functions called from the main loop
+ * take it too, so they never run in the middle of a callback.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "board_sim.h"
+#include "stm32f769i_discovery_audio.h"
+
+typedef struct
+{
+    uint16_t *buf;     /* circular buffer */
+    uint32_t size;     /* in half-words */
+    uint32_t rate;     /* sample rate in Hz */
+    uint32_t channels; /* interleaved channels */
+    uint8_t running;
+    uint8_t half; /* half filled by the next period */
+} sim_in_dma_t;
+
+typedef struct
+{
+    uint8_t *buf;  /* circular buffer */
+    uint32_t size; /* in bytes */
+    uint32_t rate; /* sample rate in Hz */
+    uint8_t running;
+    uint8_t half; /* half sent during the current period */
+} sim_out_dma_t;
+
+sim_config_t sim_config = {1, 0, 0, 2000, SIM_DMA_BYTES_PER_US};
+
+static pthread_mutex_t irq_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t dma_thread;
+static sim_in_dma_t in_dma;
+static sim_out_dma_t out_dma;
+
+static wav_file_t *in_wav;
+static wav_file_t out_wav;
+static const char *out_name;
+static int16_t *in_frames;   /* frames read from the input file */
+static uint32_t in_capacity; /* frames in in_frames */
+static uint64_t tail_left;   /* frames of silence still to record after the input */
+static uint8_t tail_started;
+static uint8_t out_error;
+
+static uint64_t start_ns;
+static uint64_t clock_ns; /* audio clock of the non realtime mode */
+static uint64_t main_loops;
+static uint8_t quit;
+static uint8_t done;
+static uint8_t started;
+static sim_audio_stats_t stats;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return uint64_t nanoseconds
+ */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sleep until a monotonic time
+ *
+ * @param t nanoseconds
+ */
+static void sleep_until(uint64_t t)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(t / 1000000000ull);
+    ts.tv_nsec = (long)(t % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL))
+        ;
+}
+
+/**
+ * @brief Duration of one DMA half buffer, the record DMA paces the loop when it runs
+ *
+ * @return uint64_t nanoseconds, 0 if no DMA runs
+ */
+static uint64_t dma_period_ns(void)
+{
+    uint64_t frames;
+    uint32_t rate;
+
+    if (in_dma.running)
+    {
+        frames = in_dma.size / 2 / in_dma.channels;
+        rate = in_dma.rate;
+    }
+    else if (out_dma.running)
+    {
+        frames = out_dma.size / 2 / sizeof(int16_t) / SIM_OUT_CHANNELS;
+        rate = out_dma.rate;
+    }
+    else
+    {
+        return 0;
+    }
+    return rate ? frames * 1000000000ull / rate : 0;
+}
+
+/**
+ * @brief Fill one record half from the input file, silence once the file is over
+ *
+ * @param half interleaved samples of the half
+ * @param frames frames of the half
+ */
+static void fill_input(uint16_t *half, uint32_t frames)
+{
+    uint32_t n = 0;
+
+    if (in_capacity < frames)
+    {
+        free(in_frames);
+        in_frames = malloc((size_t)frames * in_wav->channels * sizeof(int16_t));
+        in_capacity = in_frames ? frames : 0;
+    }
+    if (in_frames)
+        n = wav_read_i16(in_wav, in_frames, frames);
+
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        for (uint32_t ch = 0; ch < in_dma.channels; ch++)
+        {
+            uint32_t src = (in_wav->channels == 1) ? 0 : ch;
+
+            half[i * in_dma.channels + ch] = (i < n) ? (uint16_t)in_frames[i * in_wav->channels + src] : 0;
+        }
+    }
+
+    if (n < frames)
+    {
+        uint64_t silence = frames - n;
+
+        if (!tail_started)
+        {
+            tail_left = (uint64_t)sim_config.tail_ms * in_dma.rate / 1000 + 1;
+            tail_started = 1;
+        }
+
+        tail_left = (tail_left > silence) ? (tail_left - silence) : 0;
+        if (!tail_left)
+            __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief One DMA period: playback half to the output file, record half from the input file and
+ *        the callbacks of both streams
+ *
+ * @param period DMA period in nanoseconds
+ */
+static void dma_tick(uint64_t period)
+{
+    if (out_dma.running)
+    {
+        uint32_t frames = out_dma.size / 2 / sizeof(int16_t) / SIM_OUT_CHANNELS;
+        int16_t *half = (int16_t *)(out_dma.buf + out_dma.half * (out_dma.size / 2));
+
+        if (!out_wav.f && !out_error)
+        {
+            out_error = wav_open_write(&out_wav, out_name, out_dma.rate, SIM_OUT_CHANNELS);
+            if (out_error)
+            {
+                fprintf(stderr, "cannot create %s\n", out_name);
+                __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+            }
+        }
+        if (out_wav.f && (wav_write_i16(&out_wav, half, frames) != frames) && !out_error)
+        {
+            fprintf(stderr, "cannot write %s\n", out_name);
+            out_error = 1;
+            __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+        }
+
+        if (out_dma.half)
+            BSP_AUDIO_OUT_TransferComplete_CallBack();
+        else
+            BSP_AUDIO_OUT_HalfTransfer_CallBack();
+        out_dma.half ^= 1;
+    }
+
+    if (in_dma.running)
+    {
+        uint32_t frames = in_dma.size / 2 / in_dma.channels;
+        uint64_t t;
+
+        fill_input(in_dma.buf + in_dma.half * (in_dma.size / 2), frames);
+
+        t = now_ns();
+        if (in_dma.half)
+            BSP_AUDIO_IN_TransferComplete_CallBack();
+        else
+            BSP_AUDIO_IN_HalfTransfer_CallBack();
+        t = now_ns() - t;
+        in_dma.half ^= 1;
+
+        stats.callbacks++;
+        stats.busy_ns += t;
+        stats.max_ns = (t > stats.max_ns) ? t : stats.max_ns;
+        stats.period_ns = period;
+        if (t > period)
+            stats.overruns++;
+    }
+
+    __atomic_store_n(&clock_ns, clock_ns + period, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief DMA thread: fires a period at the real cadence or, when not realtime, after each pass of
+ *        the main loop
+ *
+ * @param arg not used
+ * @return void* NULL
+ */
+static void *dma_thread_main(void *arg)
+{
+    uint64_t deadline = now_ns();
+    uint64_t seen = 0;
+    unsigned int seed = 1;
+
+    (void)arg;
+    while (!__atomic_load_n(&quit, __ATOMIC_ACQUIRE) && !__atomic_load_n(&done, __ATOMIC_ACQUIRE))
+    {
+        uint64_t period;
+
+        pthread_mutex_lock(&irq_lock);
+        period = dma_period_ns();
+        pthread_mutex_unlock(&irq_lock);
+
+        if (!period)
+        {
+            /* nothing started yet */
+            sleep_until(now_ns() + 1000000);
+            deadline = now_ns();
+            continue;
+        }
+
+        if (sim_config.realtime)
+        {
+            uint64_t fire;
+
+            deadline += period;
+            fire = deadline;
+            if (sim_config.jitter_us)
+                fire += (uint64_t)(rand_r(&seed) % (sim_config.jitter_us + 1)) * 1000;
+            sleep_until(fire);
+            if (now_ns() > deadline + period)
+                stats.late++;
+        }
+        else
+        {
+            while ((__atomic_load_n(&main_loops, __ATOMIC_ACQUIRE) == seen) &&
+                   !__atomic_load_n(&quit, __ATOMIC_ACQUIRE))
+                sched_yield();
+            seen = __atomic_load_n(&main_loops, __ATOMIC_ACQUIRE);
+        }
+
+        pthread_mutex_lock(&irq_lock);
+        dma_tick(period);
+        pthread_mutex_unlock(&irq_lock);
+    }
+    return NULL;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Start the DMA thread, it waits for BSP_AUDIO_IN_Record() / BSP_AUDIO_OUT_Play()
+ *
+ * @param in input file, mono or with as many channels as recorded
+ * @param out_path output file, created with the playback sample rate on the first period
+ * @return uint8_t 0 if success
+ */
+uint8_t sim_audio_start(wav_file_t *in, const char *out_path)
+{
+    in_wav = in;
+    out_name = out_path;
+    start_ns = now_ns();
+    return pthread_create(&dma_thread, NULL, dma_thread_main, NULL) ? 1 : 0;
+}
+
+/**
+ * @brief Stop the DMA thread and finish the output file
+ *
+ * @return uint8_t 0 if the output file is complete
+ */
+uint8_t sim_audio_stop(void)
+{
+    __atomic_store_n(&quit, 1, __ATOMIC_RELEASE);
+    pthread_join(dma_thread, NULL);
+    free(in_frames);
+    in_frames = NULL;
+    in_capacity = 0;
+    if (wav_close(&out_wav))
+        out_error = 1;
+    return out_error;
+}
+
+/**
+ * @brief Check if the application has started recording
+ *
+ * @return uint8_t 1 once BSP_AUDIO_IN_Record() was called
+ */
+uint8_t sim_audio_started(void)
+{
+    return __atomic_load_n(&started, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Check if the input file and the tail after it were recorded
+ *
+ * @return uint8_t 1 when the run is over
+ */
+uint8_t sim_audio_done(void)
+{
+    return __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Get the callback statistics
+ *
+ * @param s statistics
+ */
+void sim_audio_stats(sim_audio_stats_t *s)
+{
+    pthread_mutex_lock(&irq_lock);
+    *s = stats;
+    pthread_mutex_unlock(&irq_lock);
+}
+
+/**
+ * @brief Time of the board: wall clock when realtime, else the time of the recorded audio
+ *
+ * @return uint64_t nanoseconds since the start
+ */
+uint64_t sim_clock_ns(void)
+{
+    if (sim_config.realtime)
+        return now_ns() - start_ns;
+    return __atomic_load_n(&clock_ns, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Called after each pass of the main loop, lets the DMA thread run
+ */
+void sim_main_loop_done(void)
+{
+    __atomic_add_fetch(&main_loops, 1, __ATOMIC_RELEASE);
+    if (sim_config.realtime)
+        sleep_until(now_ns() + 1000000);
+    else
+        sched_yield();
+}
+
+/* ----- BSP function ---------------------------------------------------------------------------- */
+uint8_t BSP_AUDIO_OUT_Init(uint16_t OutputDevice, uint8_t Volume, uint32_t AudioFreq)
+{
+    (void)OutputDevice;
+    (void)Volume;
+    BSP_AUDIO_OUT_SetFrequency(AudioFreq);
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_OUT_Play(uint16_t *pBuffer, uint32_t Size)
+{
+    pthread_mutex_lock(&irq_lock);
+    out_dma.buf = (uint8_t *)pBuffer;
+    out_dma.size = Size;
+    out_dma.half = 0;
+    out_dma.running = 1;
+    pthread_mutex_unlock(&irq_lock);
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_OUT_Stop(uint32_t Option)
+{
+    (void)Option;
+    pthread_mutex_lock(&irq_lock);
+    out_dma.running = 0;
+    pthread_mutex_unlock(&irq_lock);
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_OUT_SetVolume(uint8_t Volume)
+{
+    (void)Volume;
+    return AUDIO_OK;
+}
+
+void BSP_AUDIO_OUT_SetFrequency(uint32_t AudioFreq)
+{
+    pthread_mutex_lock(&irq_lock);
+    if (out_wav.f && (out_wav.rate != AudioFreq))
+        fprintf(stderr, "playback switched to %u Hz, %s stays at %u Hz\n", (unsigned)AudioFreq, out_name,
+                (unsigned)out_wav.rate);
+    out_dma.rate = AudioFreq;
+    pthread_mutex_unlock(&irq_lock);
+}
+
+void BSP_AUDIO_OUT_SetAudioFrameSlot(uint32_t AudioFrameSlot)
+{
+    (void)AudioFrameSlot;
+}
+
+uint8_t BSP_AUDIO_IN_Init(uint32_t AudioFreq, uint32_t BitRes, uint32_t ChnlNbr)
+{
+    if ((BitRes != 16) || !ChnlNbr || (ChnlNbr < in_wav->channels))
+        return AUDIO_ERROR;
+
+    pthread_mutex_lock(&irq_lock);
+    if (AudioFreq != in_wav->rate)
+        fprintf(stderr, "recording at %u Hz from a %u Hz file (not resampled)\n", (unsigned)AudioFreq,
+                (unsigned)in_wav->rate);
+    in_dma.rate = AudioFreq;
+    in_dma.channels = ChnlNbr;
+    pthread_mutex_unlock(&irq_lock);
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_IN_AllocScratch(int32_t *pScratch, uint32_t size)
+{
+    (void)pScratch;
+    (void)size;
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_IN_Record(uint16_t *pData, uint32_t Size)
+{
+    if (!in_dma.channels || (Size % (2 * in_dma.channels)))
+        return AUDIO_ERROR;
+
+    pthread_mutex_lock(&irq_lock);
+    in_dma.buf = pData;
+    in_dma.size = Size;
+    in_dma.half = 0;
+    in_dma.running = 1;
+    pthread_mutex_unlock(&irq_lock);
+    __atomic_store_n(&started, 1, __ATOMIC_RELEASE);
+    return AUDIO_OK;
+}
+
+uint8_t BSP_AUDIO_IN_Stop(void)
+{
+    pthread_mutex_lock(&irq_lock);
+    in_dma.running = 0;
+    pthread_mutex_unlock(&irq_lock);
+    return AUDIO_OK;
+}
+
+/* Default callbacks, like the BSP weak ones */
+__attribute__((weak)) void BSP_AUDIO_OUT_TransferComplete_CallBack(void)
+{
+}
+
+__attribute__((weak)) void BSP_AUDIO_OUT_HalfTransfer_CallBack(void)
+{
+}
+
+__attribute__((weak)) void BSP_AUDIO_OUT_Error_CallBack(void)
+{
+}
+
+__attribute__((weak)) void BSP_AUDIO_IN_TransferComplete_CallBack(void)
+{
+}
+
+__attribute__((weak)) void BSP_AUDIO_IN_HalfTransfer_CallBack(void)
+{
+}
+
+__attribute__((weak)) void BSP_AUDIO_IN_Error_CallBack(void)
+{
+}
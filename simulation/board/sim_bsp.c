@@ -0,0 +1,267 @@
+/**
+ * @file    sim_bsp.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   LCD, touch screen, SDRAM, HAL tick and memory DMA of the virtual board
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "board_sim.h"
+#include "mem_dma.h"
+
+typedef struct
+{
+    uint32_t ms; /* board time of the touch */
+    uint16_t x;
+    uint16_t y;
+} sim_touch_t;
+
+uint8_t sim_sdram[SDRAM_DEVICE_SIZE] __attribute__((aligned(32)));
+
+sFONT Font12 = {NULL, 7, 12};
+sFONT Font16 = {NULL, 11, 16};
+
+DMA_HandleTypeDef hdma_mem;
+
+/* Core clock of the board (SystemClock_Config()) */
+uint32_t SystemCoreClock = 200000000;
+CoreDebug_Type sim_core_debug;
+
+static DWT_Type sim_dwt_regs;
+
+static sFONT *lcd_font = &Font12;
+
+static sim_touch_t touches[SIM_TOUCH_MAX];
+static uint32_t touch_count;
+static uint32_t touch_next;
+static uint8_t touch_pressed;
+
+/* Memory DMA: end time (host ns) of the last MEM_DMA_QUEUE_SIZE copies, by sequence number */
+static uint64_t copy_end[MEM_DMA_QUEUE_SIZE];
+static uint32_t copy_tail;  /* number of copies queued */
+static uint32_t copy_stall; /* cycles spent in MEM_DMA_Wait() */
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Host monotonic clock
+ *
+ * @return uint64_t nanoseconds
+ */
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Check whether a copy of the memory DMA is over
+ *
+ * @param seq sequence number
+ * @return uint8_t 1 if done
+ */
+static uint8_t copy_done(uint32_t seq)
+{
+    /* an entry overwritten by a later copy ends later, so this errs on the late side */
+    if (!seq || ((int32_t)(seq - copy_tail) > 0))
+        return 1;
+    return host_ns() >= copy_end[(seq - 1) % MEM_DMA_QUEUE_SIZE];
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Queue a touch, it is reported pressed by one BSP_TS_GetState() call and released by the
+ *        next one
+ *
+ * @param ms board time (milliseconds after the start) from which the touch is reported
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @return uint8_t 0 if success, 1 if the queue is full
+ */
+uint8_t sim_touch_add(uint32_t ms, uint16_t x, uint16_t y)
+{
+    uint32_t i;
+
+    if (touch_count == SIM_TOUCH_MAX)
+        return 1; // FULL
+
+    /* keep the queue sorted, touches with the same time stay in order */
+    for (i = touch_count; (i > 0) && (touches[i - 1].ms > ms); i--)
+        touches[i] = touches[i - 1];
+    touches[i].ms = ms;
+    touches[i].x = x;
+    touches[i].y = y;
+    touch_count++;
+    return 0;
+}
+
+/* ----- BSP function ---------------------------------------------------------------------------- */
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(sim_clock_ns() / 1000000);
+}
+
+DWT_Type *sim_dwt(void)
+{
+    /* host time in core cycles, not the board time which stands still in the fast mode */
+    sim_dwt_regs.CYCCNT = (uint32_t)(host_ns() * (SystemCoreClock / 1000000) / 1000);
+    return &sim_dwt_regs;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+
+    while ((HAL_GetTick() - start) < Delay)
+        sim_main_loop_done();
+}
+
+uint8_t BSP_TS_Init(uint16_t ts_SizeX, uint16_t ts_SizeY)
+{
+    (void)ts_SizeX;
+    (void)ts_SizeY;
+    return TS_OK;
+}
+
+uint8_t BSP_TS_GetState(TS_StateTypeDef *TS_State)
+{
+    memset(TS_State, 0, sizeof(*TS_State));
+    if (touch_pressed)
+    {
+        touch_pressed = 0;
+    }
+    else if ((touch_next < touch_count) && (HAL_GetTick() >= touches[touch_next].ms))
+    {
+        TS_State->touchDetected = 1;
+        TS_State->touchX[0] = touches[touch_next].x;
+        TS_State->touchY[0] = touches[touch_next].y;
+        if (sim_config.verbose)
+            printf("[%8u ms] touch %u,%u\n", (unsigned)HAL_GetTick(), touches[touch_next].x,
+                   touches[touch_next].y);
+        touch_pressed = 1;
+        touch_next++;
+    }
+    return TS_OK;
+}
+
+void BSP_LCD_SetTextColor(uint32_t Color)
+{
+    (void)Color;
+}
+
+void BSP_LCD_SetFont(sFONT *fonts)
+{
+    lcd_font = fonts;
+}
+
+sFONT *BSP_LCD_GetFont(void)
+{
+    return lcd_font;
+}
+
+void BSP_LCD_ClearStringLine(uint32_t Line)
+{
+    (void)Line;
+}
+
+void BSP_LCD_DisplayStringAtLine(uint16_t Line, uint8_t *ptr)
+{
+    BSP_LCD_DisplayStringAt(0, LINE(Line), ptr, LEFT_MODE);
+}
+
+void BSP_LCD_DisplayStringAt(uint16_t Xpos, uint16_t Ypos, uint8_t *Text, Text_AlignModeTypdef Mode)
+{
+    (void)Mode;
+    if (sim_config.verbose)
+        printf("[%8u ms] lcd %3u,%3u: %s\n", (unsigned)HAL_GetTick(), Xpos, Ypos, (char *)Text);
+}
+
+void BSP_LCD_FillRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height)
+{
+    (void)Xpos;
+    (void)Ypos;
+    (void)Width;
+    (void)Height;
+}
+
+void BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
+{
+    (void)Xpos;
+    (void)Ypos;
+    (void)Radius;
+}
+
+void BSP_LCD_FillPolygon(pPoint Points, uint16_t PointCount)
+{
+    (void)Points;
+    (void)PointCount;
+}
+
+void LCD_LOG_Init(void)
+{
+}
+
+void LCD_LOG_SetHeader(uint8_t *Title)
+{
+    (void)Title;
+}
+
+void LCD_LOG_UpdateDisplay(void)
+{
+}
+
+/* The memory DMA moves the data at once but a copy only completes once the stream would have
+   transferred it, at sim_config.dma_bytes_per_us after the copies queued before it: MEM_DMA_Wait()
+   spins until then, so the waits left by the prefetches show in the benchmark */
+void MEM_DMA_Init(void)
+{
+    copy_tail = 0;
+    copy_stall = 0;
+}
+
+uint32_t MEM_DMA_Copy(void *ctx, void *dst, const void *src, size_t size)
+{
+    uint64_t start = host_ns();
+    uint64_t last = copy_tail ? copy_end[(copy_tail - 1) % MEM_DMA_QUEUE_SIZE] : 0;
+
+    (void)ctx;
+    memcpy(dst, src, size);
+    if (!sim_config.dma_bytes_per_us)
+        return 0;
+    /* queue full, wait for its oldest copy */
+    while (!copy_done(copy_tail + 1 - MEM_DMA_QUEUE_SIZE))
+    {
+    }
+    start = (last > start) ? last : start;
+    copy_end[copy_tail % MEM_DMA_QUEUE_SIZE] = start + size * 1000 / sim_config.dma_bytes_per_us;
+    return ++copy_tail;
+}
+
+void MEM_DMA_Wait(void *ctx, uint32_t seq)
+{
+    uint32_t start;
+
+    (void)ctx;
+    if (copy_done(seq))
+        return;
+    start = DWT->CYCCNT;
+    while (!copy_done(seq))
+    {
+    }
+    copy_stall += DWT->CYCCNT - start;
+}
+
+uint32_t MEM_DMA_TakeStallCycles(void)
+{
+    uint32_t cycles = copy_stall;
+
+    copy_stall = 0;
+    return cycles;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file    sim_main.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   virtual board: runs the firmware menu and loopback (menu.c, soundloop.c) on the host,
+ *          with the microphones replaced by a wav file and the line out by another one
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "board_sim.h"
+#include "soundloop.h"
+
+/* Record button of the menu and of the loopback screen */
+#define SIM_RECORD_X 320
+#define SIM_RECORD_Y 232
+
+/* Main loop passes without BSP_AUDIO_IN_Record() before giving up */
+#define SIM_START_LOOPS 1000
+
+AUDIO_ApplicationTypeDef appli_state = APPLICATION_READY;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-f] [-d bytes] [-j us] [-l ms] [-t ms:x,y]... [-v] input.wav output.wav\n"
+            "  -f        do not wait for the DMA period, run as fast as the host can\n"
+            "  -d bytes  throughput of the memory DMA in bytes per microsecond, 0 for copies done\n"
+            "            at once, default %u\n"
+            "  -j us     delay each DMA callback by a random time up to us microseconds\n"
+            "  -l ms     silence recorded after the input (reverb tail), default %u ms\n"
+            "  -t ms:x,y touch the screen at x,y ms milliseconds after the start\n"
+            "            (the record button is touched twice at 0 ms to start the loopback)\n"
+            "  -v        print the LCD text and the touches\n",
+            name, (unsigned)sim_config.dma_bytes_per_us, (unsigned)sim_config.tail_ms);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    wav_file_t in;
+    sim_audio_stats_t stats;
+    uint32_t loops = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fd:j:l:t:v")) != -1)
+    {
+        unsigned int ms, x, y;
+
+        switch (opt)
+        {
+        case 'f':
+            sim_config.realtime = 0;
+            break;
+        case 'd':
+            sim_config.dma_bytes_per_us = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            sim_config.jitter_us = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            sim_config.tail_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            if ((sscanf(optarg, "%u:%u,%u", &ms, &x, &y) != 3) || sim_touch_add(ms, (uint16_t)x, (uint16_t)y))
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'v':
+            sim_config.verbose = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (wav_open_read(&in, argv[optind]))
+    {
+        fprintf(stderr, "%s: not a 16-bit PCM wav file\n", argv[optind]);
+        return 1;
+    }
+    if (in.channels > DEFAULT_AUDIO_IN_CHANNEL_NBR)
+    {
+        fprintf(stderr, "%s: %u channels, the board records %u\n", argv[optind], in.channels,
+                DEFAULT_AUDIO_IN_CHANNEL_NBR);
+        wav_close(&in);
+        return 1;
+    }
+
+    /* menu: record, then loopback screen: record */
+    sim_touch_add(0, SIM_RECORD_X, SIM_RECORD_Y);
+    sim_touch_add(0, SIM_RECORD_X, SIM_RECORD_Y);
+
+    if (sim_audio_start(&in, argv[optind + 1]))
+    {
+        wav_close(&in);
+        return 1;
+    }
+
+    while (!sim_audio_done())
+    {
+        AUDIO_MenuProcess();
+        sim_main_loop_done();
+        if (!sim_audio_started() && (++loops > SIM_START_LOOPS))
+        {
+            fprintf(stderr, "the application did not start recording\n");
+            break;
+        }
+    }
+
+    if (sim_audio_stop() || !sim_audio_started())
+    {
+        wav_close(&in);
+        return 1;
+    }
+    wav_close(&in);
+
+    sim_audio_stats(&stats);
+    printf("callbacks %llu, period %.1f us, avg %.1f us, max %.1f us, load %.1f %%, overruns %u, late %u\n",
+           (unsigned long long)stats.callbacks, stats.period_ns / 1e3,
+           stats.callbacks ? stats.busy_ns / 1e3 / stats.callbacks : 0.0, stats.max_ns / 1e3,
+           (stats.callbacks && stats.period_ns) ? 100.0 * stats.busy_ns / stats.callbacks / stats.period_ns : 0.0,
+           stats.overruns, stats.late);
+    return 0;
+}
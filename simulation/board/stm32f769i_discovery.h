@@ -0,0 +1,15 @@
+/**
+  ******************************************************************************
+  * @file    stm32f769i_discovery.h
+  * @brief   Host stand-in for the STM32F769I-DISCO board header.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F769I_DISCOVERY_H
+#define __STM32F769I_DISCOVERY_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f7xx_hal.h"
+
+#endif /* __STM32F769I_DISCOVERY_H */
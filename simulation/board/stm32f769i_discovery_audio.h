@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    stm32f769i_discovery_audio.h
+  * @brief   Host stand-in for the audio BSP: the record and playback DMA are
+  *          emulated by the virtual board clock (see sim_audio.c).
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F769I_DISCOVERY_AUDIO_H
+#define __STM32F769I_DISCOVERY_AUDIO_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f769i_discovery.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define AUDIO_OK                            ((uint8_t)0)
+#define AUDIO_ERROR                         ((uint8_t)1)
+
+#define OUTPUT_DEVICE_SPEAKER               ((uint16_t)0x0001)
+#define OUTPUT_DEVICE_HEADPHONE             ((uint16_t)0x0002)
+#define OUTPUT_DEVICE_BOTH                  ((uint16_t)0x0003)
+
+#define CODEC_PDWN_SW                       ((uint32_t)0x00000001)
+#define CODEC_PDWN_HW                       ((uint32_t)0x00000002)
+
+#define CODEC_AUDIOFRAME_SLOT_0123          ((uint32_t)0x0000000F)
+#define CODEC_AUDIOFRAME_SLOT_02            ((uint32_t)0x00000005)
+#define CODEC_AUDIOFRAME_SLOT_13            ((uint32_t)0x0000000A)
+
+#define BSP_AUDIO_FREQUENCY_96K             ((uint32_t)96000U)
+#define BSP_AUDIO_FREQUENCY_48K             ((uint32_t)48000U)
+#define BSP_AUDIO_FREQUENCY_44K             ((uint32_t)44100U)
+#define BSP_AUDIO_FREQUENCY_32K             ((uint32_t)32000U)
+#define BSP_AUDIO_FREQUENCY_22K             ((uint32_t)22050U)
+#define BSP_AUDIO_FREQUENCY_16K             ((uint32_t)16000U)
+#define BSP_AUDIO_FREQUENCY_11K             ((uint32_t)11025U)
+#define BSP_AUDIO_FREQUENCY_8K              ((uint32_t)8000U)
+
+#define DEFAULT_AUDIO_IN_FREQ               BSP_AUDIO_FREQUENCY_16K
+#define DEFAULT_AUDIO_IN_BIT_RESOLUTION     ((uint8_t)16)
+#define DEFAULT_AUDIO_IN_CHANNEL_NBR        ((uint8_t)2)
+
+#define AUDIO_OUT_IRQ_PREPRIO               ((uint32_t)0x0E)
+#define AUDIO_IN_IRQ_PREPRIO                ((uint32_t)0x0F)
+
+/* Exported functions ------------------------------------------------------- */
+uint8_t BSP_AUDIO_OUT_Init(uint16_t OutputDevice, uint8_t Volume, uint32_t AudioFreq);
+uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t Size);
+uint8_t BSP_AUDIO_OUT_Stop(uint32_t Option);
+uint8_t BSP_AUDIO_OUT_SetVolume(uint8_t Volume);
+void    BSP_AUDIO_OUT_SetFrequency(uint32_t AudioFreq);
+void    BSP_AUDIO_OUT_SetAudioFrameSlot(uint32_t AudioFrameSlot);
+
+/* User callbacks, the application overrides them */
+void    BSP_AUDIO_OUT_TransferComplete_CallBack(void);
+void    BSP_AUDIO_OUT_HalfTransfer_CallBack(void);
+void    BSP_AUDIO_OUT_Error_CallBack(void);
+
+uint8_t BSP_AUDIO_IN_Init(uint32_t AudioFreq, uint32_t BitRes, uint32_t ChnlNbr);
+uint8_t BSP_AUDIO_IN_AllocScratch(int32_t *pScratch, uint32_t size);
+uint8_t BSP_AUDIO_IN_Record(uint16_t *pData, uint32_t Size);
+uint8_t BSP_AUDIO_IN_Stop(void);
+
+/* User callbacks, the application overrides them */
+void    BSP_AUDIO_IN_TransferComplete_CallBack(void);
+void    BSP_AUDIO_IN_HalfTransfer_CallBack(void);
+void    BSP_AUDIO_IN_Error_CallBack(void);
+
+#endif /* __STM32F769I_DISCOVERY_AUDIO_H */
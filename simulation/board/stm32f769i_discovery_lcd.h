@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    stm32f769i_discovery_lcd.h
+  * @brief   Host stand-in for the LCD BSP, text drawn on the screen is printed
+  *          when the virtual board runs verbose and everything else is dropped.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F769I_DISCOVERY_LCD_H
+#define __STM32F769I_DISCOVERY_LCD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f769i_discovery.h"
+#include "stm32f769i_discovery_sdram.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define LCD_OK              ((uint8_t)0x00)
+
+#define LCD_COLOR_BLUE      ((uint32_t)0xFF0000FF)
+#define LCD_COLOR_GREEN     ((uint32_t)0xFF00FF00)
+#define LCD_COLOR_RED       ((uint32_t)0xFFFF0000)
+#define LCD_COLOR_CYAN      ((uint32_t)0xFF00FFFF)
+#define LCD_COLOR_YELLOW    ((uint32_t)0xFFFFFF00)
+#define LCD_COLOR_WHITE     ((uint32_t)0xFFFFFFFF)
+#define LCD_COLOR_BLACK     ((uint32_t)0xFF000000)
+
+#define LINE(x) ((x) * (((sFONT *)BSP_LCD_GetFont())->Height))
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  const uint8_t *table;
+  uint16_t Width;
+  uint16_t Height;
+} sFONT;
+
+typedef struct
+{
+  int16_t X;
+  int16_t Y;
+} Point, *pPoint;
+
+typedef enum
+{
+  CENTER_MODE = 0x01,
+  RIGHT_MODE  = 0x02,
+  LEFT_MODE   = 0x03
+} Text_AlignModeTypdef;
+
+/* Exported variables --------------------------------------------------------*/
+extern sFONT Font12;
+extern sFONT Font16;
+
+/* Exported functions ------------------------------------------------------- */
+void     BSP_LCD_SetTextColor(uint32_t Color);
+void     BSP_LCD_SetFont(sFONT *fonts);
+sFONT   *BSP_LCD_GetFont(void);
+void     BSP_LCD_ClearStringLine(uint32_t Line);
+void     BSP_LCD_DisplayStringAtLine(uint16_t Line, uint8_t *ptr);
+void     BSP_LCD_DisplayStringAt(uint16_t Xpos, uint16_t Ypos, uint8_t *Text, Text_AlignModeTypdef Mode);
+void     BSP_LCD_FillRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height);
+void     BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius);
+void     BSP_LCD_FillPolygon(pPoint Points, uint16_t PointCount);
+
+#endif /* __STM32F769I_DISCOVERY_LCD_H */
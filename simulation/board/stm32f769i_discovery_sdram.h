@@ -0,0 +1,23 @@
+/**
+  ******************************************************************************
+  * @file    stm32f769i_discovery_sdram.h
+  * @brief   Host stand-in for the SDRAM BSP: the 16MB external memory is a
+  *          static array of the virtual board.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F769I_DISCOVERY_SDRAM_H
+#define __STM32F769I_DISCOVERY_SDRAM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f7xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SDRAM_DEVICE_ADDR   ((uintptr_t)sim_sdram)
+#define SDRAM_DEVICE_SIZE   ((uint32_t)0x1000000)
+
+/* Exported variables --------------------------------------------------------*/
+extern uint8_t sim_sdram[];
+
+#endif /* __STM32F769I_DISCOVERY_SDRAM_H */
@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file    stm32f769i_discovery_ts.h
+  * @brief   Host stand-in for the touch screen BSP, the touches come from the
+  *          script given on the virtual board command line.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F769I_DISCOVERY_TS_H
+#define __STM32F769I_DISCOVERY_TS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f769i_discovery.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define TS_MAX_NB_TOUCH     2
+
+#define TS_OK               ((uint8_t)0x00)
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint8_t  touchDetected;
+  uint16_t touchX[TS_MAX_NB_TOUCH];
+  uint16_t touchY[TS_MAX_NB_TOUCH];
+  uint8_t  touchWeight[TS_MAX_NB_TOUCH];
+  uint8_t  touchEventId[TS_MAX_NB_TOUCH];
+  uint8_t  touchArea[TS_MAX_NB_TOUCH];
+  uint32_t gestureId;
+} TS_StateTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+uint8_t BSP_TS_Init(uint16_t ts_SizeX, uint16_t ts_SizeY);
+uint8_t BSP_TS_GetState(TS_StateTypeDef *TS_State);
+
+#endif /* __STM32F769I_DISCOVERY_TS_H */
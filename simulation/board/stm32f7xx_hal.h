@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    stm32f7xx_hal.h
+  * @brief   Host stand-in for the STM32F7 HAL used by the virtual board: only
+  *          the types, macros and functions the application files rely on.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F7xx_HAL_H
+#define __STM32F7xx_HAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define __IO                volatile
+
+#define ALIGN_32BYTES(buf)  buf __attribute__ ((aligned (32)))
+
+/* Exported types ------------------------------------------------------------*/
+/* Only referenced through pointers by the application */
+typedef struct
+{
+  void *Instance;
+} DMA_HandleTypeDef;
+
+/* DWT cycle counter, CYCCNT follows the host clock scaled to SystemCoreClock */
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+  __IO uint32_t LAR;
+} DWT_Type;
+
+typedef struct
+{
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk       (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk   (1UL << 24)
+
+#define DWT                 (sim_dwt())
+#define CoreDebug           (&sim_core_debug)
+
+/* Exported variables --------------------------------------------------------*/
+extern uint32_t SystemCoreClock;
+extern CoreDebug_Type sim_core_debug;
+
+/* Exported functions ------------------------------------------------------- */
+DWT_Type *sim_dwt(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* The host caches are coherent, cache maintenance has nothing to do */
+static inline void SCB_CleanDCache_by_Addr(uint32_t *addr, int32_t dsize)
+{
+  (void)addr;
+  (void)dsize;
+}
+
+static inline void SCB_InvalidateDCache_by_Addr(uint32_t *addr, int32_t dsize)
+{
+  (void)addr;
+  (void)dsize;
+}
+
+#endif /* __STM32F7xx_HAL_H */
@@ -1,7 +1,8 @@
 """!
 @brief      Defines the reverb test class for sound effects.
             Implemented reverb test class for testing reverb.c
-            implementation using ctypes.
+            implementation using ctypes, and a binding of the block
+            engine (jcrev) which processes whole NumPy arrays.
 
 @file       reverb.py
 @author     Marcin Sosnowski (marcin.sosnow@gmail.com)
@@ -10,11 +11,177 @@
 @copyright  copyright GNU Public License.
 """
 
-import struct
+import os
 import numpy
 
 from ctypes import *
 
+# Library built by cmake in <repo>/build, REVERB_LIB gives another one
+LIB_PATH = os.environ.get('REVERB_LIB', os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                     '..', '..', 'build', 'libreverb.so'))
+
+JCREV_COMBS = 4
+JCREV_ALLPASSES = 3
+
+# Samples given to C in one call, below the uint32_t count of the C functions
+CALL_MAX = 1 << 30
+
+class JcrevParams(Structure):
+    """ jcrev_params_t: gains and delays in samples.
+    """
+    _fields_ = [('g_comb', c_float * JCREV_COMBS), ('m_comb', c_uint32 * JCREV_COMBS),
+                ('g_ap', c_float * JCREV_ALLPASSES), ('m_ap', c_uint32 * JCREV_ALLPASSES)]
+
+class JcrevConfig(Structure):
+    """ jcrev_config_t: gains and delays in milliseconds.
+    """
+    _fields_ = [('g_comb', c_float * JCREV_COMBS), ('ms_comb', c_float * JCREV_COMBS),
+                ('g_ap', c_float * JCREV_ALLPASSES), ('ms_ap', c_float * JCREV_ALLPASSES)]
+
+_lib = None
+
+def library():
+    """ Load libreverb once and declare the block API.
+    """
+    global _lib
+    if _lib is None:
+        lib = CDLL(LIB_PATH)
+        lib.jcrev_create.argtypes = [POINTER(JcrevConfig), c_uint32, c_uint32]
+        lib.jcrev_create.restype = c_void_p
+        lib.jcrev_create_params.argtypes = [POINTER(JcrevParams), c_uint32]
+        lib.jcrev_create_params.restype = c_void_p
+        lib.jcrev_destroy.argtypes = [c_void_p]
+        lib.jcrev_destroy.restype = None
+        lib.jcrev_process.argtypes = [c_void_p, c_void_p, c_void_p, c_uint32]
+        lib.jcrev_process.restype = None
+        lib.jcrev_process_f32.argtypes = [c_void_p, c_void_p, c_void_p, c_uint32]
+        lib.jcrev_process_f32.restype = None
+        lib.jcrev_set_output.argtypes = [c_void_p, c_float, c_float, c_float]
+        lib.jcrev_set_output.restype = None
+        lib.jcrev_set_rate.argtypes = [c_void_p, c_uint32]
+        lib.jcrev_set_rate.restype = c_uint8
+        lib.jcrev_set_gate.argtypes = [c_void_p, c_uint32, c_uint32]
+        lib.jcrev_set_gate.restype = None
+        lib.jcrev_reset.argtypes = [c_void_p]
+        lib.jcrev_reset.restype = None
+        _lib = lib
+    return _lib
+
+class JCRev():
+    """ Block reverb (jcrev.c) with one instance per channel.
+
+    process() takes a contiguous int16 or float32 array, (frames,) or
+    (frames, channels), and hands each channel to C in one call. ctypes
+    releases the GIL during the call, so several threads render at the
+    same time, each with its own JCRev object (an object must not be
+    used by two threads at once). The state is kept between calls, a
+    long signal could be processed in pieces.
+    """
+    def __init__(self, channels=1, rate=None, config=None, params=None, block=4096):
+        """ Create the instances: from a rate (and a config in ms, the
+            CCRMA one by default) or from params in samples.
+
+            config: (g_comb[4], ms_comb[4], g_ap[3], ms_ap[3])
+            params: (g_comb[4], m_comb[4], g_ap[3], m_ap[3])
+        """
+        self.lib = library()
+        self.handles = []
+        for ch in range(channels):
+            if params is not None:
+                p = JcrevParams((c_float * JCREV_COMBS)(*params[0]), (c_uint32 * JCREV_COMBS)(*params[1]),
+                                (c_float * JCREV_ALLPASSES)(*params[2]), (c_uint32 * JCREV_ALLPASSES)(*params[3]))
+                h = self.lib.jcrev_create_params(byref(p), block)
+            elif rate is not None:
+                c = None
+                if config is not None:
+                    c = byref(JcrevConfig((c_float * JCREV_COMBS)(*config[0]), (c_float * JCREV_COMBS)(*config[1]),
+                                          (c_float * JCREV_ALLPASSES)(*config[2]),
+                                          (c_float * JCREV_ALLPASSES)(*config[3])))
+                h = self.lib.jcrev_create(c, rate, block)
+            else:
+                self.close()
+                raise ValueError('rate or params is required')
+            if not h:
+                self.close()
+                raise MemoryError('jcrev instance cannot be created')
+            self.handles.append(h)
+
+    def close(self):
+        """ Release the instances.
+        """
+        for h in self.handles:
+            self.lib.jcrev_destroy(h)
+        self.handles = []
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def set_output(self, dry, wet, volume=1.0):
+        """ Output stage: volume * (dry * in + wet * reverb).
+        """
+        for h in self.handles:
+            self.lib.jcrev_set_output(h, dry, wet, volume)
+
+    def set_rate(self, rate):
+        """ Switch the rate of instances created from a config, the tail is cleared.
+        """
+        for h in self.handles:
+            if self.lib.jcrev_set_rate(h, rate) != 0:
+                raise ValueError('rate {} not supported'.format(rate))
+
+    def set_gate(self, level, hold=0):
+        """ Bypass the reverb once the input and the tail stay below level (RMS in int16 LSB)
+            for hold samples (0 for the longest delay), level 0 disables the gate.
+        """
+        for h in self.handles:
+            self.lib.jcrev_set_gate(h, level, hold)
+
+    def reset(self):
+        """ Clear the reverb tail.
+        """
+        for h in self.handles:
+            self.lib.jcrev_reset(h)
+
+    def _process_channel(self, h, src, dst):
+        """ One C call per CALL_MAX samples of a contiguous channel.
+        """
+        fn = self.lib.jcrev_process if src.dtype == numpy.int16 else self.lib.jcrev_process_f32
+        for start in range(0, src.shape[0], CALL_MAX):
+            n = min(CALL_MAX, src.shape[0] - start)
+            fn(h, src.ctypes.data + start * src.itemsize, dst.ctypes.data + start * dst.itemsize, n)
+
+    def process(self, samples):
+        """ Process an int16 or float32 array (full scale 1.0), the output
+            has the same shape and type.
+        """
+        x = numpy.asarray(samples)
+        if x.dtype not in (numpy.int16, numpy.float32):
+            raise TypeError('int16 or float32 samples expected, got {}'.format(x.dtype))
+        channels = 1 if x.ndim == 1 else x.shape[1]
+        if (x.ndim not in (1, 2)) or (channels != len(self.handles)):
+            raise ValueError('{} channel(s) expected, got shape {}'.format(len(self.handles), x.shape))
+
+        if x.ndim == 1:
+            x = numpy.ascontiguousarray(x)
+            out = numpy.empty_like(x)
+            self._process_channel(self.handles[0], x, out)
+            return out
+
+        # interleaved frames: each channel is made contiguous for its instance
+        out = numpy.empty_like(x)
+        for ch, h in enumerate(self.handles):
+            src = numpy.ascontiguousarray(x[:, ch])
+            dst = numpy.empty_like(src)
+            self._process_channel(h, src, dst)
+            out[:, ch] = dst
+        return out
+
 class Reverb():
     """ Class for testing reverb effect implemented in C using ctypes.
     """
@@ -23,34 +190,28 @@ class Reverb():
             One comb module with the same gain and delay have to give the same result.
             For compare pursposes only.
         """
-        str_sample = struct.unpack('{n}h'.format(n = samples_n), samples)
+        int_sample = numpy.frombuffer(samples, dtype='<i2', count=samples_n).astype(numpy.int16)
 
-        int_sample = numpy.empty(samples_n,dtype = numpy.int16)
-        for idx in range(samples_n):
-            int_sample[idx] = int(str_sample[idx])
-
-        out_samples = int_sample
         out_samples = numpy.pad(int_sample, (0,ndel), 'constant')
         tmp_samples = amp*numpy.pad(int_sample, (ndel,0), 'constant')
         tmp_samples = numpy.round(tmp_samples).astype('int16')
         out_samples += (tmp_samples)
 
-        return bytes(out_samples)
+        return out_samples.tobytes()
 
     def test_reverb(self, samples, samples_n, amp, ndel, ap_amp, ap_ndel):
-        """ Using reverb.so library method run the effect.
+        """ Using reverb.so library method run the effect, one ctypes call
+            per sample through the legacy per-sample reverb() (slow, see
+            test_reverb_block() for the block engine).
         """
-        str_sample = struct.unpack('{n}h'.format(n = samples_n), samples)
-        libreverb = CDLL("../build/libreverb.so")
+        int_sample = numpy.frombuffer(samples, dtype='<i2', count=samples_n)
+        libreverb = CDLL(LIB_PATH)
 
         out_samples = numpy.empty(samples_n,dtype = numpy.int16)
 
-        # print(libreverb.reverb_init(5))
         print("Reverb init result: {}".format(libreverb.reverb_init(ndel[0])))
         for idx in range(samples_n):
-        # for idx in range(10):
-            int_sample = int(str_sample[idx])
-            out_samples[idx]=libreverb.reverb(c_int16(int_sample), c_float(amp[0]), c_float(amp[1]), c_int16(ndel[1]),
+            out_samples[idx]=libreverb.reverb(c_int16(int(int_sample[idx])), c_float(amp[0]), c_float(amp[1]), c_int16(ndel[1]),
                                     c_float(amp[2]), c_int16(ndel[2]), c_float(amp[3]), c_int16(ndel[3]),
                                     c_float(ap_amp[0]), c_int16(ap_ndel[0]),
                                     c_float(ap_amp[1]), c_int16(ap_ndel[1]),
@@ -58,4 +219,16 @@ class Reverb():
                                     )
 
         print("Reverb deinit result: {}".format(libreverb.reverb_deinit()))
-        return bytes(out_samples)
+        return out_samples.tobytes()
+
+    def test_reverb_block(self, samples, samples_n, amp, ndel, ap_amp, ap_ndel):
+        """ Run the effect with the block engine of reverb.so: the whole
+            signal in one call, gains and delays (in samples) as given.
+            jcrev computes the JCRev equations, not those of reverb(),
+            so its output differs from test_reverb().
+        """
+        int_sample = numpy.frombuffer(samples, dtype='<i2', count=samples_n).astype(numpy.int16)
+
+        with JCRev(params=(amp, ndel, ap_amp, ap_ndel)) as rv:
+            out_samples = rv.process(int_sample)
+        return out_samples.tobytes()
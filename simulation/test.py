@@ -95,6 +95,22 @@ class Test():
         if play is True:
             playsound(dest_name)
 
+    def reverb_block(self, play=False):
+        """ Same filter parameters through the block engine (jcrev), which
+            computes the JCRev equations: compare with the reverb() output.
+        """
+        dest_name='{}_block.wav'.format(self.date_suffix)
+        dest = wave.open(dest_name, 'w')
+        dest.setparams((self.audio_nchannels, self.audio_sampwidth, self.audio_framerate, self.audio_nframes, 'NONE', 'NONE'))
+
+        dest.writeframes(self.effect.test_reverb_block(self.sample,(self.audio_nchannels * self.audio_nframes),
+                        [0.697, 0.715, 0.733, 0.742], [5801, 5399, 4999,4799],
+                        [0.7, 0.7, 0.7],[1051, 337, 113]))
+
+        dest.close()
+        if play is True:
+            playsound(dest_name)
+
 if __name__ == "__main__":
     parser = OptionParser()
     parser.add_option("--source", action="store", dest="source", help="source")
@@ -111,6 +127,7 @@ if __name__ == "__main__":
     # effect.play_source()
     effect.delay(play=False)
     effect.reverb(play=True)
+    effect.reverb_block(play=False)
 
     exit(0)
 
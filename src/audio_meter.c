@@ -0,0 +1,180 @@
+/**
+ * @file    audio_meter.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   load meter of the audio callbacks: cost histogram, xruns and headroom, updated from the
+ *          interrupt and read by the main loop without locking
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <audio_meter.h>
+#include <reverb_port.h>
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Empty stats, min starts above any measure
+ *
+ * @param stats cleared
+ */
+static void audio_meter_clear(audio_meter_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min = UINT32_MAX;
+}
+
+/**
+ * @brief Share of the budget
+ *
+ * @param cycles measure
+ * @param budget cycles of one callback period
+ * @return uint32_t percent with two decimals
+ */
+static uint32_t audio_meter_x100(uint32_t cycles, uint32_t budget)
+{
+    return (uint32_t)(((uint64_t)cycles * 10000u) / budget);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a meter, the interrupt must not run yet
+ *
+ * @param meter meter
+ * @param budget cycles of one callback period (cycle_budget())
+ */
+void audio_meter_init(audio_meter_t *meter, uint32_t budget)
+{
+    meter->seq = 0;
+    meter->reset = 0;
+    audio_meter_set_budget(meter, budget);
+}
+
+/**
+ * @brief Change the budget (sample rate or block size change) and clear the stats, the interrupt
+ *        must be stopped
+ *
+ * @param meter meter
+ * @param budget cycles of one callback period
+ */
+void audio_meter_set_budget(audio_meter_t *meter, uint32_t budget)
+{
+    uint64_t scale;
+
+    meter->budget = budget ? budget : 1;
+    /* 100 buckets per budget, the multiply by the reciprocal saves a division in the interrupt */
+    scale = ((uint64_t)100 << 32) / meter->budget;
+    meter->scale = (scale > UINT32_MAX) ? UINT32_MAX : (uint32_t)scale;
+    audio_meter_clear(&meter->stats);
+}
+
+/**
+ * @brief Add the cost of one callback, called from the audio interrupt only
+ *
+ * @param meter meter
+ * @param cycles cost of the callback
+ */
+REVERB_ITCM void audio_meter_add(audio_meter_t *meter, uint32_t cycles)
+{
+    audio_meter_stats_t *s = &meter->stats;
+    uint32_t seq = meter->seq;
+    uint32_t bucket = (uint32_t)(((uint64_t)cycles * meter->scale) >> 32);
+
+    /* odd sequence: a snapshot taken meanwhile is dropped */
+    __atomic_store_n(&meter->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&meter->reset, __ATOMIC_ACQUIRE))
+    {
+        audio_meter_clear(s);
+        __atomic_store_n(&meter->reset, 0, __ATOMIC_RELAXED);
+    }
+    s->count++;
+    s->sum += cycles;
+    s->min = (cycles < s->min) ? cycles : s->min;
+    s->max = (cycles > s->max) ? cycles : s->max;
+    s->xruns += (cycles > meter->budget);
+    s->hist[(bucket < AUDIO_METER_BUCKETS) ? bucket : (AUDIO_METER_BUCKETS - 1)]++;
+
+    __atomic_store_n(&meter->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy the stats, repeated while the interrupt updates them
+ *
+ * @param meter meter
+ * @param stats consistent copy
+ */
+void audio_meter_snapshot(const audio_meter_t *meter, audio_meter_stats_t *stats)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = __atomic_load_n(&meter->seq, __ATOMIC_ACQUIRE);
+        memcpy(stats, &meter->stats, sizeof(*stats));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || (seq != __atomic_load_n(&meter->seq, __ATOMIC_RELAXED)));
+}
+
+/**
+ * @brief Ask the interrupt to clear the stats before its next measure
+ *
+ * @param meter meter
+ */
+void audio_meter_reset(audio_meter_t *meter)
+{
+    __atomic_store_n(&meter->reset, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Turn a snapshot into cycles and percent of the budget
+ *
+ * @param stats snapshot (audio_meter_snapshot())
+ * @param budget cycles of one callback period
+ * @param report results, all zero without measures
+ */
+void audio_meter_report(const audio_meter_stats_t *stats, uint32_t budget, audio_meter_report_t *report)
+{
+    uint32_t target;
+    uint32_t seen = 0;
+    uint32_t b;
+
+    memset(report, 0, sizeof(*report));
+    if (stats->count == 0)
+        return;
+    budget = budget ? budget : 1;
+
+    report->count = stats->count;
+    report->xruns = stats->xruns;
+    report->min = stats->min;
+    report->avg = (uint32_t)(stats->sum / stats->count);
+    report->max = stats->max;
+
+    /* 99th percentile: upper edge of the bucket holding the ceil(0.99 * count)-th measure */
+    target = stats->count - stats->count / 100;
+    for (b = 0; b < AUDIO_METER_BUCKETS - 1; b++)
+    {
+        seen += stats->hist[b];
+        if (seen >= target)
+            break;
+    }
+    if (b < AUDIO_METER_BUCKETS - 1)
+    {
+        uint64_t edge = ((uint64_t)(b + 1) * budget) / 100;
+
+        report->p99 = (edge < stats->max) ? (uint32_t)edge : stats->max;
+    }
+    else
+    {
+        report->p99 = stats->max;
+    }
+
+    report->load_x100 = audio_meter_x100(report->avg, budget);
+    report->p99_x100 = audio_meter_x100(report->p99, budget);
+    report->peak_x100 = audio_meter_x100(report->max, budget);
+    report->headroom_x100 = 10000 - (int32_t)report->peak_x100;
+}
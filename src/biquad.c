@@ -0,0 +1,413 @@
+/**
+ * @file    biquad.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   biquad cascades across channels, float and Q31, with the RBJ cookbook designs
+ *
+ * Transposed direct form II, one section:
+ *   y  = b0·x + s1
+ *   s1 = b1·x - a1·y + s2
+ *   s2 = b2·x - a2·y
+ * The float cascade loads a frame of interleaved samples into the lanes and takes it through every
+ * section before the next frame: the recursion runs along the frames, the lanes are independent,
+ * so each line of a section is one vector operation over the channels, and the sections of
+ * consecutive frames overlap in the pipeline. The Q31 cascade keeps 64-bit products and rounds
+ * once per line, the shape of the multiply-accumulate of the Cortex-M7, one channel at a time.
+ * Both are specialised on the number of sections so the states live in registers.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <string.h>
+
+#include <biquad.h>
+#include <reverb_port.h>
+
+#define TWO_PI 6.28318530718f
+#define Q31_ROUND ((int64_t)1 << (BIQUAD_Q31_SHIFT - 1))
+
+/* ----- Static function ------------------------------------------------------------------------ */
+static inline int32_t sat32(int64_t x)
+{
+    return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : (int32_t)x);
+}
+
+/**
+ * @brief Coefficient in Q2.29
+ *
+ * @param c value
+ * @param q converted value
+ * @return uint8_t 0 if success, 3 if the value is out of the range
+ */
+static uint8_t to_q29(float c, int32_t *q)
+{
+    float scaled = c * (float)(1 << BIQUAD_Q31_SHIFT);
+
+    if (!(scaled >= -2147483648.0f) || !(scaled < 2147483648.0f))
+        return 3;
+    *q = (int32_t)lrintf(scaled);
+    return 0;
+}
+
+/**
+ * @brief Float cascade over a block, frame after frame. Called with a constant number of
+ *        sections, the loops unroll and the states stay in registers for the whole block.
+ *
+ * @param bq cascade
+ * @param in input frames
+ * @param out output frames, could be the same buffer as in
+ * @param frames number of frames
+ * @param stages number of sections
+ */
+static inline void cascade_f32(biquad_f32_t *bq, const float *in, float *out, uint32_t frames, uint32_t stages)
+{
+    uint32_t channels = bq->channels;
+    float s1[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+    float s2[BIQUAD_STAGES_MAX][BIQUAD_LANES];
+
+    memcpy(s1, bq->s1, sizeof(s1));
+    memcpy(s2, bq->s2, sizeof(s2));
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        float x[BIQUAD_LANES] = {0.0f};
+
+        for (uint32_t l = 0; l < channels; l++)
+            x[l] = in[i * channels + l];
+        for (uint32_t s = 0; s < stages; s++)
+        {
+            for (uint32_t l = 0; l < BIQUAD_LANES; l++)
+            {
+                float y = bq->b0[s][l] * x[l] + s1[s][l];
+
+                s1[s][l] = bq->b1[s][l] * x[l] - bq->a1[s][l] * y + s2[s][l];
+                s2[s][l] = bq->b2[s][l] * x[l] - bq->a2[s][l] * y;
+                x[l] = y;
+            }
+        }
+        for (uint32_t l = 0; l < channels; l++)
+            out[i * channels + l] = x[l];
+    }
+    memcpy(bq->s1, s1, sizeof(s1));
+    memcpy(bq->s2, s2, sizeof(s2));
+}
+
+/**
+ * @brief Q31 cascade over a block, channel after channel. There is no vector form of the 64-bit
+ *        products, so the lanes are walked one by one with the states of a channel in registers
+ *        (one multiply-accumulate per coefficient on the Cortex-M7).
+ *
+ * @param bq cascade
+ * @param in input frames
+ * @param out output frames, could be the same buffer as in
+ * @param frames number of frames
+ * @param stages number of sections
+ */
+static inline void cascade_q31(biquad_q31_t *bq, const int16_t *in, int16_t *out, uint32_t frames, uint32_t stages)
+{
+    uint32_t channels = bq->channels;
+
+    for (uint32_t l = 0; l < channels; l++)
+    {
+        int32_t s1[BIQUAD_STAGES_MAX];
+        int32_t s2[BIQUAD_STAGES_MAX];
+
+        for (uint32_t s = 0; s < stages; s++)
+        {
+            s1[s] = bq->s1[s][l];
+            s2[s] = bq->s2[s][l];
+        }
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            int32_t x = (int32_t)((uint32_t)(int32_t)in[i * channels + l] << 16);
+
+            for (uint32_t s = 0; s < stages; s++)
+            {
+                int64_t bx1 = (int64_t)bq->b1[s][l] * x;
+                int64_t bx2 = (int64_t)bq->b2[s][l] * x;
+                int32_t y = sat32(((int64_t)bq->b0[s][l] * x + ((int64_t)s1[s] << BIQUAD_Q31_SHIFT) + Q31_ROUND) >>
+                                  BIQUAD_Q31_SHIFT);
+
+                s1[s] = sat32((bx1 - (int64_t)bq->a1[s][l] * y + ((int64_t)s2[s] << BIQUAD_Q31_SHIFT) + Q31_ROUND) >>
+                              BIQUAD_Q31_SHIFT);
+                s2[s] = sat32((bx2 - (int64_t)bq->a2[s][l] * y + Q31_ROUND) >> BIQUAD_Q31_SHIFT);
+                x = y;
+            }
+            out[i * channels + l] = reverb_sat16((int32_t)(((int64_t)x + 0x8000) >> 16));
+        }
+        for (uint32_t s = 0; s < stages; s++)
+        {
+            bq->s1[s][l] = s1[s];
+            bq->s2[s][l] = s2[s];
+        }
+    }
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Coefficients of a second order section from the RBJ Audio EQ Cookbook
+ *
+ * @param coef coefficients normalised by a0
+ * @param type filter
+ * @param rate sample rate in Hz
+ * @param f0 cut-off, centre or corner frequency in Hz, below rate / 2
+ * @param q quality factor (0.7071 for a Butterworth low or high pass, the slope of a shelf)
+ * @param gain_db gain of a peak or a shelf, not used by the low and high pass
+ * @return uint8_t 0 success, 3 bad argument
+ */
+uint8_t biquad_design(biquad_coef_t *coef, biquad_type_t type, uint32_t rate, float f0, float q, float gain_db)
+{
+    float w0;
+    float cw;
+    float alpha;
+    float a;
+    float sa;
+    float b[3];
+    float den[3];
+
+    if (!rate || !(f0 > 0.0f) || !(f0 < 0.5f * rate) || !(q > 0.0f))
+        return 3; // BADARG
+
+    w0 = TWO_PI * f0 / rate;
+    cw = cosf(w0);
+    alpha = sinf(w0) / (2.0f * q);
+    a = powf(10.0f, gain_db / 40.0f);
+    sa = 2.0f * sqrtf(a) * alpha;
+
+    switch (type)
+    {
+    case BIQUAD_LOWPASS:
+        b[0] = b[2] = 0.5f * (1.0f - cw);
+        b[1] = 1.0f - cw;
+        den[0] = 1.0f + alpha;
+        den[1] = -2.0f * cw;
+        den[2] = 1.0f - alpha;
+        break;
+    case BIQUAD_HIGHPASS:
+        b[0] = b[2] = 0.5f * (1.0f + cw);
+        b[1] = -(1.0f + cw);
+        den[0] = 1.0f + alpha;
+        den[1] = -2.0f * cw;
+        den[2] = 1.0f - alpha;
+        break;
+    case BIQUAD_PEAK:
+        b[0] = 1.0f + alpha * a;
+        b[1] = -2.0f * cw;
+        b[2] = 1.0f - alpha * a;
+        den[0] = 1.0f + alpha / a;
+        den[1] = -2.0f * cw;
+        den[2] = 1.0f - alpha / a;
+        break;
+    case BIQUAD_LOWSHELF:
+        b[0] = a * ((a + 1.0f) - (a - 1.0f) * cw + sa);
+        b[1] = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cw);
+        b[2] = a * ((a + 1.0f) - (a - 1.0f) * cw - sa);
+        den[0] = (a + 1.0f) + (a - 1.0f) * cw + sa;
+        den[1] = -2.0f * ((a - 1.0f) + (a + 1.0f) * cw);
+        den[2] = (a + 1.0f) + (a - 1.0f) * cw - sa;
+        break;
+    case BIQUAD_HIGHSHELF:
+        b[0] = a * ((a + 1.0f) + (a - 1.0f) * cw + sa);
+        b[1] = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cw);
+        b[2] = a * ((a + 1.0f) + (a - 1.0f) * cw - sa);
+        den[0] = (a + 1.0f) - (a - 1.0f) * cw + sa;
+        den[1] = 2.0f * ((a - 1.0f) - (a + 1.0f) * cw);
+        den[2] = (a + 1.0f) - (a - 1.0f) * cw - sa;
+        break;
+    default:
+        return 3; // BADARG
+    }
+
+    coef->b0 = b[0] / den[0];
+    coef->b1 = b[1] / den[0];
+    coef->b2 = b[2] / den[0];
+    coef->a1 = den[1] / den[0];
+    coef->a2 = den[2] / den[0];
+    return 0;
+}
+
+/**
+ * @brief Set up a float cascade, every section passes the signal through
+ *
+ * @param bq cascade
+ * @param channels interleaved channels, up to BIQUAD_LANES
+ * @param stages sections, up to BIQUAD_STAGES_MAX
+ * @return uint8_t 0 success, 3 bad argument
+ */
+uint8_t biquad_f32_init(biquad_f32_t *bq, uint32_t channels, uint32_t stages)
+{
+    memset(bq, 0, sizeof(*bq));
+    if (!channels || (channels > BIQUAD_LANES) || !stages || (stages > BIQUAD_STAGES_MAX))
+        return 3; // BADARG
+
+    bq->channels = channels;
+    bq->stages = stages;
+    for (uint32_t s = 0; s < stages; s++)
+        for (uint32_t l = 0; l < BIQUAD_LANES; l++)
+            bq->b0[s][l] = 1.0f;
+    return 0;
+}
+
+/**
+ * @brief Set the coefficients of one section, the states are kept
+ *
+ * @param bq cascade
+ * @param stage section
+ * @param ch channel, BIQUAD_ALL for every channel
+ * @param coef coefficients
+ * @return uint8_t 0 success, 3 bad argument
+ */
+uint8_t biquad_f32_set(biquad_f32_t *bq, uint32_t stage, uint32_t ch, const biquad_coef_t *coef)
+{
+    if ((stage >= bq->stages) || ((ch != BIQUAD_ALL) && (ch >= bq->channels)))
+        return 3; // BADARG
+
+    for (uint32_t l = 0; l < bq->channels; l++)
+    {
+        if ((ch != BIQUAD_ALL) && (l != ch))
+            continue;
+        bq->b0[stage][l] = coef->b0;
+        bq->b1[stage][l] = coef->b1;
+        bq->b2[stage][l] = coef->b2;
+        bq->a1[stage][l] = coef->a1;
+        bq->a2[stage][l] = coef->a2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Clear the states
+ *
+ * @param bq cascade
+ */
+void biquad_f32_reset(biquad_f32_t *bq)
+{
+    memset(bq->s1, 0, sizeof(bq->s1));
+    memset(bq->s2, 0, sizeof(bq->s2));
+}
+
+/**
+ * @brief Filter interleaved frames. The FPU flushes subnormals during the call, a decaying
+ *        state would otherwise slow every section down (see reverb_fpu_enter()).
+ *
+ * @param bq cascade
+ * @param in input frames of bq->channels samples
+ * @param out output frames, could be the same buffer as in
+ * @param frames number of frames
+ */
+REVERB_ITCM void biquad_f32_process(biquad_f32_t *bq, const float *in, float *out, uint32_t frames)
+{
+    reverb_fpu_t fpu = reverb_fpu_enter();
+
+    switch (bq->stages)
+    {
+    case 1:
+        cascade_f32(bq, in, out, frames, 1);
+        break;
+    case 2:
+        cascade_f32(bq, in, out, frames, 2);
+        break;
+    case 3:
+        cascade_f32(bq, in, out, frames, 3);
+        break;
+    default:
+        cascade_f32(bq, in, out, frames, BIQUAD_STAGES_MAX);
+        break;
+    }
+    reverb_fpu_leave(fpu);
+}
+
+/**
+ * @brief Set up a Q31 cascade, every section passes the signal through
+ *
+ * @param bq cascade
+ * @param channels interleaved channels, up to BIQUAD_LANES
+ * @param stages sections, up to BIQUAD_STAGES_MAX
+ * @return uint8_t 0 success, 3 bad argument
+ */
+uint8_t biquad_q31_init(biquad_q31_t *bq, uint32_t channels, uint32_t stages)
+{
+    memset(bq, 0, sizeof(*bq));
+    if (!channels || (channels > BIQUAD_LANES) || !stages || (stages > BIQUAD_STAGES_MAX))
+        return 3; // BADARG
+
+    bq->channels = channels;
+    bq->stages = stages;
+    for (uint32_t s = 0; s < stages; s++)
+        for (uint32_t l = 0; l < BIQUAD_LANES; l++)
+            bq->b0[s][l] = 1 << BIQUAD_Q31_SHIFT;
+    return 0;
+}
+
+/**
+ * @brief Set the coefficients of one section, converted to Q2.29, the states are kept
+ *
+ * @param bq cascade
+ * @param stage section
+ * @param ch channel, BIQUAD_ALL for every channel
+ * @param coef coefficients
+ * @return uint8_t 0 success, 3 bad argument or a coefficient out of -4 to 4 (nothing is changed)
+ */
+uint8_t biquad_q31_set(biquad_q31_t *bq, uint32_t stage, uint32_t ch, const biquad_coef_t *coef)
+{
+    int32_t q[5];
+
+    if ((stage >= bq->stages) || ((ch != BIQUAD_ALL) && (ch >= bq->channels)))
+        return 3; // BADARG
+    if (to_q29(coef->b0, &q[0]) || to_q29(coef->b1, &q[1]) || to_q29(coef->b2, &q[2]) || to_q29(coef->a1, &q[3]) ||
+        to_q29(coef->a2, &q[4]))
+        return 3; // BADARG
+
+    for (uint32_t l = 0; l < bq->channels; l++)
+    {
+        if ((ch != BIQUAD_ALL) && (l != ch))
+            continue;
+        bq->b0[stage][l] = q[0];
+        bq->b1[stage][l] = q[1];
+        bq->b2[stage][l] = q[2];
+        bq->a1[stage][l] = q[3];
+        bq->a2[stage][l] = q[4];
+    }
+    return 0;
+}
+
+/**
+ * @brief Clear the states
+ *
+ * @param bq cascade
+ */
+void biquad_q31_reset(biquad_q31_t *bq)
+{
+    memset(bq->s1, 0, sizeof(bq->s1));
+    memset(bq->s2, 0, sizeof(bq->s2));
+}
+
+/**
+ * @brief Filter interleaved int16 frames, computed in Q31 and rounded back to int16 with
+ *        saturation
+ *
+ * @param bq cascade
+ * @param in input frames of bq->channels samples
+ * @param out output frames, could be the same buffer as in
+ * @param frames number of frames
+ */
+REVERB_ITCM void biquad_q31_process(biquad_q31_t *bq, const int16_t *in, int16_t *out, uint32_t frames)
+{
+    switch (bq->stages)
+    {
+    case 1:
+        cascade_q31(bq, in, out, frames, 1);
+        break;
+    case 2:
+        cascade_q31(bq, in, out, frames, 2);
+        break;
+    case 3:
+        cascade_q31(bq, in, out, frames, 3);
+        break;
+    default:
+        cascade_q31(bq, in, out, frames, BIQUAD_STAGES_MAX);
+        break;
+    }
+}
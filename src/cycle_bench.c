@@ -0,0 +1,154 @@
+/**
+ * @file    cycle_bench.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   timing of the DSP kernels with a cycle counter, independent from the target
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <cycle_bench.h>
+
+/* Empty measures used to find the counter overhead */
+#define CYCLE_BENCH_CALIBRATION 16
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a bench on a counter and measure the cost of reading it
+ *
+ * @param cb bench
+ * @param read counter
+ * @param ctx argument of read
+ */
+void cycle_bench_init(cycle_bench_t *cb, cycle_read_t read, void *ctx)
+{
+    uint32_t best = UINT32_MAX;
+
+    cb->read = read;
+    cb->ctx = ctx;
+    cb->overhead = 0;
+    for (int i = 0; i < CYCLE_BENCH_CALIBRATION; i++)
+    {
+        uint32_t t = cycle_bench_elapsed(cb, cycle_bench_start(cb));
+
+        best = (t < best) ? t : best;
+    }
+    cb->overhead = best;
+}
+
+/**
+ * @brief Start a measure
+ *
+ * @param cb bench
+ * @return uint32_t counter value to give to cycle_bench_elapsed()
+ */
+uint32_t cycle_bench_start(const cycle_bench_t *cb)
+{
+    return cb->read(cb->ctx);
+}
+
+/**
+ * @brief Cycles since cycle_bench_start(), the counter may have wrapped once
+ *
+ * @param cb bench
+ * @param start value returned by cycle_bench_start()
+ * @return uint32_t cycles without the counter overhead
+ */
+uint32_t cycle_bench_elapsed(const cycle_bench_t *cb, uint32_t start)
+{
+    uint32_t t = cb->read(cb->ctx) - start;
+
+    return (t > cb->overhead) ? (t - cb->overhead) : 0;
+}
+
+/**
+ * @brief Measure a function several times
+ *
+ * @param cb bench
+ * @param fn measured function
+ * @param arg argument of fn
+ * @param repeats number of calls
+ * @param stats measures are added to it
+ */
+void cycle_bench_run(const cycle_bench_t *cb, void (*fn)(void *arg), void *arg, uint32_t repeats,
+                     cycle_stats_t *stats)
+{
+    for (uint32_t r = 0; r < repeats; r++)
+    {
+        uint32_t start = cycle_bench_start(cb);
+
+        fn(arg);
+        cycle_stats_add(stats, cycle_bench_elapsed(cb, start));
+    }
+}
+
+/**
+ * @brief Forget all the measures
+ *
+ * @param stats measures
+ */
+void cycle_stats_reset(cycle_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min = UINT32_MAX;
+}
+
+/**
+ * @brief Add a measure
+ *
+ * @param stats measures
+ * @param cycles measure
+ */
+void cycle_stats_add(cycle_stats_t *stats, uint32_t cycles)
+{
+    stats->sum += cycles;
+    stats->min = (cycles < stats->min) ? cycles : stats->min;
+    stats->max = (cycles > stats->max) ? cycles : stats->max;
+    stats->count++;
+}
+
+/**
+ * @brief Cycles available to process frames in real time
+ *
+ * @param cycles_per_s counter frequency (SystemCoreClock for the DWT)
+ * @param rate sample rate in Hz
+ * @param frames frames processed
+ * @return uint32_t cycles
+ */
+uint32_t cycle_budget(uint32_t cycles_per_s, uint32_t rate, uint32_t frames)
+{
+    return rate ? (uint32_t)((uint64_t)cycles_per_s * frames / rate) : 0;
+}
+
+/**
+ * @brief Turn the measures into cycles per sample and share of the real-time budget
+ *
+ * @param stats measures of one piece of work
+ * @param samples samples processed by the work
+ * @param budget cycles available for the work (see cycle_budget())
+ * @param report results, all zero without measures
+ */
+void cycle_stats_report(const cycle_stats_t *stats, uint32_t samples, uint32_t budget, cycle_report_t *report)
+{
+    uint64_t avg;
+
+    memset(report, 0, sizeof(*report));
+    if (!stats->count)
+        return;
+
+    avg = stats->sum / stats->count;
+    if (samples)
+    {
+        report->avg_x100 = (uint32_t)(avg * 100 / samples);
+        report->max_x100 = (uint32_t)((uint64_t)stats->max * 100 / samples);
+    }
+    if (budget)
+    {
+        report->load_x100 = (uint32_t)(avg * 10000 / budget);
+        report->peak_x100 = (uint32_t)((uint64_t)stats->max * 10000 / budget);
+    }
+}
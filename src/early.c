@@ -0,0 +1,294 @@
+/**
+ * @file    early.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   early reflections: sparse taps of one shared delay line
+ *
+ * The block is written into the ring first, so a tap shorter than the block reads samples of the
+ * same call. A tap of delay d reads the ring from pos - d. The first block of the ring is mirrored
+ * after its end, so the n samples of a call are always one contiguous segment. The plain taps are
+ * added four at a time, one load and one store of the block sum for four segments; the damped
+ * ones run their one-pole filter along their segment.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <early.h>
+#include <reverb_port.h>
+
+/* Moorer's 18 reflections ("About this reverberation business", 1979), at half of his gains */
+const early_config_t early_config_default = {
+    0.0f,
+    18,
+    {
+        {4.3f, 0.421f, 0.0f},  {21.5f, 0.252f, 0.0f}, {22.5f, 0.246f, 0.0f}, {26.8f, 0.190f, 0.0f},
+        {27.0f, 0.190f, 0.0f}, {29.8f, 0.173f, 0.0f}, {45.8f, 0.145f, 0.0f}, {48.5f, 0.136f, 0.0f},
+        {57.2f, 0.096f, 0.0f}, {58.7f, 0.097f, 0.0f}, {59.5f, 0.109f, 0.0f}, {61.2f, 0.091f, 0.0f},
+        {70.7f, 0.090f, 0.0f}, {70.8f, 0.091f, 0.0f}, {72.6f, 0.088f, 0.0f}, {74.1f, 0.071f, 0.0f},
+        {75.3f, 0.084f, 0.0f}, {79.7f, 0.067f, 0.0f},
+    },
+};
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Check a pattern and convert its delays to samples
+ *
+ * @param config pattern
+ * @param rate sample rate in Hz
+ * @param delay delays in samples, pre-delay included
+ * @return uint32_t longest delay, UINT32_MAX if the pattern is not valid
+ */
+static uint32_t delays(const early_config_t *config, uint32_t rate, uint32_t *delay)
+{
+    uint32_t longest = 0;
+
+    if (!rate || (config->taps > EARLY_TAPS_MAX) || !(config->predelay_ms >= 0.0f))
+        return UINT32_MAX;
+    for (uint32_t t = 0; t < config->taps; t++)
+    {
+        const early_tap_t *tap = &config->tap[t];
+
+        if (!(tap->ms >= 0.0f) || !(tap->damp >= 0.0f) || !(tap->damp < 1.0f))
+            return UINT32_MAX;
+        delay[t] = (uint32_t)((config->predelay_ms + tap->ms) * rate / 1000.0f + 0.5f);
+        if (delay[t] > longest)
+            longest = delay[t];
+    }
+    return longest;
+}
+
+/**
+ * @brief Add a segment of the line times a gain to the block sum
+ *
+ * @param acc block sum
+ * @param x segment of the line
+ * @param n number of samples
+ * @param g gain
+ */
+static inline void tap_add(float *restrict acc, const float *restrict x, uint32_t n, float g)
+{
+    for (uint32_t i = 0; i < n; i++)
+        acc[i] += g * x[i];
+}
+
+/**
+ * @brief Add four segments of the line times their gains to the block sum
+ *
+ * @param acc block sum
+ * @param x segments of the line
+ * @param n number of samples
+ * @param g gains
+ */
+static inline void tap_add4(float *restrict acc, const float *const x[4], uint32_t n, const float *g)
+{
+    const float *restrict x0 = x[0];
+    const float *restrict x1 = x[1];
+    const float *restrict x2 = x[2];
+    const float *restrict x3 = x[3];
+    float g0 = g[0];
+    float g1 = g[1];
+    float g2 = g[2];
+    float g3 = g[3];
+
+    for (uint32_t i = 0; i < n; i++)
+        acc[i] += (g0 * x0[i] + g1 * x1[i]) + (g2 * x2[i] + g3 * x3[i]);
+}
+
+/**
+ * @brief Add a segment of the line through a one-pole low-pass to the block sum
+ *
+ * @param acc block sum
+ * @param x segment of the line
+ * @param n number of samples
+ * @param g gain
+ * @param damp pole of the filter
+ * @param y last output of the filter
+ * @return float last output of the filter
+ */
+static inline float tap_damped(float *restrict acc, const float *restrict x, uint32_t n, float g, float damp, float y)
+{
+    float a = 1.0f - damp;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        y = a * x[i] + damp * y;
+        acc[i] += g * y;
+    }
+    return y;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up an early reflections stage, its line sized for the pattern at the highest rate
+ *
+ * @param er stage
+ * @param config pattern of reflections
+ * @param rate sample rate in Hz
+ * @param max_rate highest rate the stage could be switched to with early_set()
+ * @param block maximum number of samples processed at once
+ * @param arena memory of the line and of the block sum
+ * @return uint8_t 0 success, 1 not enough memory, 3 bad argument
+ */
+uint8_t early_init(early_t *er, const early_config_t *config, uint32_t rate, uint32_t max_rate, uint32_t block,
+                   reverb_arena_t *arena)
+{
+    uint32_t longest;
+
+    memset(er, 0, sizeof(*er));
+    longest = delays(config, max_rate, er->delay);
+    if (!block || (rate > max_rate) || (longest == UINT32_MAX))
+        return 3; // BADARG
+
+    er->len = longest + block;
+    er->block = block;
+    /* the ring and the mirror of its first block */
+    er->buf = (float *)reverb_arena_alloc(arena, (er->len + block) * sizeof(float));
+    er->acc = (float *)reverb_arena_alloc(arena, block * sizeof(float));
+    if (!er->buf || !er->acc)
+        return 1; // FULL
+
+    return early_set(er, config, rate);
+}
+
+/**
+ * @brief Check if a pattern at a rate fits the line, nothing is changed
+ *
+ * @param er stage
+ * @param config pattern of reflections
+ * @param rate sample rate in Hz
+ * @return uint8_t 0 if early_set() would accept them, 3 otherwise
+ */
+uint8_t early_check(const early_t *er, const early_config_t *config, uint32_t rate)
+{
+    uint32_t delay[EARLY_TAPS_MAX];
+    uint32_t longest = delays(config, rate, delay);
+
+    if ((longest == UINT32_MAX) || (longest > er->len - er->block))
+        return 3; // BADARG
+    return 0;
+}
+
+/**
+ * @brief Change the pattern or the rate: the new delays have to fit the line, the reflections on
+ *        their way are cleared
+ *
+ * @param er stage
+ * @param config pattern of reflections, could be er->config
+ * @param rate sample rate in Hz
+ * @return uint8_t 0 success, 3 if the pattern is not valid or longer than the line (nothing is changed)
+ */
+uint8_t early_set(early_t *er, const early_config_t *config, uint32_t rate)
+{
+    uint32_t delay[EARLY_TAPS_MAX];
+    uint32_t longest = delays(config, rate, delay);
+
+    if ((longest == UINT32_MAX) || (longest > er->len - er->block))
+        return 3; // BADARG
+
+    er->taps = config->taps;
+    for (uint32_t t = 0; t < er->taps; t++)
+    {
+        er->delay[t] = delay[t];
+        er->gain[t] = config->tap[t].gain;
+        er->damp[t] = config->tap[t].damp;
+    }
+    if (&er->config != config)
+        er->config = *config;
+    er->rate = rate;
+    early_reset(er);
+    return 0;
+}
+
+/**
+ * @brief Clear the line and the filters
+ *
+ * @param er stage
+ */
+void early_reset(early_t *er)
+{
+    early_reset_part(er, 0, er->len + er->block);
+}
+
+/**
+ * @brief Clear part of the line, to spread early_reset() of a stage which is not used meanwhile
+ *        over several calls. The filters and the position are cleared with the last part.
+ *
+ * @param er stage
+ * @param from first sample of the line to clear
+ * @param max most samples cleared by this call
+ * @return uint32_t first sample left to clear, er->len + er->block once the stage is silent
+ */
+uint32_t early_reset_part(early_t *er, uint32_t from, uint32_t max)
+{
+    uint32_t size = er->len + er->block;
+    uint32_t n = (size - from < max) ? size - from : max;
+
+    memset(er->buf + from, 0, n * sizeof(float));
+    from += n;
+    if (from < size)
+        return from;
+
+    memset(er->state, 0, sizeof(er->state));
+    er->pos = 0;
+    return from;
+}
+
+/**
+ * @brief Sum of the reflections of a block
+ *
+ * @param er stage
+ * @param in input samples
+ * @param out sum of the taps, truncated, could be the same buffer as in
+ * @param n number of samples, not more than er->block
+ */
+REVERB_ITCM void early_process(early_t *er, const int32_t *in, int32_t *out, uint32_t n)
+{
+    float *acc = er->acc;
+    float *buf = er->buf;
+    uint32_t first = (er->len - er->pos < n) ? er->len - er->pos : n;
+    const float *x[4];
+    float g[4];
+    uint32_t grouped = 0;
+
+    for (uint32_t i = 0; i < first; i++)
+        buf[er->pos + i] = (float)in[i];
+    for (uint32_t i = first; i < n; i++)
+        buf[i - first] = (float)in[i];
+    /* keep the mirror of the first block in step */
+    if (er->pos < er->block)
+        memcpy(&buf[er->len + er->pos], &buf[er->pos], ((er->block - er->pos < n) ? er->block - er->pos : n) *
+                                                           sizeof(float));
+    if (first < n)
+        memcpy(&buf[er->len], buf, (n - first) * sizeof(float));
+    memset(acc, 0, n * sizeof(float));
+
+    for (uint32_t t = 0; t < er->taps; t++)
+    {
+        const float *seg = &buf[(er->pos + er->len - er->delay[t]) % er->len];
+
+        if (er->damp[t] != 0.0f)
+        {
+            er->state[t] = tap_damped(acc, seg, n, er->gain[t], er->damp[t], er->state[t]);
+            continue;
+        }
+        x[grouped] = seg;
+        g[grouped] = er->gain[t];
+        if (++grouped == 4)
+        {
+            tap_add4(acc, x, n, g);
+            grouped = 0;
+        }
+    }
+    for (uint32_t t = 0; t < grouped; t++)
+        tap_add(acc, x[t], n, g[t]);
+
+    er->pos += n;
+    if (er->pos >= er->len)
+        er->pos -= er->len;
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = (int32_t)acc[i];
+}
@@ -0,0 +1,129 @@
+/**
+ * @file    halfband.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   polyphase half-band FIR stages, decimation and interpolation by 2
+ *
+ * H(w) = 0.5 + 2·sum(c[j]·cos((2j+1)·w)): the response is symmetric around a quarter of the rate,
+ * H(w) + H(pi - w) = 1, so fitting the passband fixes the stopband. The coefficients are a minimax
+ * fit of the passband 0 to 0.2 of the rate (iteratively reweighted least squares).
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <halfband.h>
+#include <reverb_port.h>
+
+/* Decimator history: the taps but the newest one */
+#define DEC_HISTORY (HALFBAND_TAPS - 1)
+/* Interpolator history, in samples of the low rate */
+#define INT_HISTORY (2 * HALFBAND_PAIRS - 1)
+
+static const float coef[HALFBAND_PAIRS] = {
+    3.161338964e-01f,  -9.972507378e-02f, 5.351131145e-02f,  -3.220460324e-02f, 1.978105365e-02f,
+    -1.188232721e-02f, 6.773391768e-03f,  -3.549725686e-03f, 1.630822163e-03f,  -6.387978484e-04f,
+};
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a stage, used for decimation or for interpolation
+ *
+ * @param hb stage
+ * @param nmax largest number of input samples of a call
+ * @param arena memory of the history
+ * @return uint8_t 0 success, 1 not enough memory, 3 bad argument
+ */
+uint8_t halfband_init(halfband_t *hb, uint32_t nmax, reverb_arena_t *arena)
+{
+    if (!nmax)
+        return 3; // BADARG
+
+    hb->buf = (float *)reverb_arena_alloc(arena, (DEC_HISTORY + 1 + nmax) * sizeof(float));
+    if (!hb->buf)
+        return 1; // FULL
+    hb->nmax = nmax;
+    halfband_reset(hb);
+    return 0;
+}
+
+/**
+ * @brief Clear the history, the stage starts from silence
+ *
+ * @param hb stage
+ */
+void halfband_reset(halfband_t *hb)
+{
+    memset(hb->buf, 0, DEC_HISTORY * sizeof(float));
+    hb->fill = DEC_HISTORY;
+}
+
+/**
+ * @brief Low-pass and keep every other sample. A call which ends on an odd sample keeps it for
+ *        the next one, so the output count follows the input: floor((n + kept) / 2).
+ *
+ * @param hb stage set up for decimation
+ * @param in input samples
+ * @param out output samples, could be the same buffer as in
+ * @param n number of input samples, up to nmax
+ * @return uint32_t number of output samples
+ */
+REVERB_ITCM uint32_t halfband_decimate(halfband_t *hb, const float *in, float *out, uint32_t n)
+{
+    float *restrict x = hb->buf; /* never the output, the input is copied in first */
+    float *restrict y = out;
+    uint32_t total;
+    uint32_t count;
+
+    memcpy(&x[hb->fill], in, n * sizeof(float));
+    total = hb->fill + n;
+    count = (total - DEC_HISTORY) / 2;
+
+    for (uint32_t m = 0; m < count; m++)
+    {
+        /* window x[2m .. 2m + TAPS - 1], centre tap in the middle */
+        const float *c = &x[2 * m + 2 * HALFBAND_PAIRS - 1];
+        float acc = 0.5f * c[0];
+
+        for (int k = 0; k < HALFBAND_PAIRS; k++)
+            acc += coef[k] * (c[-(2 * k + 1)] + c[2 * k + 1]);
+        y[m] = acc;
+    }
+
+    hb->fill = total - 2 * count;
+    memmove(x, &x[2 * count], hb->fill * sizeof(float));
+    return count;
+}
+
+/**
+ * @brief Insert a zero after every sample and low-pass (gain 2): two output samples per input
+ *        sample, the odd one is the input delayed
+ *
+ * @param hb stage set up for interpolation
+ * @param in input samples
+ * @param out 2n output samples, could be the same buffer as in
+ * @param n number of input samples, up to nmax
+ */
+REVERB_ITCM void halfband_interpolate(halfband_t *hb, const float *in, float *out, uint32_t n)
+{
+    /* the decimator history is longer, only its end is used */
+    float *restrict x = &hb->buf[DEC_HISTORY - INT_HISTORY]; /* never the output */
+    float *restrict y = out;
+
+    memcpy(&x[INT_HISTORY], in, n * sizeof(float));
+    for (uint32_t m = 0; m < n; m++)
+    {
+        /* window x[m .. m + 2·PAIRS - 1], the newest sample last */
+        const float *w = &x[m];
+        float acc = 0.0f;
+
+        for (int k = 0; k < HALFBAND_PAIRS; k++)
+            acc += coef[k] * (w[HALFBAND_PAIRS - 1 - k] + w[HALFBAND_PAIRS + k]);
+        y[2 * m] = 2.0f * acc;
+        y[2 * m + 1] = w[HALFBAND_PAIRS];
+    }
+    memmove(x, &x[n], INT_HISTORY * sizeof(float));
+}
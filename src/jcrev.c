@@ -0,0 +1,1012 @@
+/**
+ * @file    jcrev.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   block based JCRev reverb with any number of instances
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <jcrev.h>
+#include <reverb_port.h>
+
+/* Delays of the CCRMA JCRev (4799, 4999, 5399, 5801 and 1051, 337, 113 samples at 25 kHz) */
+const jcrev_config_t jcrev_config_default = {
+    {0.697f, 0.715f, 0.733f, 0.742f},
+    {232.04f, 215.96f, 199.96f, 191.96f},
+    {0.7f, 0.7f, 0.7f},
+    {42.04f, 13.48f, 4.52f},
+};
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Greatest common divisor
+ *
+ * @param a
+ * @param b
+ * @return uint32_t
+ */
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief allpass filter over a block, in place (see doc)
+ *
+ * Implemented with a single delay line:
+ * w[n] = x[n] + g·w[n−M], y[n] = −g·w[n] + w[n−M]
+ * which gives the same output as y[n] = (−g·x[n]) + x[n−M] + (g·y[n−M]).
+ *
+ * @param rv reverb instance
+ * @param line delay line of the filter
+ * @param x samples, replaced with the filter output
+ * @param n number of samples
+ * @param g gain
+ */
+REVERB_ITCM static void all_pass_block(jcrev_t *rv, delay_line_t *line, int32_t *x, uint32_t n, float g)
+{
+    int32_t *d = delay_line_fetch(rv->mem, line, n);
+
+    if (d)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t w = x[i] + (int32_t)(d[i] * g);
+            x[i] = d[i] - (int32_t)(w * g);
+            d[i] = w;
+        }
+    }
+    else
+    {
+        uint32_t r = (line->pos + line->len - line->delay) % line->len;
+        uint32_t p = line->pos;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t dm = line->buf[r];
+            int32_t w = x[i] + (int32_t)(dm * g);
+            x[i] = dm - (int32_t)(w * g);
+            line->buf[p] = w;
+            if (++r == line->len)
+                r = 0;
+            if (++p == line->len)
+                p = 0;
+        }
+    }
+    delay_line_commit(rv->mem, line, n);
+}
+
+/**
+ * @brief feedback comb filter over a block, the output is added to sum (see doc)
+ *
+ * y[n] = x[n] + g·y[n−M]
+ *
+ * @param rv reverb instance
+ * @param line delay line of the filter
+ * @param x input samples
+ * @param sum accumulator of the comb outputs
+ * @param n number of samples
+ * @param g gain
+ */
+REVERB_ITCM static void comb_block(jcrev_t *rv, delay_line_t *line, const int32_t *x, int32_t *sum, uint32_t n, float g)
+{
+    int32_t *d = delay_line_fetch(rv->mem, line, n);
+
+    if (d)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t y = x[i] + (int32_t)(d[i] * g);
+            d[i] = y;
+            sum[i] += y;
+        }
+    }
+    else
+    {
+        uint32_t r = (line->pos + line->len - line->delay) % line->len;
+        uint32_t p = line->pos;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t y = x[i] + (int32_t)(line->buf[r] * g);
+            line->buf[p] = y;
+            sum[i] += y;
+            if (++r == line->len)
+                r = 0;
+            if (++p == line->len)
+                p = 0;
+        }
+    }
+    delay_line_commit(rv->mem, line, n);
+}
+
+/**
+ * @brief Check if a delay could be used by a line: not longer than the ring and, for a line in
+ *        slow memory which reads whole blocks ahead, not shorter than a block
+ *
+ * @param rv reverb instance
+ * @param line delay line
+ * @param delay delay in samples
+ * @return uint8_t 1 if it fits
+ */
+static uint8_t delay_fits(const jcrev_t *rv, const delay_line_t *line, uint32_t delay)
+{
+    return delay && (delay <= line->len) && (!line->window[0] || (delay >= rv->block));
+}
+
+/**
+ * @brief Check if the delays fit the lines of the instance
+ *
+ * @param rv reverb instance
+ * @param params new delays
+ * @return uint8_t 1 if they all fit
+ */
+static uint8_t params_fit(const jcrev_t *rv, const jcrev_params_t *params)
+{
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        if (!delay_fits(rv, &rv->ap[k], params->m_ap[k]))
+            return 0;
+    }
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        if (!delay_fits(rv, &rv->comb[k], params->m_comb[k]))
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Check if a line of the instance is in slow memory
+ *
+ * @param rv reverb instance
+ * @return uint8_t 1 if one is
+ */
+static uint8_t has_slow_line(const jcrev_t *rv)
+{
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        if (rv->ap[k].window[0])
+            return 1;
+    }
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        if (rv->comb[k].window[0])
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Delayed sample of a transition: the old tap crossfaded to the new one
+ *
+ * @param old sample at the current delay
+ * @param new sample at the new delay
+ * @param a position in the transition, 0 to 1
+ * @return int32_t
+ */
+static inline int32_t crossfade(int32_t old, int32_t new, float a)
+{
+    return old + (int32_t)(a * (float)(new - old));
+}
+
+/**
+ * @brief allpass filter over the block of a transition: the gain ramps linearly from g0 to g1
+ *        and the read tap is crossfaded from the current delay of the line to the new one
+ *
+ * @param rv reverb instance
+ * @param line delay line of the filter, set to the new delay at the end
+ * @param x samples, replaced with the filter output
+ * @param n number of samples
+ * @param g0 gain before the block
+ * @param g1 gain at the end of the block
+ * @param delay new delay
+ */
+static void all_pass_ramp(jcrev_t *rv, delay_line_t *line, int32_t *x, uint32_t n, float g0, float g1,
+                          uint32_t delay)
+{
+    int32_t *d = delay_line_fetch(rv->mem, line, n);
+    float step = 1.0f / n;
+
+    if (d)
+    {
+        int32_t *t = d;
+
+        if (delay != line->delay)
+        {
+            t = rv->tap;
+            delay_line_read(rv->mem, line, t, delay, n);
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float a = (i + 1) * step;
+            float g = g0 + a * (g1 - g0);
+            int32_t dm = crossfade(d[i], t[i], a);
+            int32_t w = x[i] + (int32_t)(dm * g);
+            x[i] = dm - (int32_t)(w * g);
+            d[i] = w;
+        }
+    }
+    else
+    {
+        uint32_t r0 = (line->pos + line->len - line->delay) % line->len;
+        uint32_t r1 = (line->pos + line->len - delay) % line->len;
+        uint32_t p = line->pos;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float a = (i + 1) * step;
+            float g = g0 + a * (g1 - g0);
+            int32_t dm = crossfade(line->buf[r0], line->buf[r1], a);
+            int32_t w = x[i] + (int32_t)(dm * g);
+            x[i] = dm - (int32_t)(w * g);
+            line->buf[p] = w;
+            if (++r0 == line->len)
+                r0 = 0;
+            if (++r1 == line->len)
+                r1 = 0;
+            if (++p == line->len)
+                p = 0;
+        }
+    }
+    line->delay = delay;
+    delay_line_commit(rv->mem, line, n);
+}
+
+/**
+ * @brief feedback comb filter over the block of a transition (see all_pass_ramp()), the output is
+ *        added to sum
+ *
+ * @param rv reverb instance
+ * @param line delay line of the filter, set to the new delay at the end
+ * @param x input samples
+ * @param sum accumulator of the comb outputs
+ * @param n number of samples
+ * @param g0 gain before the block
+ * @param g1 gain at the end of the block
+ * @param delay new delay
+ */
+static void comb_ramp(jcrev_t *rv, delay_line_t *line, const int32_t *x, int32_t *sum, uint32_t n, float g0,
+                      float g1, uint32_t delay)
+{
+    int32_t *d = delay_line_fetch(rv->mem, line, n);
+    float step = 1.0f / n;
+
+    if (d)
+    {
+        int32_t *t = d;
+
+        if (delay != line->delay)
+        {
+            t = rv->tap;
+            delay_line_read(rv->mem, line, t, delay, n);
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float a = (i + 1) * step;
+            int32_t y = x[i] + (int32_t)(crossfade(d[i], t[i], a) * (g0 + a * (g1 - g0)));
+            d[i] = y;
+            sum[i] += y;
+        }
+    }
+    else
+    {
+        uint32_t r0 = (line->pos + line->len - line->delay) % line->len;
+        uint32_t r1 = (line->pos + line->len - delay) % line->len;
+        uint32_t p = line->pos;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float a = (i + 1) * step;
+            int32_t y = x[i] + (int32_t)(crossfade(line->buf[r0], line->buf[r1], a) * (g0 + a * (g1 - g0)));
+            line->buf[p] = y;
+            sum[i] += y;
+            if (++r0 == line->len)
+                r0 = 0;
+            if (++r1 == line->len)
+                r1 = 0;
+            if (++p == line->len)
+                p = 0;
+        }
+    }
+    line->delay = delay;
+    delay_line_commit(rv->mem, line, n);
+}
+
+/**
+ * @brief Start a block: the network input is the input plus the early reflections times their
+ *        send, and the comb sum starts with the reflections (times JCREV_COMBS, the output stage
+ *        scales the sum by 1/4)
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param n number of samples, not more than rv->block
+ */
+static void block_input(jcrev_t *rv, const int16_t *in, uint32_t n)
+{
+    int32_t *x = rv->ap_out;
+    int32_t *sum = rv->comb_sum;
+
+    for (uint32_t i = 0; i < n; i++)
+        x[i] = in[i];
+    if (!rv->early)
+    {
+        memset(sum, 0, n * sizeof(int32_t));
+        return;
+    }
+
+    early_process(rv->early, x, sum, n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t e = sum[i];
+
+        x[i] += (int32_t)(e * rv->early_send);
+        sum[i] = e * JCREV_COMBS;
+    }
+}
+
+/**
+ * @brief Process the block of a transition set up by jcrev_update(): the gains of the filters and
+ *        of the output stage ramp linearly over the block, the changed delays are crossfaded
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param out output samples
+ * @param n number of samples, not more than rv->block
+ */
+static void jcrev_block_ramp(jcrev_t *rv, const int16_t *in, int16_t *out, uint32_t n)
+{
+    int32_t *x = rv->ap_out;
+    int32_t *sum = rv->comb_sum;
+    float step = 1.0f / n;
+
+    block_input(rv, in, n);
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        all_pass_ramp(rv, &rv->ap[k], x, n, rv->prev.g_ap[k], rv->params.g_ap[k], rv->params.m_ap[k]);
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+        comb_ramp(rv, &rv->comb[k], x, sum, n, rv->prev.g_comb[k], rv->params.g_comb[k], rv->params.m_comb[k]);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float a = (i + 1) * step;
+        float dry = rv->prev_dry + a * (rv->out_dry - rv->prev_dry);
+        float wet = rv->prev_wet + a * (rv->out_wet - rv->prev_wet);
+
+        out[i] = reverb_sat16((int32_t)(dry * in[i] + wet * sum[i]));
+    }
+    rv->ramp = 0;
+}
+
+/**
+ * @brief Energy of a block of input samples
+ *
+ * @param in samples
+ * @param n number of samples
+ * @return uint64_t sum of the squares
+ */
+static uint64_t energy16(const int16_t *in, uint32_t n)
+{
+    uint64_t e = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+        e += (uint64_t)((int32_t)in[i] * in[i]);
+    return e;
+}
+
+/**
+ * @brief Energy of the comb sum of a block, scaled like the output stage (sum/4)
+ *
+ * @param sum comb sum
+ * @param n number of samples
+ * @return uint64_t sum of the squares
+ */
+static uint64_t energy_wet(const int32_t *sum, uint32_t n)
+{
+    uint64_t e = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+        e += (uint64_t)((int64_t)sum[i] * sum[i]);
+    return e >> 4;
+}
+
+/**
+ * @brief Shortest quiet time after which the lines only hold quiet samples: the longest comb
+ *        delay after the allpass chain, after the longest reflection
+ *
+ * @param rv reverb instance
+ * @return uint32_t samples
+ */
+static uint32_t tail_min(const jcrev_t *rv)
+{
+    uint32_t m = 0;
+    uint32_t e = 0;
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        if (rv->comb[k].delay > m)
+            m = rv->comb[k].delay;
+    }
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        m += rv->ap[k].delay;
+    for (uint32_t t = 0; rv->early && (t < rv->early->taps); t++)
+    {
+        if (rv->early->delay[t] > e)
+            e = rv->early->delay[t];
+    }
+    return m + e;
+}
+
+/**
+ * @brief Clear the lines of the reverb. The write-backs and prefetches queued by the last block
+ *        are waited for first, else they would copy stale samples over the cleared lines.
+ *
+ * @param rv reverb instance
+ */
+static void clear_lines(jcrev_t *rv)
+{
+    reverb_mem_wait(rv->mem);
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        delay_line_clear(&rv->ap[k]);
+    for (int k = 0; k < JCREV_COMBS; k++)
+        delay_line_clear(&rv->comb[k]);
+    if (rv->early)
+        early_reset(rv->early);
+}
+
+/**
+ * @brief Clear the next samples of the lines of a bypassed instance, line after line and the
+ *        early reflections last. The copies queued by the last processed block are waited for
+ *        first, the lines are not used until the instance wakes up.
+ *
+ * @param rv reverb instance, bypassed
+ * @param max most samples cleared
+ */
+static void clear_step(jcrev_t *rv, uint32_t max)
+{
+    reverb_mem_wait(rv->mem);
+    while (max && (rv->clear_line <= JCREV_ALLPASSES + JCREV_COMBS))
+    {
+        uint32_t k = rv->clear_line;
+        uint32_t from = rv->clear_pos;
+        uint32_t size;
+
+        if (k < JCREV_ALLPASSES)
+        {
+            size = rv->ap[k].len;
+            rv->clear_pos = delay_line_clear_part(&rv->ap[k], from, max);
+        }
+        else if (k < JCREV_ALLPASSES + JCREV_COMBS)
+        {
+            size = rv->comb[k - JCREV_ALLPASSES].len;
+            rv->clear_pos = delay_line_clear_part(&rv->comb[k - JCREV_ALLPASSES], from, max);
+        }
+        else
+        {
+            size = rv->early ? rv->early->len + rv->early->block : 0;
+            rv->clear_pos = rv->early ? early_reset_part(rv->early, from, max) : 0;
+        }
+        max -= rv->clear_pos - from;
+        if (rv->clear_pos >= size)
+        {
+            rv->clear_line++;
+            rv->clear_pos = 0;
+        }
+    }
+}
+
+/**
+ * @brief Block of a bypassed instance: the output is the dry signal and the lines, which only
+ *        held quiet samples, are cleared JCREV_GATE_CLEAR samples per sample of the block. On the
+ *        first block with signal (or a transition to process) the instance wakes up, after
+ *        clearing what is left: nothing once the instance stayed bypassed long enough.
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param out output samples
+ * @param n number of samples
+ * @return uint8_t 1 if the block was bypassed, 0 if it has to be processed
+ */
+static uint8_t gate_bypass(jcrev_t *rv, const int16_t *in, int16_t *out, uint32_t n)
+{
+    if (rv->ramp || (energy16(in, n) > (uint64_t)rv->gate * rv->gate * n))
+    {
+        clear_step(rv, UINT32_MAX);
+        rv->idle = 0;
+        rv->quiet = 0;
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = reverb_sat16((int32_t)(rv->out_dry * in[i]));
+    clear_step(rv, JCREV_GATE_CLEAR * n);
+    return 1;
+}
+
+/**
+ * @brief Track the input and the reverb state after a processed block: the instance is bypassed
+ *        once both stayed below the gate level for the hold time
+ *
+ * @param rv reverb instance
+ * @param in input samples of the block
+ * @param sum comb sum of the block
+ * @param n number of samples
+ */
+static void gate_track(jcrev_t *rv, const int16_t *in, const int32_t *sum, uint32_t n)
+{
+    uint64_t floor = (uint64_t)rv->gate * rv->gate * n;
+    uint32_t hold = tail_min(rv);
+
+    if ((energy16(in, n) > floor) || (energy_wet(sum, n) > floor))
+    {
+        rv->quiet = 0;
+        return;
+    }
+    if (rv->hold > hold)
+        hold = rv->hold;
+    rv->quiet += n;
+    if (rv->quiet >= hold)
+    {
+        rv->idle = 1;
+        rv->clear_line = 0;
+        rv->clear_pos = 0;
+    }
+}
+
+/**
+ * @brief Process up to one block: the early reflections if set, three allpass filters in series
+ *        followed by four parallel comb filters. The output stage mixes the comb sum (scaled by
+ *        1/4) with the dry input, applies the volume and saturates to int16 in the same pass.
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param out output samples
+ * @param n number of samples, not more than rv->block
+ */
+REVERB_ITCM static void jcrev_block(jcrev_t *rv, const int16_t *in, int16_t *out, uint32_t n)
+{
+    int32_t *x = rv->ap_out;
+    int32_t *sum = rv->comb_sum;
+
+    if (rv->idle && gate_bypass(rv, in, out, n))
+        return;
+
+    if (rv->ramp)
+    {
+        jcrev_block_ramp(rv, in, out, n);
+        return;
+    }
+
+    block_input(rv, in, n);
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        all_pass_block(rv, &rv->ap[k], x, n, rv->params.g_ap[k]);
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+        comb_block(rv, &rv->comb[k], x, sum, n, rv->params.g_comb[k]);
+
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = reverb_sat16((int32_t)(rv->out_dry * in[i] + rv->out_wet * sum[i]));
+
+    if (rv->gate)
+        gate_track(rv, in, sum, n);
+}
+
+/**
+ * @brief Compute the delays of a configuration at a sample rate and switch the lines to them at
+ *        once, the tail is cleared
+ *
+ * @param rv instance set up with jcrev_init_config()
+ * @param config gains and delays in milliseconds, could be rv->config
+ * @param rate sample rate in Hz
+ * @return uint8_t 0 success, 3 if a delay does not fit its line (nothing is changed)
+ */
+static uint8_t apply_config(jcrev_t *rv, const jcrev_config_t *config, uint32_t rate)
+{
+    jcrev_params_t params;
+
+    jcrev_params_from_config(config, rate, &params);
+    if (!params_fit(rv, &params))
+        return 3;
+    if (rv->early && (rv->early->rate != rate) && early_set(rv->early, &rv->early->config, rate))
+        return 3;
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        rv->ap[k].delay = params.m_ap[k];
+    for (int k = 0; k < JCREV_COMBS; k++)
+        rv->comb[k].delay = params.m_comb[k];
+    rv->config = *config;
+    rv->params = params;
+    rv->rate = rate;
+    rv->ramp = 0;
+    jcrev_reset(rv);
+    return 0;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Convert the delays to sample counts at the given rate. Each delay is rounded and then
+ *        moved up until it is mutually prime with all the previous ones (combs first), so the
+ *        echoes of the filters do not pile up on the same samples.
+ *
+ * @param config gains and delays in milliseconds
+ * @param rate sample rate in Hz
+ * @param params gains and delays in samples
+ */
+void jcrev_params_from_config(const jcrev_config_t *config, uint32_t rate, jcrev_params_t *params)
+{
+    uint32_t m[JCREV_COMBS + JCREV_ALLPASSES];
+
+    for (int k = 0; k < JCREV_COMBS + JCREV_ALLPASSES; k++)
+    {
+        float ms = (k < JCREV_COMBS) ? config->ms_comb[k] : config->ms_ap[k - JCREV_COMBS];
+        uint32_t d = (uint32_t)(ms * rate / 1000.0f + 0.5f);
+        int j = 0;
+
+        if (d < 1)
+            d = 1;
+        while (j < k)
+        {
+            if (gcd(d, m[j]) != 1)
+            {
+                d++;
+                j = 0;
+            }
+            else
+            {
+                j++;
+            }
+        }
+        m[k] = d;
+    }
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        params->g_comb[k] = config->g_comb[k];
+        params->m_comb[k] = m[k];
+    }
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        params->g_ap[k] = config->g_ap[k];
+        params->m_ap[k] = m[JCREV_COMBS + k];
+    }
+}
+
+/**
+ * @brief Set up a reverb instance, the delay lines and the block buffers are taken from mem
+ *
+ * @param rv instance to set up
+ * @param params gains and delays
+ * @param block maximum number of samples processed at once (longer calls are split)
+ * @param mem memory tiers
+ * @return uint8_t 0 success
+ */
+uint8_t jcrev_init(jcrev_t *rv, const jcrev_params_t *params, uint32_t block, reverb_mem_t *mem)
+{
+    memset(rv, 0, sizeof(*rv));
+    if (!block)
+        return 3; // BADARG
+
+    rv->params = *params;
+    rv->mem = mem;
+    rv->block = block;
+    jcrev_set_output(rv, 0.0f, 1.0f, 1.0f);
+    rv->ap_out = (int32_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int32_t));
+    rv->comb_sum = (int32_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int32_t));
+    if (!rv->ap_out || !rv->comb_sum)
+        return 1; // FULL
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        if (delay_line_alloc(mem, &rv->ap[k], params->m_ap[k], block))
+            return 1;
+    }
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        if (delay_line_alloc(mem, &rv->comb[k], params->m_comb[k], block))
+            return 1;
+    }
+
+    /* a delay change of a slow line reads its new tap into fast memory (jcrev_update()) */
+    if (has_slow_line(rv))
+    {
+        rv->tap = (int32_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int32_t));
+        if (!rv->tap)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Set up a reverb instance from delays in milliseconds. The delay lines are sized for
+ *        JCREV_RATE_MAX so jcrev_set_rate() never has to reallocate them.
+ *
+ * @param rv instance to set up
+ * @param config gains and delays in milliseconds
+ * @param rate initial sample rate in Hz
+ * @param block maximum number of samples processed at once
+ * @param mem memory tiers
+ * @return uint8_t 0 success
+ */
+uint8_t jcrev_init_config(jcrev_t *rv, const jcrev_config_t *config, uint32_t rate, uint32_t block,
+                          reverb_mem_t *mem)
+{
+    return jcrev_init_config_max(rv, config, rate, JCREV_RATE_MAX, block, mem);
+}
+
+/**
+ * @brief jcrev_init_config() with the delay lines sized for another highest rate: an instance
+ *        which never runs faster than max_rate (e.g. at a decimated rate) takes less memory, and
+ *        jcrev_set_rate() accepts the rates up to max_rate.
+ *
+ * @param rv instance to set up
+ * @param config gains and delays in milliseconds
+ * @param rate initial sample rate in Hz
+ * @param max_rate highest sample rate, not above JCREV_RATE_MAX
+ * @param block maximum number of samples processed at once
+ * @param mem memory tiers
+ * @return uint8_t 0 success
+ */
+uint8_t jcrev_init_config_max(jcrev_t *rv, const jcrev_config_t *config, uint32_t rate, uint32_t max_rate,
+                              uint32_t block, reverb_mem_t *mem)
+{
+    jcrev_params_t params;
+    uint8_t ret;
+
+    if (!max_rate || (max_rate > JCREV_RATE_MAX))
+        return 3; // BADARG
+
+    jcrev_params_from_config(config, max_rate, &params);
+    ret = jcrev_init(rv, &params, block, mem);
+    if (ret)
+        return ret;
+
+    rv->config = *config;
+    rv->rate = max_rate;
+    return jcrev_set_rate(rv, rate);
+}
+
+/**
+ * @brief Check if the instance could be switched to a sample rate: its delays and those of its
+ *        early reflections have to fit their lines. Nothing is changed, so a caller can check
+ *        every instance before stopping the audio.
+ *
+ * @param rv instance set up with jcrev_init_config()
+ * @param rate sample rate in Hz
+ * @return uint8_t 0 if jcrev_set_rate() would accept it, 3 otherwise
+ */
+uint8_t jcrev_check_rate(const jcrev_t *rv, uint32_t rate)
+{
+    jcrev_params_t params;
+
+    if (!rv->rate || !rate || (rate > JCREV_RATE_MAX))
+        return 3; // BADARG
+
+    jcrev_params_from_config(&rv->config, rate, &params);
+    if (!params_fit(rv, &params))
+        return 3;
+    if (rv->early && early_check(rv->early, &rv->early->config, rate))
+        return 3;
+    return 0;
+}
+
+/**
+ * @brief Switch the instance to another sample rate in place: the delays are recomputed from the
+ *        configuration, the lines keep their memory and the tail is cleared.
+ *
+ * @param rv instance set up with jcrev_init_config()
+ * @param rate sample rate in Hz, not above JCREV_RATE_MAX
+ * @return uint8_t 0 success, 3 if jcrev_check_rate() rejects the rate (nothing is changed)
+ */
+uint8_t jcrev_set_rate(jcrev_t *rv, uint32_t rate)
+{
+    if (jcrev_check_rate(rv, rate))
+        return 3; // BADARG
+
+    return apply_config(rv, &rv->config, rate);
+}
+
+/**
+ * @brief Set the output stage: out = volume·(dry·in + wet·sum/4), saturated to int16
+ *
+ * @param rv reverb instance
+ * @param dry gain of the input signal
+ * @param wet gain of the reverb signal
+ * @param volume output gain
+ */
+void jcrev_set_output(jcrev_t *rv, float dry, float wet, float volume)
+{
+    rv->out_dry = dry * volume;
+    rv->out_wet = wet * volume * 0.25f;
+}
+
+/**
+ * @brief Change the settings of a running instance without a click. The new gains and output
+ *        stage are reached by linear ramps over the next block processed, and the lines whose
+ *        delay changes are read through both taps, crossfaded over the same block. Nothing is
+ *        allocated, so it could be called from the audio context before jcrev_process() (and only
+ *        from there). Several calls before a block end in one transition to the last settings.
+ *
+ * @param rv instance set up with jcrev_init_config()
+ * @param settings gains and delays in milliseconds, output stage
+ * @return uint8_t 0 success, 3 if a new delay does not fit its line (nothing is changed)
+ */
+uint8_t jcrev_update(jcrev_t *rv, const jcrev_settings_t *settings)
+{
+    jcrev_params_t params;
+
+    if (!rv->rate)
+        return 3; // BADARG
+
+    jcrev_params_from_config(&settings->config, rv->rate, &params);
+    if (!params_fit(rv, &params))
+        return 3;
+
+    /* a transition not processed yet still starts from the gains in use */
+    if (!rv->ramp)
+    {
+        rv->prev = rv->params;
+        rv->prev_dry = rv->out_dry;
+        rv->prev_wet = rv->out_wet;
+    }
+    rv->config = settings->config;
+    rv->params = params;
+    jcrev_set_output(rv, settings->dry, settings->wet, settings->volume);
+    rv->ramp = 1;
+    return 0;
+}
+
+/**
+ * @brief Switch an instance to other settings at once, without transition, and clear its tail:
+ *        for an instance which is not heard (see jcrev_preset.h)
+ *
+ * @param rv instance set up with jcrev_init_config()
+ * @param settings gains and delays in milliseconds, output stage
+ * @return uint8_t 0 success, 3 if a delay does not fit its line (nothing is changed)
+ */
+uint8_t jcrev_load(jcrev_t *rv, const jcrev_settings_t *settings)
+{
+    uint8_t ret;
+
+    if (!rv->rate)
+        return 3; // BADARG
+
+    ret = apply_config(rv, &settings->config, rv->rate);
+    if (ret)
+        return ret;
+    jcrev_set_output(rv, settings->dry, settings->wet, settings->volume);
+    return 0;
+}
+
+/**
+ * @brief Set the silence gate: once the input and the reverb tail stay below a level for the hold
+ *        time, the instance is bypassed (the output is the dry input, the lines are cleared a part
+ *        per block) until the input rises above the level again, which is processed at once. The hold time is
+ *        at least the longest comb delay plus the allpass delays, so the lines are quiet too.
+ *
+ * @param rv reverb instance
+ * @param level RMS level of a block in int16 LSB, 0 disables the gate
+ * @param hold quiet samples before the bypass, 0 for the shortest
+ */
+void jcrev_set_gate(jcrev_t *rv, uint32_t level, uint32_t hold)
+{
+    rv->gate = level;
+    rv->hold = hold;
+    rv->quiet = 0;
+    if (!level && rv->idle)
+    {
+        clear_lines(rv);
+        rv->idle = 0;
+    }
+}
+
+/**
+ * @brief Attach an early reflections stage before the network: its taps are added to the wet
+ *        signal and, times send, to the input of the allpass chain. The stage is cleared and, for
+ *        an instance set up with jcrev_init_config(), switched to its rate. Not to be called
+ *        during jcrev_process().
+ *
+ * @param rv reverb instance
+ * @param er stage set up for a block of at least rv->block, NULL to remove the reflections
+ * @param send level of the reflections in the network input, 0 to leave the network as it was
+ * @return uint8_t 0 success, 3 if the stage does not fit the instance (nothing is changed)
+ */
+uint8_t jcrev_set_early(jcrev_t *rv, early_t *er, float send)
+{
+    if (er && ((er->block < rv->block) || (rv->rate && early_set(er, &er->config, rv->rate))))
+        return 3; // BADARG
+
+    rv->early = er;
+    rv->early_send = send;
+    rv->quiet = 0;
+    if (er)
+        early_reset(er);
+    return 0;
+}
+
+/**
+ * @brief Clear the reverb tail, once the copies of its lines still in flight are done
+ *
+ * @param rv reverb instance
+ */
+void jcrev_reset(jcrev_t *rv)
+{
+    clear_lines(rv);
+    rv->idle = 0;
+    rv->quiet = 0;
+}
+
+/**
+ * @brief Reverb effect filter over a buffer: a Schroeder Reverberator called JCRev (see doc)
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param out output samples, could be the same buffer as in
+ * @param n number of samples
+ */
+REVERB_ITCM void jcrev_process(jcrev_t *rv, const int16_t *in, int16_t *out, uint32_t n)
+{
+    while (n)
+    {
+        uint32_t len = (n < rv->block) ? n : rv->block;
+
+        jcrev_block(rv, in, out, len);
+        in += len;
+        out += len;
+        n -= len;
+    }
+}
+
+/**
+ * @brief jcrev_process() over float samples (full scale at 1.0): the input is rounded and
+ *        saturated to int16, so the output has the 16-bit resolution of the engine. The FPU
+ *        flushes subnormals during the call (see reverb_fpu_enter()).
+ *
+ * @param rv reverb instance
+ * @param in input samples
+ * @param out output samples, could be the same buffer as in
+ * @param n number of samples
+ */
+void jcrev_process_f32(jcrev_t *rv, const float *in, float *out, uint32_t n)
+{
+    int16_t buf[JCREV_F32_CHUNK];
+    reverb_fpu_t fpu = reverb_fpu_enter();
+
+    while (n)
+    {
+        uint32_t len = (n < JCREV_F32_CHUNK) ? n : JCREV_F32_CHUNK;
+
+        for (uint32_t i = 0; i < len; i++)
+        {
+#if REVERB_FPU_FLUSH
+            float x = in[i] * 32768.0f;
+#else
+            /* the tail of a float source upstream ends in subnormals, slow to multiply */
+            float x = reverb_flush_denormal(in[i]) * 32768.0f;
+#endif
+
+            /* clamped before the conversion, NaN gives 0 */
+            x = (x > 32767.0f) ? 32767.0f : ((x < -32768.0f) ? -32768.0f : x);
+            buf[i] = (x == x) ? (int16_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f)) : 0;
+        }
+        jcrev_process(rv, buf, buf, len);
+        for (uint32_t i = 0; i < len; i++)
+            out[i] = buf[i] * (1.0f / 32768.0f);
+        in += len;
+        out += len;
+        n -= len;
+    }
+    reverb_fpu_leave(fpu);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file    jcrev_heap.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   jcrev instances with their own heap memory
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdlib.h>
+
+#include <jcrev_heap.h>
+
+/* Blocks taken from the arena by jcrev_init(): two block buffers and one per delay line */
+#define JCREV_HEAP_ALLOCS (2 + JCREV_COMBS + JCREV_ALLPASSES)
+
+/* The instance comes first, the handle given to the caller is its address */
+typedef struct
+{
+    jcrev_t rv;
+    reverb_mem_t mem;
+} jcrev_heap_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Allocate an instance with room for its lines and block buffers, all in the fast tier
+ *
+ * @param params delays the lines are sized for
+ * @param block maximum number of samples processed at once
+ * @return jcrev_heap_t* instance with its memory tiers set up, NULL if out of memory
+ */
+static jcrev_heap_t *jcrev_heap_alloc(const jcrev_params_t *params, uint32_t block)
+{
+    size_t samples = 2 * (size_t)block;
+    size_t size;
+    jcrev_heap_t *h;
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+        samples += params->m_comb[k];
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        samples += params->m_ap[k];
+    size = samples * sizeof(int32_t) + JCREV_HEAP_ALLOCS * REVERB_MEM_ALIGN;
+
+    h = (jcrev_heap_t *)malloc(sizeof(*h) + size);
+    if (!h)
+        return NULL;
+    reverb_mem_init(&h->mem, h + 1, size, NULL, 0);
+    return h;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Create an instance from delays in milliseconds, its rate could be changed later with
+ *        jcrev_set_rate()
+ *
+ * @param config gains and delays, NULL for jcrev_config_default
+ * @param rate sample rate in Hz, up to JCREV_RATE_MAX
+ * @param block maximum number of samples processed at once (longer calls are split)
+ * @return jcrev_t* instance, NULL if out of memory or if an argument is not valid
+ */
+jcrev_t *jcrev_create(const jcrev_config_t *config, uint32_t rate, uint32_t block)
+{
+    jcrev_params_t params;
+    jcrev_heap_t *h;
+
+    if (!config)
+        config = &jcrev_config_default;
+    /* jcrev_init_config() sizes the lines for the highest rate */
+    jcrev_params_from_config(config, JCREV_RATE_MAX, &params);
+    h = jcrev_heap_alloc(&params, block);
+    if (h && jcrev_init_config(&h->rv, config, rate, block, &h->mem))
+    {
+        free(h);
+        h = NULL;
+    }
+    return h ? &h->rv : NULL;
+}
+
+/**
+ * @brief Create an instance from delays in samples
+ *
+ * @param params gains and delays
+ * @param block maximum number of samples processed at once (longer calls are split)
+ * @return jcrev_t* instance, NULL if out of memory or if an argument is not valid
+ */
+jcrev_t *jcrev_create_params(const jcrev_params_t *params, uint32_t block)
+{
+    jcrev_heap_t *h = jcrev_heap_alloc(params, block);
+
+    if (h && jcrev_init(&h->rv, params, block, &h->mem))
+    {
+        free(h);
+        h = NULL;
+    }
+    return h ? &h->rv : NULL;
+}
+
+/**
+ * @brief Release an instance made by jcrev_create() or jcrev_create_params()
+ *
+ * @param rv instance, could be NULL
+ */
+void jcrev_destroy(jcrev_t *rv)
+{
+    free((jcrev_heap_t *)rv);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    jcrev_mailbox.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   wait-free single writer, single reader mailbox of the reverb settings (triple buffer)
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stddef.h>
+
+#include <jcrev_mailbox.h>
+#include <reverb_port.h>
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a mailbox, neither side may use it yet
+ *
+ * @param box mailbox
+ * @param settings settings in use, the reader does not get them from the mailbox
+ */
+void jcrev_mailbox_init(jcrev_mailbox_t *box, const jcrev_settings_t *settings)
+{
+    for (int k = 0; k < 3; k++)
+        box->slot[k] = *settings;
+    box->back = 0;
+    box->middle = 1;
+    box->front = 2;
+}
+
+/**
+ * @brief Publish new settings, called by the writer only. Settings not fetched yet are replaced.
+ *
+ * @param box mailbox
+ * @param settings new settings
+ */
+void jcrev_mailbox_post(jcrev_mailbox_t *box, const jcrev_settings_t *settings)
+{
+    uint32_t prev;
+
+    box->slot[box->back] = *settings;
+    /* the release orders the slot before the index, the acquire gets the slot the reader left */
+    prev = __atomic_exchange_n(&box->middle, box->back | JCREV_MAILBOX_FRESH, __ATOMIC_ACQ_REL);
+    box->back = prev & ~JCREV_MAILBOX_FRESH;
+}
+
+/**
+ * @brief Take the last settings posted, called by the reader only (once per block)
+ *
+ * @param box mailbox
+ * @return const jcrev_settings_t* settings, valid until the next fetch, NULL when nothing was
+ *         posted since the last fetch
+ */
+REVERB_ITCM const jcrev_settings_t *jcrev_mailbox_fetch(jcrev_mailbox_t *box)
+{
+    uint32_t prev;
+
+    if (!(__atomic_load_n(&box->middle, __ATOMIC_RELAXED) & JCREV_MAILBOX_FRESH))
+        return NULL;
+
+    prev = __atomic_exchange_n(&box->middle, box->front, __ATOMIC_ACQ_REL);
+    box->front = prev & ~JCREV_MAILBOX_FRESH;
+    return &box->slot[box->front];
+}
@@ -0,0 +1,159 @@
+/**
+ * @file    jcrev_multirate.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   JCRev network at a decimated rate between half-band stages
+ *
+ * A call of n samples gives floor((n + kept) / factor) samples at the low rate, where kept (up to
+ * factor - 1) are the input samples the decimators keep for the next call. The interpolated wet
+ * signal goes through a queue which starts with factor - 1 zeros, so it always holds the samples
+ * of the call and the output follows the input one for one.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <jcrev_multirate.h>
+#include <reverb_port.h>
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a multirate instance, the output stage is dry 0, wet 1, volume 1
+ *
+ * @param mr instance to set up
+ * @param config gains and delays in milliseconds
+ * @param rate full sample rate in Hz, a multiple of factor
+ * @param factor decimation of the network, 2 or 4
+ * @param block maximum number of samples processed at once, full rate
+ * @param mem memory tiers (the lines, the stages and their buffers)
+ * @return uint8_t 0 success, 1 not enough memory, 3 bad argument
+ */
+uint8_t jcrev_multirate_init(jcrev_multirate_t *mr, const jcrev_config_t *config, uint32_t rate, uint32_t factor,
+                             uint32_t block, reverb_mem_t *mem)
+{
+    reverb_arena_t *arena = &mem->fast;
+    uint32_t low_max = block / factor + 1;
+    uint8_t ret;
+
+    memset(mr, 0, sizeof(*mr));
+    if (((factor != 2) && (factor != 4)) || !block || (rate % factor))
+        return 3; // BADARG
+
+    ret = jcrev_init_config_max(&mr->rv, config, rate / factor, JCREV_RATE_MAX / factor, low_max, mem);
+    if (ret)
+        return ret;
+
+    ret = halfband_init(&mr->dec[0], block, arena);
+    if (!ret)
+        ret = halfband_init(&mr->up[0], block / 2 + 1, arena);
+    if (!ret && (factor == 4))
+        ret = halfband_init(&mr->dec[1], block / 2 + 1, arena);
+    if (!ret && (factor == 4))
+        ret = halfband_init(&mr->up[1], low_max, arena);
+    if (ret)
+        return ret;
+
+    mr->work = (float *)reverb_arena_alloc(arena, (block + factor) * sizeof(float));
+    mr->half = (float *)reverb_arena_alloc(arena, (block / 2 + 2) * sizeof(float));
+    mr->low = (int16_t *)reverb_arena_alloc(arena, low_max * sizeof(int16_t));
+    mr->wet = (float *)reverb_arena_alloc(arena, (block + factor) * sizeof(float));
+    if (!mr->work || !mr->half || !mr->low || !mr->wet)
+        return 1; // FULL
+
+    mr->factor = factor;
+    mr->block = block;
+    jcrev_multirate_set_output(mr, 0.0f, 1.0f, 1.0f);
+    jcrev_multirate_reset(mr);
+    return 0;
+}
+
+/**
+ * @brief Set the output stage: out = volume·(dry·in + wet·reverb), saturated to int16. The wet
+ *        gain is applied by the network at the low rate.
+ *
+ * @param mr multirate instance
+ * @param dry gain of the input signal
+ * @param wet gain of the reverb signal
+ * @param volume output gain
+ */
+void jcrev_multirate_set_output(jcrev_multirate_t *mr, float dry, float wet, float volume)
+{
+    jcrev_set_output(&mr->rv, 0.0f, wet, volume);
+    mr->dry = dry * volume;
+}
+
+/**
+ * @brief Clear the reverb tail and the history of the stages
+ *
+ * @param mr multirate instance
+ */
+void jcrev_multirate_reset(jcrev_multirate_t *mr)
+{
+    jcrev_reset(&mr->rv);
+    halfband_reset(&mr->dec[0]);
+    halfband_reset(&mr->up[0]);
+    if (mr->factor == 4)
+    {
+        halfband_reset(&mr->dec[1]);
+        halfband_reset(&mr->up[1]);
+    }
+    memset(mr->wet, 0, (mr->factor - 1) * sizeof(float));
+    mr->queued = mr->factor - 1;
+}
+
+/**
+ * @brief Reverb effect over a buffer, the network at the low rate
+ *
+ * @param mr multirate instance
+ * @param in input samples
+ * @param out output samples, could be the same buffer as in
+ * @param n number of samples
+ */
+REVERB_ITCM void jcrev_multirate_process(jcrev_multirate_t *mr, const int16_t *in, int16_t *out, uint32_t n)
+{
+    while (n)
+    {
+        uint32_t len = (n < mr->block) ? n : mr->block;
+        float *wet = &mr->wet[mr->queued];
+        uint32_t count;
+
+        for (uint32_t i = 0; i < len; i++)
+            mr->work[i] = in[i];
+        count = halfband_decimate(&mr->dec[0], mr->work, mr->half, len);
+        if (mr->factor == 4)
+            count = halfband_decimate(&mr->dec[1], mr->half, mr->half, count);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float x = mr->half[i];
+
+            mr->low[i] = reverb_sat16((int32_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f)));
+        }
+        jcrev_process(&mr->rv, mr->low, mr->low, count);
+        for (uint32_t i = 0; i < count; i++)
+            mr->half[i] = mr->low[i];
+
+        if (mr->factor == 4)
+        {
+            halfband_interpolate(&mr->up[1], mr->half, mr->work, count);
+            halfband_interpolate(&mr->up[0], mr->work, wet, 2 * count);
+        }
+        else
+        {
+            halfband_interpolate(&mr->up[0], mr->half, wet, count);
+        }
+        mr->queued += mr->factor * count;
+
+        for (uint32_t i = 0; i < len; i++)
+            out[i] = reverb_sat16((int32_t)(mr->dry * in[i] + mr->wet[i]));
+        mr->queued -= len;
+        memmove(mr->wet, &mr->wet[len], mr->queued * sizeof(float));
+
+        in += len;
+        out += len;
+        n -= len;
+    }
+}
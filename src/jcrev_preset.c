@@ -0,0 +1,220 @@
+/**
+ * @file    jcrev_preset.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   preset switch of a reverb channel: two preallocated instances and an equal-power
+ *          crossfade, no allocation and no lock on the audio path
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+
+#include <jcrev_preset.h>
+#include <reverb_port.h>
+
+#define HALF_PI 1.57079632679f
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Mix the outgoing and incoming outputs over a part of the fade: the gains are cos and sin
+ *        of the fade position (constant power for uncorrelated signals), computed at both ends of
+ *        the part and interpolated linearly in between
+ *
+ * @param out outgoing samples, replaced with the mix
+ * @param mix incoming samples
+ * @param n number of samples
+ * @param t0 fade position before the part, 0 to 1
+ * @param t1 fade position at the end of the part
+ */
+static void crossfade(int16_t *out, const int16_t *mix, uint32_t n, float t0, float t1)
+{
+    float c0 = cosf(t0 * HALF_PI);
+    float s0 = sinf(t0 * HALF_PI);
+    float c1 = cosf(t1 * HALF_PI);
+    float s1 = sinf(t1 * HALF_PI);
+    float step = 1.0f / n;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float a = (i + 1) * step;
+        float g_out = c0 + a * (c1 - c0);
+        float g_in = s0 + a * (s1 - s0);
+
+        out[i] = reverb_sat16((int32_t)(g_out * out[i] + g_in * mix[i]));
+    }
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up both instances of a channel. Their lines are sized for the capacity configuration
+ *        at JCREV_RATE_MAX, so a preset could be loaded later if none of its delays is longer.
+ *
+ * @param pm preset switch
+ * @param capacity longest delays of the presets, NULL to size the lines for settings only
+ * @param settings first preset, heard at once
+ * @param rate sample rate in Hz
+ * @param block maximum number of samples processed at once
+ * @param warm blocks the incoming instance runs before it is heard
+ * @param fade blocks of the crossfade, at least 1
+ * @param mem memory tiers of both instances
+ * @return uint8_t 0 success, 1 not enough memory, 3 bad argument
+ */
+uint8_t jcrev_preset_init(jcrev_preset_t *pm, const jcrev_config_t *capacity, const jcrev_settings_t *settings,
+                          uint32_t rate, uint32_t block, uint32_t warm, uint32_t fade, reverb_mem_t *mem)
+{
+    uint8_t ret;
+
+    if (!fade)
+        return 3; // BADARG
+    if (!capacity)
+        capacity = &settings->config;
+
+    for (int k = 0; k < 2; k++)
+    {
+        ret = jcrev_init_config(&pm->inst[k], capacity, rate, block, mem);
+        if (ret)
+            return ret;
+        ret = jcrev_load(&pm->inst[k], settings);
+        if (ret)
+            return ret;
+    }
+    pm->mix = (int16_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int16_t));
+    if (!pm->mix)
+        return 1;
+
+    pm->mem = mem;
+    pm->warm = warm * block;
+    pm->fade = fade * block;
+    pm->pos = 0;
+    pm->pending = 0;
+    pm->active = 0;
+    pm->run = 0;
+    return 0;
+}
+
+/**
+ * @brief Load a preset into the spare instance and start the switch to it. Called outside the
+ *        audio context: it clears the lines of the spare, which takes time.
+ *
+ * @param pm preset switch
+ * @param settings new preset
+ * @return uint8_t 0 success, 1 the previous switch is not done yet, 3 if a delay does not fit
+ *         the lines
+ */
+uint8_t jcrev_preset_load(jcrev_preset_t *pm, const jcrev_settings_t *settings)
+{
+    uint8_t ret;
+
+    if (jcrev_preset_busy(pm))
+        return 1;
+
+    ret = jcrev_load(&pm->inst[pm->active ^ 1], settings);
+    if (ret)
+        return ret;
+    /* the spare is ready before the audio context sees the request */
+    __atomic_store_n(&pm->pending, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * @brief Check if a switch is still in progress
+ *
+ * @param pm preset switch
+ * @return uint8_t 1 until the audio context finished the fade of the last preset loaded
+ */
+uint8_t jcrev_preset_busy(const jcrev_preset_t *pm)
+{
+    return __atomic_load_n(&pm->pending, __ATOMIC_ACQUIRE) ? 1 : 0;
+}
+
+/**
+ * @brief Switch both instances to another sample rate, the audio context must be stopped. A
+ *        switch in progress ends at once on the incoming preset.
+ *
+ * @param pm preset switch
+ * @param rate sample rate in Hz, not above JCREV_RATE_MAX
+ * @return uint8_t 0 success
+ */
+uint8_t jcrev_preset_set_rate(jcrev_preset_t *pm, uint32_t rate)
+{
+    uint8_t ret;
+
+    if (pm->pending)
+    {
+        pm->active ^= 1;
+        pm->run = 0;
+        pm->pending = 0;
+    }
+    for (int k = 0; k < 2; k++)
+    {
+        ret = jcrev_set_rate(&pm->inst[k], rate);
+        if (ret)
+            return ret;
+    }
+    return 0;
+}
+
+/**
+ * @brief Process a buffer with the preset heard, through a switch when one was loaded. Both
+ *        instances run during the warm-up and the fade, twice the cost of one instance.
+ *
+ * @param pm preset switch
+ * @param in input samples
+ * @param out output samples, could be the same buffer as in
+ * @param n number of samples
+ */
+REVERB_ITCM void jcrev_preset_process(jcrev_preset_t *pm, const int16_t *in, int16_t *out, uint32_t n)
+{
+    if (!pm->run)
+    {
+        if (!__atomic_load_n(&pm->pending, __ATOMIC_ACQUIRE))
+        {
+            jcrev_process(&pm->inst[pm->active], in, out, n);
+            return;
+        }
+        pm->run = 1;
+        pm->pos = 0;
+    }
+
+    while (n && pm->run)
+    {
+        jcrev_t *old = &pm->inst[pm->active];
+        jcrev_t *new = &pm->inst[pm->active ^ 1];
+        uint32_t len = (n < old->block) ? n : old->block;
+
+        /* a part is either in the warm-up or in the fade */
+        if (pm->pos < pm->warm)
+        {
+            if (len > pm->warm - pm->pos)
+                len = pm->warm - pm->pos;
+        }
+        else if (len > pm->warm + pm->fade - pm->pos)
+        {
+            len = pm->warm + pm->fade - pm->pos;
+        }
+
+        jcrev_process(new, in, pm->mix, len);
+        jcrev_process(old, in, out, len);
+        if (pm->pos >= pm->warm)
+            crossfade(out, pm->mix, len, (float)(pm->pos - pm->warm) / pm->fade,
+                      (float)(pm->pos + len - pm->warm) / pm->fade);
+        pm->pos += len;
+        in += len;
+        out += len;
+        n -= len;
+
+        if (pm->pos == pm->warm + pm->fade)
+        {
+            pm->active ^= 1;
+            pm->run = 0;
+            /* the copies of the old lines are done before they could be cleared by the next load */
+            reverb_mem_wait(pm->mem);
+            __atomic_store_n(&pm->pending, 0, __ATOMIC_RELEASE);
+        }
+    }
+    if (n)
+        jcrev_process(&pm->inst[pm->active], in, out, n);
+}
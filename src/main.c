@@ -15,6 +15,9 @@
 /* Private variables ---------------------------------------------------------*/
 AUDIO_ApplicationTypeDef appli_state = APPLICATION_READY;
 
+/* Non-cacheable DMA region boundaries, defined in LinkerScript.ld */
+extern uint32_t _sdma_nocache;
+
 /* Private function prototypes -----------------------------------------------*/
 static void MPU_Config(void);
 static void SystemClock_Config(void);
@@ -233,6 +236,23 @@ static void MPU_Config(void)
   
   HAL_MPU_ConfigRegion(&MPU_InitStruct);
 
+  /* Configure the MPU attributes as non-cacheable for the DFSDM DMA scratch
+     buffers: they are written by DMA and read by the BSP record callbacks,
+     so a cached copy would give stale samples */
+  MPU_InitStruct.Enable = MPU_REGION_ENABLE;
+  MPU_InitStruct.BaseAddress = (uint32_t)&_sdma_nocache;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_2KB;
+  MPU_InitStruct.AccessPermission = MPU_REGION_FULL_ACCESS;
+  MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+  MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+  MPU_InitStruct.IsShareable = MPU_ACCESS_SHAREABLE;
+  MPU_InitStruct.Number = MPU_REGION_NUMBER3;
+  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL1;
+  MPU_InitStruct.SubRegionDisable = 0x00;
+  MPU_InitStruct.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
   /* Enable the MPU */
   HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
 }
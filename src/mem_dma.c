@@ -0,0 +1,180 @@
+/**
+  ******************************************************************************
+  * @file    mem_dma.c
+  *
+  * @brief   Queued memory-to-memory copies on a free DMA2 stream. Used as the
+  *          block mover of the reverb memory tiers: delay line blocks are
+  *          prefetched from SDRAM into DTCM while the core computes.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mem_dma.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  uint32_t dst;
+  uint32_t src;
+  uint32_t words;
+}MEM_DMA_CopyTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+DMA_HandleTypeDef hdma_mem;
+
+static MEM_DMA_CopyTypeDef queue[MEM_DMA_QUEUE_SIZE];
+static __IO uint32_t queue_head;  /* next copy to start */
+static __IO uint32_t queue_tail;  /* next free entry, also the number of copies queued */
+static __IO uint32_t queue_done;  /* number of copies completed */
+static __IO uint32_t busy;
+static uint32_t stall_cycles;     /* DWT cycles spent in MEM_DMA_Wait() */
+
+/* Private function prototypes -----------------------------------------------*/
+static void MEM_DMA_StartNext(void);
+static void MEM_DMA_TransferComplete(DMA_HandleTypeDef *hdma);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Configures the DMA stream for memory-to-memory word copies.
+  * @param  None
+  * @retval None
+  */
+void MEM_DMA_Init(void)
+{
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  hdma_mem.Instance = MEM_DMA_STREAM;
+  hdma_mem.Init.Channel = MEM_DMA_CHANNEL;
+  hdma_mem.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  hdma_mem.Init.PeriphInc = DMA_PINC_ENABLE;
+  hdma_mem.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_mem.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  hdma_mem.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  hdma_mem.Init.Mode = DMA_NORMAL;
+  hdma_mem.Init.Priority = DMA_PRIORITY_LOW;         /* audio streams go first */
+  hdma_mem.Init.FIFOMode = DMA_FIFOMODE_ENABLE;      /* mandatory for memory-to-memory */
+  hdma_mem.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+  hdma_mem.Init.MemBurst = DMA_MBURST_SINGLE;
+  hdma_mem.Init.PeriphBurst = DMA_PBURST_SINGLE;
+  HAL_DMA_Init(&hdma_mem);
+  HAL_DMA_RegisterCallback(&hdma_mem, HAL_DMA_XFER_CPLT_CB_ID, MEM_DMA_TransferComplete);
+
+  queue_head = 0;
+  queue_tail = 0;
+  queue_done = 0;
+  busy = 0;
+  stall_cycles = 0;
+
+  HAL_NVIC_SetPriority(MEM_DMA_IRQ, MEM_DMA_IRQ_PREPRIO, 0);
+  HAL_NVIC_EnableIRQ(MEM_DMA_IRQ);
+}
+
+/**
+  * @brief  Queues a copy, it starts at once if the stream is idle.
+  * @param  ctx: not used
+  * @param  dst: destination, word aligned
+  * @param  src: source, word aligned
+  * @param  size: number of bytes, multiple of 4
+  * @retval Sequence number of the copy, for MEM_DMA_Wait()
+  */
+uint32_t MEM_DMA_Copy(void *ctx, void *dst, const void *src, size_t size)
+{
+  uint32_t primask;
+  uint32_t seq;
+
+  (void)ctx;
+  while((queue_tail - queue_head) >= MEM_DMA_QUEUE_SIZE)
+  {
+    /* Queue full, the transfer complete interrupt makes room */
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  queue[queue_tail % MEM_DMA_QUEUE_SIZE].dst = (uint32_t)dst;
+  queue[queue_tail % MEM_DMA_QUEUE_SIZE].src = (uint32_t)src;
+  queue[queue_tail % MEM_DMA_QUEUE_SIZE].words = size / sizeof(uint32_t);
+  queue_tail++;
+  seq = queue_tail;
+  if(!busy)
+  {
+    MEM_DMA_StartNext();
+  }
+  __set_PRIMASK(primask);
+  return seq;
+}
+
+/**
+  * @brief  Waits until the copy seq and the ones queued before it are done,
+  *         the copies queued after it keep running. The time spent waiting is
+  *         added to the stall counter.
+  * @param  ctx: not used
+  * @param  seq: sequence number returned by MEM_DMA_Copy()
+  * @retval None
+  */
+void MEM_DMA_Wait(void *ctx, uint32_t seq)
+{
+  uint32_t start;
+
+  (void)ctx;
+  if((int32_t)(queue_done - seq) >= 0)
+  {
+    return;
+  }
+  start = DWT->CYCCNT;
+  while((int32_t)(queue_done - seq) < 0)
+  {
+  }
+  stall_cycles += DWT->CYCCNT - start;
+}
+
+/**
+  * @brief  Returns the DWT cycles spent waiting for copies since the last call.
+  * @param  None
+  * @retval Cycles
+  */
+uint32_t MEM_DMA_TakeStallCycles(void)
+{
+  uint32_t cycles = stall_cycles;
+
+  stall_cycles = 0;
+  return cycles;
+}
+
+/*******************************************************************************
+                            Static Functions
+*******************************************************************************/
+
+/**
+  * @brief  Starts the oldest queued copy once the pending CPU writes are done.
+  * @param  None
+  * @retval None
+  */
+static void MEM_DMA_StartNext(void)
+{
+  MEM_DMA_CopyTypeDef *copy;
+
+  if(queue_head == queue_tail)
+  {
+    busy = 0;
+    return;
+  }
+  copy = &queue[queue_head % MEM_DMA_QUEUE_SIZE];
+  queue_head++;
+  busy = 1;
+  /* The CPU may have just written the source (delay_line_clear() on an SDRAM
+     line): drain the write buffer so the DMA reads what the core wrote */
+  __DSB();
+  HAL_DMA_Start_IT(&hdma_mem, copy->src, copy->dst, copy->words);
+}
+
+/**
+  * @brief  DMA transfer complete callback, chains the next queued copy.
+  * @param  hdma: DMA handle
+  * @retval None
+  */
+static void MEM_DMA_TransferComplete(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  queue_done++;
+  MEM_DMA_StartNext();
+}
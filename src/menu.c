@@ -123,7 +123,7 @@ void AUDIO_MenuProcess(void)
           LCD_ClearTextZone();
 
           /* Initialize the Audio codec and all related peripherals (I2S, I2C, IOExpander, IOs...) */
-            if(BSP_AUDIO_OUT_Init(OUTPUT_DEVICE_HEADPHONE, 100, BSP_AUDIO_FREQUENCY_16K) == 0)
+            if(BSP_AUDIO_OUT_Init(OUTPUT_DEVICE_HEADPHONE, 100, AUDIO_FREQUENCY) == 0)
             {
               BSP_AUDIO_OUT_SetAudioFrameSlot(CODEC_AUDIOFRAME_SLOT_02);
             }
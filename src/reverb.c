@@ -14,15 +14,17 @@
 #include <string.h>
 
 #include <reverb.h>
+#include <reverb_port.h>
+#include <reverb_trace.h>
 
-#define ALL_PASS(suffix)              \
-    reverb_get(&x, &y, m_##suffix);   \
-    log_xy(x, y, __func__, __LINE__); \
+#define ALL_PASS(suffix)                                          \
+    reverb_get(&x, &y, m_##suffix);                               \
+    REVERB_TRACE_EVENT(REVERB_TRACE_ALLPASS, m_##suffix, x, y);   \
     ret = all_pass(ret, x, y, g_##suffix);
 
-#define COMB(suffix)                  \
-    reverb_get(&x, &y, m_##suffix);   \
-    log_xy(x, y, __func__, __LINE__); \
+#define COMB(suffix)                                              \
+    reverb_get(&x, &y, m_##suffix);                               \
+    REVERB_TRACE_EVENT(REVERB_TRACE_COMB, m_##suffix, x, y);      \
     ret += comb(sample, x, y, g_##suffix);
 
 typedef struct
@@ -36,42 +38,13 @@ typedef struct
 static circ_buf_t buf;
 static int samples_max;
 
-/* ----- Log ----------------------------------------------------------------------------------- */
-//#define EN_DEBUG
-#ifdef EN_DEBUG
-static void log_xy(int32_t x, int32_t y, char const *const fname, int line)
-{
-    printf("%s():%d x %d, y %d\n", fname, line, x, y);
-}
-
-static void log_buf(char const *const fname, int line)
-{
-    printf("%s():%d head %d, tail %d\n", fname, line, buf.head, buf.tail);
-    printf("%s():%d ", fname, line);
-    for (int i = 0; i < samples_max; i++)
-        printf("(%d, %d) ", buf.samples_x[i], buf.samples_y[i]);
-    printf("\n");
-}
-
-static void log_idx(int32_t idx, char const *const fname, int line)
-{
-    printf("%s():%d head %d, tail %d, sample_max %d, idx %d\n",
-           fname, line, buf.head, buf.tail, samples_max, idx);
-}
-#else
+#ifdef REVERB_BENCHMARK
+/* The on-target benchmark times the history in DTCM (zero wait state) when it fits. The loopback
+   runs jcrev, so other builds take the history from the heap and leave the DTCM to its lines */
+#define REVERB_DTCM_SAMPLES 8192
 
-static void log_xy(int32_t x, int32_t y, char const *const fname, int line)
-{
-    return;
-}
-static void log_buf(char const *const fname, int line)
-{
-    return;
-}
-static void log_idx(int32_t idx, char const *const fname, int line)
-{
-    return;
-}
+REVERB_DTCM static int32_t dtcm_samples_x[REVERB_DTCM_SAMPLES];
+REVERB_DTCM static int32_t dtcm_samples_y[REVERB_DTCM_SAMPLES];
 #endif
 
 /* ----- Static function ------------------------------------------------------------------------ */
@@ -82,7 +55,7 @@ static void log_idx(int32_t idx, char const *const fname, int line)
  * @param sample_y output sample
  * @return uint8_t 0 if success
  */
-static uint8_t reverb_put(int32_t sample_x, int32_t sample_y)
+REVERB_ITCM static uint8_t reverb_put(int32_t sample_x, int32_t sample_y)
 {
     uint16_t head = buf.head + 1;
     uint16_t tail = buf.tail;
@@ -97,8 +70,7 @@ static uint8_t reverb_put(int32_t sample_x, int32_t sample_y)
     buf.samples_x[head] = sample_x;
     buf.samples_y[head] = sample_y;
     buf.head = head;
-    log_buf(__func__, __LINE__);
-    log_idx(0, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_PUT, head, sample_x, sample_y);
     return 0;
 }
 
@@ -109,7 +81,7 @@ static uint8_t reverb_put(int32_t sample_x, int32_t sample_y)
  * @param y pointer to set tail y-sample
  * @return uint8_t 0 if success
  */
-static uint8_t reverb_pop(int32_t *x, int32_t *y)
+REVERB_ITCM static uint8_t reverb_pop(int32_t *x, int32_t *y)
 {
     uint16_t head = buf.head;
     uint16_t tail = buf.tail;
@@ -120,7 +92,6 @@ static uint8_t reverb_pop(int32_t *x, int32_t *y)
         y = 0;
         return 1; // EMPTY
     }
-    log_idx(0, __func__, __LINE__);
     if (((head - tail) != samples_max - 1) && ((tail - head) != 1))
     {
         x = 0;
@@ -134,9 +105,7 @@ static uint8_t reverb_pop(int32_t *x, int32_t *y)
 
     *x = buf.samples_x[buf.tail];
     *y = buf.samples_y[buf.tail];
-
-    log_buf(__func__, __LINE__);
-    log_idx(0, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_POP, buf.tail, *x, *y);
     return 0;
 }
 
@@ -148,7 +117,7 @@ static uint8_t reverb_pop(int32_t *x, int32_t *y)
  * @param idx index of sample before head element to return
  * @return int8_t 0 if success
  */
-static uint8_t reverb_get(int32_t *x, int32_t *y, uint16_t idx)
+REVERB_ITCM static uint8_t reverb_get(int32_t *x, int32_t *y, uint16_t idx)
 {
     uint16_t head = buf.head;
     uint16_t tail = buf.tail;
@@ -170,9 +139,7 @@ static uint8_t reverb_get(int32_t *x, int32_t *y, uint16_t idx)
     uint16_t buf_idx = (samples_max + buf.head - idx) % samples_max;
     *x = buf.samples_x[buf_idx];
     *y = buf.samples_y[buf_idx];
-
-    log_buf(__func__, __LINE__);
-    log_idx(idx, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_GET, idx, *x, *y);
     return 0;
 }
 /**
@@ -184,7 +151,7 @@ static uint8_t reverb_get(int32_t *x, int32_t *y, uint16_t idx)
  * @param g
  * @return int32_t
  */
-static int32_t comb(int16_t sample, int32_t x, int32_t y, float g)
+REVERB_ITCM static int32_t comb(int16_t sample, int32_t x, int32_t y, float g)
 {
     // y[n] = x[n] + g·y[n−M]
 
@@ -203,7 +170,7 @@ static int32_t comb(int16_t sample, int32_t x, int32_t y, float g)
  * @param g
  * @return uint32_t
  */
-static uint32_t all_pass(int16_t sample, int32_t x, int32_t y, float g)
+REVERB_ITCM static uint32_t all_pass(int16_t sample, int32_t x, int32_t y, float g)
 {
     // y[n] = (−g·x[n]) + x[n−M] + (g·y[n−M])
     int32_t ret = (y - x);
@@ -226,20 +193,40 @@ uint8_t reverb_init(int M)
         return 1;
     }
     samples_max = M + 1;
-    buf.samples_x = (int32_t *)malloc(samples_max * sizeof(int32_t));
+#ifdef REVERB_BENCHMARK
+    if (samples_max <= REVERB_DTCM_SAMPLES)
+    {
+        buf.samples_x = dtcm_samples_x;
+        buf.samples_y = dtcm_samples_y;
+    }
+    else
+#endif
+    {
+        buf.samples_x = (int32_t *)malloc(samples_max * sizeof(int32_t));
+        buf.samples_y = (int32_t *)malloc(samples_max * sizeof(int32_t));
+        if (!buf.samples_x || !buf.samples_y)
+        {
+            reverb_deinit();
+            return 1;
+        }
+    }
     memset(buf.samples_x, 0, samples_max * sizeof(int32_t));
-    buf.samples_y = (int32_t *)malloc(samples_max * sizeof(int32_t));
     memset(buf.samples_y, 0, samples_max * sizeof(int32_t));
-    log_buf(__func__, __LINE__);
-    log_idx(0, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_INIT, 0, samples_max, 0);
     return 0;
 }
 
 void reverb_deinit()
 {
+#ifdef REVERB_BENCHMARK
+    if (buf.samples_x != dtcm_samples_x)
+#endif
+    {
+        free(buf.samples_x);
+        free(buf.samples_y);
+    }
     samples_max = 0;
-    free(buf.samples_x);
-    free(buf.samples_y);
+    memset(&buf, 0, sizeof(buf));
 }
 
 #if 1
@@ -250,7 +237,7 @@ void reverb_deinit()
  * @param m_comb0 should be equal to buffer size (optimisation) so not present
  * @return int16_t
  */
-int16_t reverb(int16_t sample, float g_comb0,
+REVERB_ITCM int16_t reverb(int16_t sample, float g_comb0,
                float g_comb1, int16_t m_comb1,
                float g_comb2, int16_t m_comb2,
                float g_comb3, int16_t m_comb3,
@@ -268,7 +255,7 @@ int16_t reverb(int16_t sample, float g_comb0,
 
     // comb0 is the tail of the buffer so pop have to be use
     reverb_pop(&x, &y);
-    log_xy(x, y, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_COMB, 0, x, y);
     ret = comb(sample, x, y, g_comb0);
 
     COMB(comb1);
@@ -276,7 +263,8 @@ int16_t reverb(int16_t sample, float g_comb0,
     COMB(comb3);
 
     reverb_put(sample, ret);
-    return ret;
+    REVERB_TRACE_EVENT(REVERB_TRACE_OUTPUT, 0, sample, ret);
+    return reverb_sat16(ret);
 }
 
 #else
@@ -296,7 +284,7 @@ int16_t reverb(int16_t sample, float g_comb0,
     {
         // printf("Reverb get empty buffer.\n");
     }
-    log_xy(x, y, __func__, __LINE__);
+    REVERB_TRACE_EVENT(REVERB_TRACE_COMB, 0, x, y);
 
     int32_t ret = comb(sample, x, y, g_comb1)
         reverb_put(sample, ret);
@@ -0,0 +1,336 @@
+/**
+ * @file    reverb_mem.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   tiered memory for the reverb delay lines
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <reverb_mem.h>
+#include <reverb_port.h>
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Start a copy with the configured block mover (memcpy if there is none), its sequence
+ *        number is kept in mem->seq
+ *
+ * @param mem memory tiers
+ * @param dst destination
+ * @param src source
+ * @param size number of bytes
+ */
+static void mem_copy(reverb_mem_t *mem, void *dst, const void *src, size_t size)
+{
+    if (mem->copy.start)
+        mem->seq = mem->copy.start(mem->copy.ctx, dst, src, size);
+    else
+        memcpy(dst, src, size);
+}
+
+/**
+ * @brief Wait for the copy seq and the ones started before it
+ *
+ * @param mem memory tiers
+ * @param seq sequence number of a copy
+ */
+static void mem_wait(reverb_mem_t *mem, uint32_t seq)
+{
+    if (mem->copy.wait)
+        mem->copy.wait(mem->copy.ctx, seq);
+}
+
+/**
+ * @brief Copy n samples of the ring starting at idx to dst (two copies if the ring wraps)
+ *
+ * @param mem memory tiers
+ * @param line delay line
+ * @param dst destination
+ * @param idx first ring index
+ * @param n number of samples
+ */
+static void ring_read(reverb_mem_t *mem, delay_line_t *line, int32_t *dst, uint32_t idx, uint32_t n)
+{
+    uint32_t first = line->len - idx;
+
+    if (first >= n)
+    {
+        mem_copy(mem, dst, &line->buf[idx], n * sizeof(int32_t));
+        return;
+    }
+    mem_copy(mem, dst, &line->buf[idx], first * sizeof(int32_t));
+    mem_copy(mem, &dst[first], line->buf, (n - first) * sizeof(int32_t));
+}
+
+/**
+ * @brief Copy n samples from src to the ring starting at idx (two copies if the ring wraps)
+ *
+ * @param mem memory tiers
+ * @param line delay line
+ * @param src source
+ * @param idx first ring index
+ * @param n number of samples
+ */
+static void ring_write(reverb_mem_t *mem, delay_line_t *line, const int32_t *src, uint32_t idx, uint32_t n)
+{
+    uint32_t first = line->len - idx;
+
+    if (first >= n)
+    {
+        mem_copy(mem, &line->buf[idx], src, n * sizeof(int32_t));
+        return;
+    }
+    mem_copy(mem, &line->buf[idx], src, first * sizeof(int32_t));
+    mem_copy(mem, line->buf, &src[first], (n - first) * sizeof(int32_t));
+}
+
+/**
+ * @brief Ring index of the sample read by the block starting at the write position
+ *
+ * @param line delay line
+ * @return uint32_t index of the read tap
+ */
+static uint32_t read_index(const delay_line_t *line)
+{
+    return (line->pos + line->len - line->delay) % line->len;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up an arena over a memory block
+ *
+ * @param arena arena to set up
+ * @param base memory block, could be NULL if size is 0
+ * @param size size of the block in bytes
+ */
+void reverb_arena_init(reverb_arena_t *arena, void *base, size_t size)
+{
+    arena->base = (uint8_t *)base;
+    arena->size = base ? size : 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief Take an aligned block from the arena
+ *
+ * @param arena arena
+ * @param size number of bytes
+ * @return void* block or NULL if the arena is full
+ */
+void *reverb_arena_alloc(reverb_arena_t *arena, size_t size)
+{
+    uintptr_t addr = (uintptr_t)(arena->base + arena->used);
+    size_t pad = (REVERB_MEM_ALIGN - (addr % REVERB_MEM_ALIGN)) % REVERB_MEM_ALIGN;
+
+    if (arena->used + pad + size > arena->size)
+        return NULL;
+
+    arena->used += pad + size;
+    return (void *)(addr + pad);
+}
+
+/**
+ * @brief Give back all the blocks taken from the arena
+ *
+ * @param arena arena
+ */
+void reverb_arena_reset(reverb_arena_t *arena)
+{
+    arena->used = 0;
+}
+
+/**
+ * @brief Set up the memory tiers; without slow memory every delay line is placed in fast memory
+ *
+ * @param mem memory tiers
+ * @param fast fast memory block
+ * @param fast_size size of the fast block in bytes
+ * @param slow slow memory block, could be NULL
+ * @param slow_size size of the slow block in bytes
+ */
+void reverb_mem_init(reverb_mem_t *mem, void *fast, size_t fast_size, void *slow, size_t slow_size)
+{
+    memset(mem, 0, sizeof(*mem));
+    reverb_arena_init(&mem->fast, fast, fast_size);
+    reverb_arena_init(&mem->slow, slow, slow_size);
+    mem->slow_threshold = REVERB_MEM_SLOW_THRESHOLD;
+}
+
+/**
+ * @brief Give back the memory of all the delay lines
+ *
+ * @param mem memory tiers
+ */
+void reverb_mem_reset(reverb_mem_t *mem)
+{
+    mem_wait(mem, mem->seq);
+    reverb_arena_reset(&mem->fast);
+    reverb_arena_reset(&mem->slow);
+}
+
+/**
+ * @brief Allocate a delay line. Lines not shorter than the slow threshold (and the block) go to
+ *        slow memory with two windows of one block in fast memory, the others to fast memory.
+ *
+ * @param mem memory tiers
+ * @param line line to set up
+ * @param len ring length (and delay) in samples
+ * @param block maximum number of samples processed at once
+ * @return uint8_t 0 if success
+ */
+uint8_t delay_line_alloc(reverb_mem_t *mem, delay_line_t *line, uint32_t len, uint32_t block)
+{
+    memset(line, 0, sizeof(*line));
+    if (!len || !block)
+        return 3; // BADARG
+
+    line->len = len;
+    line->delay = len;
+    line->block = block;
+
+    if (mem->slow.size && (len >= mem->slow_threshold) && (len >= block))
+    {
+        size_t fast_used = mem->fast.used;
+        size_t slow_used = mem->slow.used;
+
+        line->buf = (int32_t *)reverb_arena_alloc(&mem->slow, len * sizeof(int32_t));
+        line->window[0] = (int32_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int32_t));
+        line->window[1] = (int32_t *)reverb_arena_alloc(&mem->fast, block * sizeof(int32_t));
+        if (line->buf && line->window[0] && line->window[1])
+        {
+            delay_line_clear(line);
+            return 0;
+        }
+        mem->fast.used = fast_used;
+        mem->slow.used = slow_used;
+        line->window[0] = NULL;
+        line->window[1] = NULL;
+    }
+
+    line->buf = (int32_t *)reverb_arena_alloc(&mem->fast, len * sizeof(int32_t));
+    if (!line->buf)
+        return 1; // FULL
+
+    delay_line_clear(line);
+    return 0;
+}
+
+/**
+ * @brief Reset the line to silence
+ *
+ * @param line delay line
+ */
+void delay_line_clear(delay_line_t *line)
+{
+    delay_line_clear_part(line, 0, line->len);
+}
+
+/**
+ * @brief Reset part of the ring to silence, to spread the clearing of a line which is not used
+ *        meanwhile over several calls. The windows and the positions are reset with the last part.
+ *
+ * @param line delay line
+ * @param from first sample of the ring to clear
+ * @param max most samples cleared by this call
+ * @return uint32_t first sample left to clear, line->len once the whole line is silent
+ */
+uint32_t delay_line_clear_part(delay_line_t *line, uint32_t from, uint32_t max)
+{
+    uint32_t n = (line->len - from < max) ? line->len - from : max;
+
+    memset(line->buf + from, 0, n * sizeof(int32_t));
+    from += n;
+    if (from < line->len)
+        return from;
+
+    if (line->window[0])
+    {
+        memset(line->window[0], 0, line->block * sizeof(int32_t));
+        memset(line->window[1], 0, line->block * sizeof(int32_t));
+    }
+    line->pos = 0;
+    line->cur = 0;
+    line->primed = 0;
+    line->seq = 0;
+    return from;
+}
+
+/**
+ * @brief Get the delayed samples of the next block of a slow line (the window prefetched during
+ *        the previous block). The new samples have to be stored in place of the delayed ones.
+ *        Only the prefetch of this line is waited for: the write-backs and prefetches queued
+ *        after it by the other lines keep running while this one is computed.
+ *
+ * @param mem memory tiers
+ * @param line delay line
+ * @param n number of samples in the block, not more than the line block
+ * @return int32_t* window with n delayed samples, NULL for a fast line (use the ring directly)
+ */
+REVERB_ITCM int32_t *delay_line_fetch(reverb_mem_t *mem, delay_line_t *line, uint32_t n)
+{
+    if (!line->window[0])
+        return NULL;
+
+    if (!line->primed)
+    {
+        ring_read(mem, line, line->window[line->cur], read_index(line), n);
+        line->seq = mem->seq;
+        line->primed = 1;
+    }
+    mem_wait(mem, line->seq);
+    return line->window[line->cur];
+}
+
+/**
+ * @brief Finish the block: advance the line and, for a slow line, write the window back and start
+ *        the prefetch of the next block so it runs while the caller computes
+ *
+ * @param mem memory tiers
+ * @param line delay line
+ * @param n number of samples in the block
+ */
+REVERB_ITCM void delay_line_commit(reverb_mem_t *mem, delay_line_t *line, uint32_t n)
+{
+    uint32_t pos = line->pos;
+
+    line->pos = (pos + n) % line->len;
+    if (!line->window[0])
+        return;
+
+    ring_write(mem, line, line->window[line->cur], pos, n);
+    line->cur ^= 1;
+    ring_read(mem, line, line->window[line->cur], read_index(line), line->block);
+    line->seq = mem->seq;
+}
+
+/**
+ * @brief Copy the n samples of the block starting at the write position as seen by another read
+ *        tap, and wait for the copy. The line keeps its own tap: used to crossfade to a new delay.
+ *
+ * @param mem memory tiers
+ * @param line delay line
+ * @param dst destination of the n samples
+ * @param delay distance of the tap, up to the ring length and not shorter than n for a slow line
+ * @param n number of samples
+ */
+void delay_line_read(reverb_mem_t *mem, delay_line_t *line, int32_t *dst, uint32_t delay, uint32_t n)
+{
+    mem_wait(mem, mem->seq);
+    ring_read(mem, line, dst, (line->pos + line->len - delay) % line->len, n);
+    mem_wait(mem, mem->seq);
+}
+
+/**
+ * @brief Wait for the copies queued by the delay lines, e.g. before the lines of an instance which
+ *        stopped being processed are cleared from another context
+ *
+ * @param mem memory tiers
+ */
+void reverb_mem_wait(reverb_mem_t *mem)
+{
+    mem_wait(mem, mem->seq);
+}
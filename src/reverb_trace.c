@@ -0,0 +1,61 @@
+/**
+ * @file    reverb_trace.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   binary trace ring of the reverb kernel, compiled in with REVERB_TRACE
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <reverb_trace.h>
+
+#ifdef REVERB_TRACE
+#include <stdio.h>
+
+reverb_trace_t reverb_trace = {
+    .magic = REVERB_TRACE_MAGIC,
+    .version = REVERB_TRACE_VERSION,
+    .event_size = sizeof(reverb_trace_event_t),
+    .size = REVERB_TRACE_SIZE,
+    .clock_hz = REVERB_TRACE_CLOCK_HZ,
+};
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Drop the recorded events
+ */
+void reverb_trace_reset(void)
+{
+    reverb_trace.head = 0;
+}
+
+/**
+ * @brief The ring, to be dumped as it is
+ *
+ * @return const reverb_trace_t* header followed by the events
+ */
+const reverb_trace_t *reverb_trace_get(void)
+{
+    return &reverb_trace;
+}
+
+/**
+ * @brief Write the ring to a file for tools/trace/reverb_trace_decode
+ *
+ * @param path file name
+ * @return uint8_t 0 if success, 1 if the file cannot be written
+ */
+uint8_t reverb_trace_save(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    uint8_t ret;
+
+    if (!f)
+        return 1;
+    ret = (fwrite(&reverb_trace, sizeof(reverb_trace), 1, f) != 1);
+    ret |= (fclose(f) != 0);
+    return ret;
+}
+#endif
@@ -8,6 +8,13 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "soundloop.h"
+#include "jcrev.h"
+#include "jcrev_mailbox.h"
+#include "biquad.h"
+#include "reverb_port.h"
+#include "mem_dma.h"
+#include "cycle_bench.h"
+#include "audio_meter.h"
 #include "reverb.h"
 
 /* Private typedef -----------------------------------------------------------*/
@@ -37,11 +44,76 @@
 #define TOUCH_VOL_PLUS_YMIN     212
 #define TOUCH_VOL_PLUS_YMAX     252
 
+#define TOUCH_RATE_XMIN         490
+#define TOUCH_RATE_XMAX         540
+#define TOUCH_RATE_YMIN         212
+#define TOUCH_RATE_YMAX         252
+
 uint8_t pHeaderBuff[44];
 
 #define SCRATCH_BUFF_SIZE  512
 
-int32_t Scratch[SCRATCH_BUFF_SIZE];
+/* DFSDM DMA destination, read back by the BSP: keep it out of the D-cache */
+AUDIO_DMA_NOCACHE(int32_t Scratch[SCRATCH_BUFF_SIZE]);
+
+/* Each DMA callback hands over one half of the record and playback buffers */
+#define AUDIO_IN_HALF_SIZE      (AUDIO_IN_PCM_BUFFER_SIZE/2)  /* in half-words */
+#define AUDIO_OUT_HALF_SIZE     (AUDIO_OUT_BUFFER_SIZE/2)     /* in bytes */
+
+#if (AUDIO_OUT_HALF_SIZE % AUDIO_CACHE_LINE_SIZE) != 0
+#error "Playback half-buffer must span whole D-cache lines"
+#endif
+#if (AUDIO_OUT_HALF_SIZE != (AUDIO_IN_HALF_SIZE * 2))
+#error "Record and playback half-buffers must hold the same number of samples"
+#endif
+
+/* One reverb instance per recorded channel */
+#define REVERB_CHANNELS         DEFAULT_AUDIO_IN_CHANNEL_NBR
+#define REVERB_FRAMES           (AUDIO_IN_HALF_SIZE / REVERB_CHANNELS)  /* per callback */
+#define REVERB_BLOCK            256         /* samples per channel prefetched at once */
+
+/* Delay lines: the long comb lines live in SDRAM (after the LCD frame buffer)
+   and are streamed through DTCM windows, the allpass lines stay in DTCM */
+#define REVERB_FAST_SIZE        (48*1024)
+#define REVERB_SDRAM_ADDRESS    (SDRAM_DEVICE_ADDR + 0x00400000)
+#define REVERB_SDRAM_SIZE       0x00800000
+
+/* Output stage of the reverb, uwVolume is applied on top of it */
+#define REVERB_DRY              0.0f
+#define REVERB_WET              1.0f
+#define VOLUME_STEP             10
+
+/* The reverb is bypassed once the input and its tail stay below this RMS level
+   (int16 LSB) for the longest delay, and wakes on the first louder block */
+#define REVERB_GATE_LEVEL       8
+
+#ifdef REVERB_EARLY
+/* Level of the early reflections in the input of the comb/allpass network */
+#define REVERB_EARLY_SEND       0.5f
+#endif
+
+#ifndef REVERB_NO_EQ
+/* Pre-EQ: Butterworth high-pass under the rumble of the MEMS microphones
+   (handling noise, wind), which would otherwise feed the long combs.
+   Post-EQ: high shelf taking the edge off the wet output, its corner kept
+   below 0.4 of the sample rate */
+#define REVERB_HPF_HZ           80.0f
+#define REVERB_SHELF_HZ         5000.0f
+#define REVERB_SHELF_DB         -3.0f
+#endif
+
+/* Load meter of the DMA callbacks, shown while recording */
+#define METER_DISPLAY_PERIOD    1000  /* ms between two refreshes of the LCD */
+
+#ifdef REVERB_BENCHMARK
+#define BENCH_REPEATS           16    /* measures of each configuration */
+#define BENCH_LEGACY            0     /* per-sample reverb(), history in DTCM or heap */
+#define BENCH_SDRAM             1     /* jcrev, every line in SDRAM (through the D-cache) */
+#define BENCH_TIERED            2     /* jcrev, combs streamed from SDRAM through DTCM windows */
+#endif
+
+/* Fixed point values of cycle_report_t and audio_meter_report_t as "%lu.%02lu" arguments */
+#define X100(v)                 (unsigned long)((v) / 100), (unsigned long)((v) % 100)
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -49,10 +121,67 @@ ALIGN_32BYTES (static AUDIO_IN_BufferTypeDef  BufferCtl);
 ALIGN_32BYTES (static AUDIO_OUT_BufferTypeDef  outBufferCtl);
 
 static __IO uint32_t uwVolume = 100;
+static uint32_t uwAudioFreq = AUDIO_FREQUENCY;
 static uint32_t  display_update = 1;
 
+REVERB_DTCM static uint8_t reverb_fast[REVERB_FAST_SIZE];
+REVERB_DTCM static int16_t reverb_chan[REVERB_FRAMES];
+static reverb_mem_t reverb_mem;
+static jcrev_t reverb_inst[REVERB_CHANNELS];
+#ifdef REVERB_EARLY
+static early_t reverb_early[REVERB_CHANNELS];
+#endif
+#ifndef REVERB_NO_EQ
+/* Both cascades filter the interleaved channels side by side, in Q31 */
+REVERB_DTCM static biquad_q31_t eq_pre;
+REVERB_DTCM static biquad_q31_t eq_post;
+/* Cascades of the next sample rate, designed before the audio is stopped */
+static biquad_q31_t eq_pre_next;
+static biquad_q31_t eq_post_next;
+#endif
+
+/* Settings edited by the UI (main loop), posted to the audio interrupt which
+   applies them at the start of its next block */
+static jcrev_settings_t reverb_settings;
+static jcrev_mailbox_t reverb_mailbox;
+
+/* Cost of every DMA callback measured with the DWT cycle counter, build once
+   with and once without REVERB_NO_TCM to compare the TCM placement with flash/AXI SRAM */
+static audio_meter_t audio_meter;
+static uint32_t meter_tick;
+
+#ifdef REVERB_BENCHMARK
+static cycle_bench_t cycle_bench;
+#endif
+
+#ifdef REVERB_BENCHMARK
+/* Work measured by one call of a benchmark kernel */
+typedef struct
+{
+  jcrev_t        *inst;
+  jcrev_params_t  params;
+  const int16_t  *in;
+  int16_t        *out;
+  uint32_t        n;
+} AUDIO_BenchTypeDef;
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 static void AUDIO_REC_DisplayButtons(void);
+static void AUDIO_ProcessHalf(uint32_t half);
+static void AUDIO_REC_SetVolume(uint32_t Volume);
+static void AUDIO_REC_DisplayRate(void);
+static void AUDIO_REC_DisplayMeter(void);
+static void AUDIO_DWT_Init(void);
+#ifndef REVERB_NO_EQ
+static uint8_t AUDIO_EQ_Design(uint32_t AudioFreq, biquad_q31_t *pre, biquad_q31_t *post);
+#endif
+#ifdef REVERB_BENCHMARK
+static uint32_t AUDIO_DWT_Read(void *ctx);
+#endif
+#ifdef REVERB_BENCHMARK
+static void AUDIO_BENCH_Run(void);
+#endif
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -86,13 +215,66 @@ static void AUDIO_REC_DisplayButtons(void);
 AUDIO_ErrorTypeDef AUDIO_REC_Start(void)
 {
   uint32_t byteswritten = 0;
+  uint32_t ch;
   uwVolume = 100;
+  /* Everything below starts at AUDIO_FREQUENCY, whatever rate the RATE button left */
+  uwAudioFreq = AUDIO_FREQUENCY;
+
+  /* Reverb instances are ready before the first DMA callback */
+  MEM_DMA_Init();
+  AUDIO_DWT_Init();
+#ifdef REVERB_BENCHMARK
+  AUDIO_BENCH_Run();
+#endif
+  reverb_mem_init(&reverb_mem, reverb_fast, sizeof(reverb_fast),
+                  (void*)REVERB_SDRAM_ADDRESS, REVERB_SDRAM_SIZE);
+  reverb_mem.copy.start = MEM_DMA_Copy;
+  reverb_mem.copy.wait = MEM_DMA_Wait;
+  for(ch = 0; ch < REVERB_CHANNELS; ch++)
+  {
+    if(jcrev_init_config(&reverb_inst[ch], &jcrev_config_default, AUDIO_FREQUENCY,
+                         REVERB_BLOCK, &reverb_mem) != 0)
+    {
+      LCD_ErrLog("Not enough memory for the reverb\n");
+      return AUDIO_ERROR_IO;
+    }
+    jcrev_set_gate(&reverb_inst[ch], REVERB_GATE_LEVEL, 0);
+#ifdef REVERB_EARLY
+    /* The reflections line is read by the CPU through the D-cache: sized
+       for 48 kHz it does not fit in DTCM next to the allpass lines */
+    if((early_init(&reverb_early[ch], &early_config_default, AUDIO_FREQUENCY,
+                   JCREV_RATE_MAX, REVERB_BLOCK, &reverb_mem.slow) != 0) ||
+       (jcrev_set_early(&reverb_inst[ch], &reverb_early[ch], REVERB_EARLY_SEND) != 0))
+    {
+      LCD_ErrLog("Not enough memory for the early reflections\n");
+      return AUDIO_ERROR_IO;
+    }
+#endif
+  }
+#ifndef REVERB_NO_EQ
+  if((biquad_q31_init(&eq_pre, REVERB_CHANNELS, 1) != 0) ||
+     (biquad_q31_init(&eq_post, REVERB_CHANNELS, 1) != 0) ||
+     (AUDIO_EQ_Design(AUDIO_FREQUENCY, &eq_pre, &eq_post) != 0))
+  {
+    LCD_ErrLog("Cannot set up the EQ\n");
+    return AUDIO_ERROR_IO;
+  }
+#endif
+  reverb_settings.config = jcrev_config_default;
+  reverb_settings.dry = REVERB_DRY;
+  reverb_settings.wet = REVERB_WET;
+  reverb_settings.volume = uwVolume / 100.0f;
+  jcrev_mailbox_init(&reverb_mailbox, &reverb_settings);
+  AUDIO_REC_SetVolume(uwVolume);
+  AUDIO_REC_DisplayRate();
+  audio_meter_init(&audio_meter, cycle_budget(SystemCoreClock, uwAudioFreq, REVERB_FRAMES));
+  meter_tick = HAL_GetTick();
 
   AudioState = AUDIO_STATE_PRERECORD;
   AUDIO_REC_DisplayButtons();
   BSP_LCD_DisplayStringAt(247, LINE(6), (uint8_t *)"  [     ]", LEFT_MODE);
 
-  BSP_AUDIO_IN_Init(BSP_AUDIO_FREQUENCY_16K, DEFAULT_AUDIO_IN_BIT_RESOLUTION, DEFAULT_AUDIO_IN_CHANNEL_NBR);
+  BSP_AUDIO_IN_Init(AUDIO_FREQUENCY, DEFAULT_AUDIO_IN_BIT_RESOLUTION, DEFAULT_AUDIO_IN_CHANNEL_NBR);
   BSP_AUDIO_IN_AllocScratch (Scratch, SCRATCH_BUFF_SIZE);
   BSP_AUDIO_IN_Record((uint16_t*)&BufferCtl.pcm_buff[0], AUDIO_IN_PCM_BUFFER_SIZE);
   BufferCtl.fptr = byteswritten;
@@ -101,11 +283,71 @@ AUDIO_ErrorTypeDef AUDIO_REC_Start(void)
   BufferCtl.wr_state = BUFFER_EMPTY;
   BSP_LCD_DisplayStringAt(250, LINE(10), (uint8_t *)"  [PLAY ]", LEFT_MODE);
   BSP_AUDIO_OUT_Play((uint16_t*)&outBufferCtl.buff[0], AUDIO_OUT_BUFFER_SIZE);
-  reverb_init(5801);
   return AUDIO_ERROR_NONE;
 }
 
 
+/**
+  * @brief  Switches the record and playback sample rate. The reverb instances
+  *         are reconfigured in place, their delay lines are kept and their
+  *         tails cleared, the EQ states are cleared too. Every instance and
+  *         the EQ are checked before the audio is stopped: a rate which
+  *         cannot be set leaves the loopback running at the old one.
+  * @param  AudioFreq: 8K, 16K, 32K or 48K BSP_AUDIO_FREQUENCY
+  * @retval Audio error
+  */
+AUDIO_ErrorTypeDef AUDIO_REC_SetFrequency(uint32_t AudioFreq)
+{
+  uint32_t ch;
+
+  if((AudioFreq != BSP_AUDIO_FREQUENCY_8K) && (AudioFreq != BSP_AUDIO_FREQUENCY_16K) &&
+     (AudioFreq != BSP_AUDIO_FREQUENCY_32K) && (AudioFreq != BSP_AUDIO_FREQUENCY_48K))
+  {
+    return AUDIO_ERROR_INVALID_VALUE;
+  }
+  for(ch = 0; ch < REVERB_CHANNELS; ch++)
+  {
+    if(jcrev_check_rate(&reverb_inst[ch], AudioFreq) != 0)
+    {
+      return AUDIO_ERROR_INVALID_VALUE;
+    }
+  }
+#ifndef REVERB_NO_EQ
+  eq_pre_next = eq_pre;
+  eq_post_next = eq_post;
+  if(AUDIO_EQ_Design(AudioFreq, &eq_pre_next, &eq_post_next) != 0)
+  {
+    return AUDIO_ERROR_INVALID_VALUE;
+  }
+#endif
+
+  /* Nothing below fails: the checks above cover jcrev_set_rate() */
+  BSP_AUDIO_IN_Stop();
+  BSP_AUDIO_OUT_Stop(CODEC_PDWN_SW);
+  for(ch = 0; ch < REVERB_CHANNELS; ch++)
+  {
+    jcrev_set_rate(&reverb_inst[ch], AudioFreq);
+  }
+#ifndef REVERB_NO_EQ
+  eq_pre = eq_pre_next;
+  eq_post = eq_post_next;
+  biquad_q31_reset(&eq_pre);
+  biquad_q31_reset(&eq_post);
+#endif
+
+  uwAudioFreq = AudioFreq;
+  audio_meter_set_budget(&audio_meter, cycle_budget(SystemCoreClock, uwAudioFreq, REVERB_FRAMES));
+  BSP_AUDIO_OUT_SetFrequency(AudioFreq);
+  BSP_AUDIO_IN_Init(AudioFreq, DEFAULT_AUDIO_IN_BIT_RESOLUTION, DEFAULT_AUDIO_IN_CHANNEL_NBR);
+  BSP_AUDIO_IN_AllocScratch (Scratch, SCRATCH_BUFF_SIZE);
+  memset(outBufferCtl.buff, 0, AUDIO_OUT_BUFFER_SIZE);
+  SCB_CleanDCache_by_Addr((uint32_t*)outBufferCtl.buff, AUDIO_OUT_BUFFER_SIZE);
+  BSP_AUDIO_IN_Record((uint16_t*)&BufferCtl.pcm_buff[0], AUDIO_IN_PCM_BUFFER_SIZE);
+  BSP_AUDIO_OUT_Play((uint16_t*)&outBufferCtl.buff[0], AUDIO_OUT_BUFFER_SIZE);
+  AUDIO_REC_DisplayRate();
+  return AUDIO_ERROR_NONE;
+}
+
 /*
  * Cop the contents of the Record buffer to the
  * Playback buffer
@@ -115,28 +357,73 @@ AUDIO_ErrorTypeDef AUDIO_REC_Start(void)
  * both buffers available
  *
  */
-static void CopyBuffer(int16_t *pbuffer1, int16_t *pbuffer2, uint16_t BufferSize)
+REVERB_ITCM static void CopyBuffer(int16_t *pbuffer1, int16_t *pbuffer2, uint16_t BufferSize)
 {
+    uint32_t frames = BufferSize / REVERB_CHANNELS;
+    const jcrev_settings_t *settings = jcrev_mailbox_fetch(&reverb_mailbox);
+    const int16_t *in = pbuffer2;
+    uint32_t ch = 0;
     uint32_t i = 0;
-    for (i = 0; i < BufferSize; i++)
+
+    /* new settings from the UI ramp in over this block, rejected ones are dropped */
+    if (settings)
+    {
+        for (ch = 0; ch < REVERB_CHANNELS; ch++)
+            jcrev_update(&reverb_inst[ch], settings);
+    }
+
+#ifndef REVERB_NO_EQ
+    /* pre-EQ of every channel at once, the reverb then reads the playback buffer */
+    biquad_q31_process(&eq_pre, pbuffer2, pbuffer1, frames);
+    in = pbuffer1;
+#endif
+
+    /* the channels are interleaved, each one goes through its own instance */
+    for (ch = 0; ch < REVERB_CHANNELS; ch++)
     {
-    	pbuffer1[i] = reverb(pbuffer2[i], 0.697,
-    					0, 5399,
-						0, 4999,
-						0, 4799,
-						0, 1051,
-						0, 337,
-						0, 113);
-//      	pbuffer1[i] = reverb(pbuffer2[i], 0.697,
-//        					0.715, 5399,
-//    						0.733, 4999,
-//    						0.742, 4799,
-//    						0.7, 1051,
-//    						0.7, 337,
-//    						0.7, 113);
+        for (i = 0; i < frames; i++)
+            reverb_chan[i] = in[i * REVERB_CHANNELS + ch];
+        jcrev_process(&reverb_inst[ch], reverb_chan, reverb_chan, frames);
+        for (i = 0; i < frames; i++)
+            pbuffer1[i * REVERB_CHANNELS + ch] = reverb_chan[i];
     }
+
+#ifndef REVERB_NO_EQ
+    biquad_q31_process(&eq_post, pbuffer1, pbuffer1, frames);
+#endif
 }
 
+#ifndef REVERB_NO_EQ
+/**
+  * @brief  Designs the pre and post EQ for a sample rate, their states are kept.
+  * @param  AudioFreq: sample rate in Hz
+  * @param  pre: pre-EQ cascade
+  * @param  post: post-EQ cascade
+  * @retval 0 if success, 3 if a section cannot be designed at this rate
+  */
+static uint8_t AUDIO_EQ_Design(uint32_t AudioFreq, biquad_q31_t *pre, biquad_q31_t *post)
+{
+  biquad_coef_t coef;
+  float shelf = REVERB_SHELF_HZ;
+
+  if(shelf > 0.4f * AudioFreq)
+  {
+    shelf = 0.4f * AudioFreq;
+  }
+  if((biquad_design(&coef, BIQUAD_HIGHPASS, AudioFreq, REVERB_HPF_HZ, 0.7071f, 0.0f) != 0) ||
+     (biquad_q31_set(pre, 0, BIQUAD_ALL, &coef) != 0))
+  {
+    return 3;
+  }
+  if((biquad_design(&coef, BIQUAD_HIGHSHELF, AudioFreq, shelf, 0.7071f, REVERB_SHELF_DB) != 0) ||
+     (biquad_q31_set(post, 0, BIQUAD_ALL, &coef) != 0))
+  {
+    return 3;
+  }
+  return 0;
+}
+#endif
+
 /**
   * @brief  Manages Audio process. 
   * @param  None
@@ -211,6 +498,28 @@ AUDIO_ErrorTypeDef AUDIO_REC_Process(void)
         {
           AudioState = AUDIO_STATE_PAUSE;
         }
+        else if ((TS_State.touchX[0] > TOUCH_VOL_MINUS_XMIN) && (TS_State.touchX[0] < TOUCH_VOL_MINUS_XMAX) &&
+                 (TS_State.touchY[0] > TOUCH_VOL_MINUS_YMIN) && (TS_State.touchY[0] < TOUCH_VOL_MINUS_YMAX))
+        {
+          AUDIO_REC_SetVolume((uwVolume > VOLUME_STEP) ? (uwVolume - VOLUME_STEP) : 0);
+        }
+        else if ((TS_State.touchX[0] > TOUCH_VOL_PLUS_XMIN) && (TS_State.touchX[0] < TOUCH_VOL_PLUS_XMAX) &&
+                 (TS_State.touchY[0] > TOUCH_VOL_PLUS_YMIN) && (TS_State.touchY[0] < TOUCH_VOL_PLUS_YMAX))
+        {
+          AUDIO_REC_SetVolume((uwVolume < (100 - VOLUME_STEP)) ? (uwVolume + VOLUME_STEP) : 100);
+        }
+        else if ((TS_State.touchX[0] > TOUCH_RATE_XMIN) && (TS_State.touchX[0] < TOUCH_RATE_XMAX) &&
+                 (TS_State.touchY[0] > TOUCH_RATE_YMIN) && (TS_State.touchY[0] < TOUCH_RATE_YMAX))
+        {
+          /* 8 -> 16 -> 32 -> 48 -> 8 kHz */
+          if(AUDIO_REC_SetFrequency((uwAudioFreq < BSP_AUDIO_FREQUENCY_16K) ? BSP_AUDIO_FREQUENCY_16K :
+                                    (uwAudioFreq < BSP_AUDIO_FREQUENCY_32K) ? BSP_AUDIO_FREQUENCY_32K :
+                                    (uwAudioFreq < BSP_AUDIO_FREQUENCY_48K) ? BSP_AUDIO_FREQUENCY_48K :
+                                    BSP_AUDIO_FREQUENCY_8K) != AUDIO_ERROR_NONE)
+          {
+            BSP_LCD_DisplayStringAt(250, LINE(9), (uint8_t *)"Rate   : not available", LEFT_MODE);
+          }
+        }
       }
     }
 
@@ -218,6 +527,11 @@ AUDIO_ErrorTypeDef AUDIO_REC_Process(void)
     {
       BufferCtl.wr_state =  BUFFER_EMPTY;
     }
+    if((HAL_GetTick() - meter_tick) >= METER_DISPLAY_PERIOD)
+    {
+      meter_tick = HAL_GetTick();
+      AUDIO_REC_DisplayMeter();
+    }
     break;
     
   case AUDIO_STATE_STOP:
@@ -267,16 +581,13 @@ AUDIO_ErrorTypeDef AUDIO_REC_Process(void)
 }
 
 /**
-  * @brief  Calculates the remaining file size and new position of the pointer.
+  * @brief  Manages the DMA Transfer complete interrupt.
   * @param  None
   * @retval None
   */
 void BSP_AUDIO_IN_TransferComplete_CallBack(void)
 {
-  CopyBuffer((int16_t*)(outBufferCtl.buff+AUDIO_IN_PCM_BUFFER_SIZE/2),
-		  (int16_t*)(BufferCtl.pcm_buff+AUDIO_IN_PCM_BUFFER_SIZE/2),
-		  AUDIO_OUT_BUFFER_SIZE/2);
-  memset((uint8_t*)(BufferCtl.pcm_buff),0, AUDIO_OUT_BUFFER_SIZE/2);
+  AUDIO_ProcessHalf(1);
 }
 
 /**
@@ -286,16 +597,253 @@ void BSP_AUDIO_IN_TransferComplete_CallBack(void)
   */
 void BSP_AUDIO_IN_HalfTransfer_CallBack(void)
 { 
-  CopyBuffer((int16_t*)(outBufferCtl.buff),
-		  	  (int16_t*)(BufferCtl.pcm_buff ),
-			  AUDIO_IN_PCM_BUFFER_SIZE/2);
-	  memset((uint8_t*)(BufferCtl.pcm_buff),0, AUDIO_IN_PCM_BUFFER_SIZE/2);
+  AUDIO_ProcessHalf(0);
 }
 
 /*******************************************************************************
                             Static Functions
 *******************************************************************************/
 
+/**
+  * @brief  Processes one half of the record buffer into the same half of the
+  *         playback buffer.
+  *         The record buffer is filled by the CPU in the BSP DFSDM callbacks,
+  *         so it is coherent; the playback buffer is read by the SAI DMA, so
+  *         the D-cache lines of the written half are cleaned (32-byte aligned,
+  *         whole lines only) before the DMA reaches them.
+  * @param  half: 0 for the first half, 1 for the second one
+  * @retval None
+  */
+static void AUDIO_ProcessHalf(uint32_t half)
+{
+  int16_t *out = (int16_t*)(outBufferCtl.buff + half * AUDIO_OUT_HALF_SIZE);
+  int16_t *in = (int16_t*)(BufferCtl.pcm_buff + half * AUDIO_IN_HALF_SIZE);
+  uint32_t start = DWT->CYCCNT;
+
+  CopyBuffer(out, in, AUDIO_IN_HALF_SIZE);
+  SCB_CleanDCache_by_Addr((uint32_t*)out, AUDIO_OUT_HALF_SIZE);
+  audio_meter_add(&audio_meter, DWT->CYCCNT - start);
+}
+
+/**
+  * @brief  Sets the playback volume, applied by the reverb output stage. The
+  *         settings are posted to the audio interrupt, which ramps to them
+  *         over its next block.
+  * @param  Volume: 0 to 100
+  * @retval None
+  */
+static void AUDIO_REC_SetVolume(uint32_t Volume)
+{
+  uint8_t str[24];
+
+  uwVolume = Volume;
+  reverb_settings.volume = uwVolume / 100.0f;
+  jcrev_mailbox_post(&reverb_mailbox, &reverb_settings);
+  sprintf((char *)str, "Volume : %3lu", (unsigned long)uwVolume);
+  BSP_LCD_DisplayStringAt(250, LINE(8), str, LEFT_MODE);
+}
+
+/**
+  * @brief  Shows the sample rate of the loopback.
+  * @param  None
+  * @retval None
+  */
+static void AUDIO_REC_DisplayRate(void)
+{
+  uint8_t str[32];
+
+  sprintf((char *)str, "Rate   : %5lu Hz       ", (unsigned long)uwAudioFreq);
+  BSP_LCD_DisplayStringAt(250, LINE(9), str, LEFT_MODE);
+}
+
+/**
+  * @brief  Shows the load meter of the DMA callbacks: average, 99th percentile
+  *         and worst cost in percent of the DMA period, headroom left by the
+  *         worst callback and callbacks which missed their deadline. The stats
+  *         cover the whole recording, they are copied without stopping the
+  *         audio interrupt.
+  * @param  None
+  * @retval None
+  */
+static void AUDIO_REC_DisplayMeter(void)
+{
+  audio_meter_stats_t stats;
+  audio_meter_report_t report;
+  uint32_t headroom;
+  uint8_t str[64];
+
+  audio_meter_snapshot(&audio_meter, &stats);
+  audio_meter_report(&stats, audio_meter.budget, &report);
+  sprintf((char *)str, "CPU %3lu.%02lu%% p99 %3lu.%02lu%% max %3lu.%02lu%%",
+          X100(report.load_x100), X100(report.p99_x100), X100(report.peak_x100));
+  BSP_LCD_DisplayStringAt(250, LINE(12), str, LEFT_MODE);
+  headroom = (report.headroom_x100 < 0) ? -report.headroom_x100 : report.headroom_x100;
+  sprintf((char *)str, "Headroom %c%lu.%02lu%% xruns %lu      ",
+          (report.headroom_x100 < 0) ? '-' : ' ', X100(headroom), (unsigned long)report.xruns);
+  BSP_LCD_DisplayStringAt(250, LINE(13), str, LEFT_MODE);
+}
+
+#ifdef REVERB_BENCHMARK
+/**
+  * @brief  Reads the DWT cycle counter.
+  * @param  ctx: not used
+  * @retval Core cycles
+  */
+static uint32_t AUDIO_DWT_Read(void *ctx)
+{
+  (void)ctx;
+  return DWT->CYCCNT;
+}
+
+#endif
+
+/**
+  * @brief  Starts the DWT cycle counter (and calibrates the bench on it).
+  * @param  None
+  * @retval None
+  */
+static void AUDIO_DWT_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#ifdef REVERB_BENCHMARK
+  cycle_bench_init(&cycle_bench, AUDIO_DWT_Read, NULL);
+#endif
+}
+
+#ifdef REVERB_BENCHMARK
+/**
+  * @brief  Benchmark kernel: one jcrev instance over the bench buffer.
+  * @param  arg: AUDIO_BenchTypeDef
+  * @retval None
+  */
+static void AUDIO_BENCH_Jcrev(void *arg)
+{
+  AUDIO_BenchTypeDef *b = (AUDIO_BenchTypeDef *)arg;
+
+  jcrev_process(b->inst, b->in, b->out, b->n);
+}
+
+/**
+  * @brief  Benchmark kernel: the legacy per-sample reverb over the bench buffer.
+  * @param  arg: AUDIO_BenchTypeDef
+  * @retval None
+  */
+static void AUDIO_BENCH_Legacy(void *arg)
+{
+  AUDIO_BenchTypeDef *b = (AUDIO_BenchTypeDef *)arg;
+  const jcrev_params_t *p = &b->params;
+  uint32_t i;
+
+  for(i = 0; i < b->n; i++)
+  {
+    b->out[i] = reverb(b->in[i], p->g_comb[0], p->g_comb[1], p->m_comb[1], p->g_comb[2], p->m_comb[2],
+                       p->g_comb[3], p->m_comb[3], p->g_ap[0], p->m_ap[0], p->g_ap[1], p->m_ap[1],
+                       p->g_ap[2], p->m_ap[2]);
+  }
+}
+
+/**
+  * @brief  Times every engine at every codec rate over a fixed noise buffer
+  *         (one channel, one callback worth of frames) and logs the cycles per
+  *         sample and the share of the real-time budget of all the channels.
+  *         Runs before the audio starts: the playback buffer holds the noise.
+  * @param  None
+  * @retval None
+  */
+static void AUDIO_BENCH_Run(void)
+{
+  static const uint32_t rates[] = {BSP_AUDIO_FREQUENCY_8K, BSP_AUDIO_FREQUENCY_16K,
+                                   BSP_AUDIO_FREQUENCY_32K, BSP_AUDIO_FREQUENCY_48K};
+  static const char *const names[] = {"legacy", "sdram", "tiered"};
+  AUDIO_BenchTypeDef bench;
+  int16_t *noise = (int16_t *)outBufferCtl.buff;
+  uint32_t x = 0x12345678;
+  uint32_t i, r, engine;
+
+  for(i = 0; i < REVERB_FRAMES; i++)
+  {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    noise[i] = (int16_t)((int32_t)x >> 17);
+  }
+  bench.inst = &reverb_inst[0];
+  bench.in = noise;
+  bench.out = reverb_chan;
+  bench.n = REVERB_FRAMES;
+
+  LCD_UsrLog("Benchmark: %lu frames, %lu channel(s), %lu MHz\n", (unsigned long)REVERB_FRAMES,
+             (unsigned long)REVERB_CHANNELS, (unsigned long)(SystemCoreClock / 1000000));
+  for(r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+  {
+    for(engine = BENCH_LEGACY; engine <= BENCH_TIERED; engine++)
+    {
+      cycle_stats_t stats;
+      cycle_report_t report;
+      uint32_t stall = 0;
+      uint8_t ret;
+
+      jcrev_params_from_config(&jcrev_config_default, rates[r], &bench.params);
+      if(engine == BENCH_LEGACY)
+      {
+        ret = reverb_init(bench.params.m_comb[0]);
+      }
+      else if(engine == BENCH_SDRAM)
+      {
+        reverb_mem_init(&reverb_mem, (void*)REVERB_SDRAM_ADDRESS, REVERB_SDRAM_SIZE, NULL, 0);
+        ret = jcrev_init(bench.inst, &bench.params, REVERB_BLOCK, &reverb_mem);
+      }
+      else
+      {
+        reverb_mem_init(&reverb_mem, reverb_fast, sizeof(reverb_fast),
+                        (void*)REVERB_SDRAM_ADDRESS, REVERB_SDRAM_SIZE);
+        reverb_mem.copy.start = MEM_DMA_Copy;
+        reverb_mem.copy.wait = MEM_DMA_Wait;
+        ret = jcrev_init_config(bench.inst, &jcrev_config_default, rates[r], REVERB_BLOCK, &reverb_mem);
+      }
+      if(ret != 0)
+      {
+        LCD_UsrLog("  %-6s %2luk: not enough memory\n", names[engine], (unsigned long)(rates[r] / 1000));
+        continue;
+      }
+
+      cycle_stats_reset(&stats);
+      if(engine == BENCH_LEGACY)
+      {
+        AUDIO_BENCH_Legacy(&bench);   /* warm up the caches */
+        cycle_bench_run(&cycle_bench, AUDIO_BENCH_Legacy, &bench, BENCH_REPEATS, &stats);
+        reverb_deinit();
+      }
+      else
+      {
+        AUDIO_BENCH_Jcrev(&bench);
+        MEM_DMA_TakeStallCycles();
+        cycle_bench_run(&cycle_bench, AUDIO_BENCH_Jcrev, &bench, BENCH_REPEATS, &stats);
+        stall = MEM_DMA_TakeStallCycles();
+        reverb_mem_reset(&reverb_mem);
+      }
+
+      cycle_stats_report(&stats, REVERB_FRAMES,
+                         cycle_budget(SystemCoreClock, rates[r], REVERB_FRAMES) / REVERB_CHANNELS, &report);
+      LCD_UsrLog("  %-6s %2luk: %lu.%02lu cyc/smp (max %lu.%02lu), %lu.%02lu%% of the budget\n",
+                 names[engine], (unsigned long)(rates[r] / 1000), X100(report.avg_x100),
+                 X100(report.max_x100), X100(report.load_x100));
+      if(engine == BENCH_TIERED)
+      {
+        /* the part of the cost spent waiting for the prefetches of the comb windows */
+        stall = (uint32_t)((uint64_t)stall * 100 / (BENCH_REPEATS * REVERB_FRAMES));
+        LCD_UsrLog("  %-6s %2luk: %lu.%02lu cyc/smp waiting for the DMA\n", names[engine],
+                   (unsigned long)(rates[r] / 1000), X100(stall));
+      }
+    }
+  }
+  memset(outBufferCtl.buff, 0, AUDIO_OUT_BUFFER_SIZE);
+  SCB_CleanDCache_by_Addr((uint32_t*)outBufferCtl.buff, AUDIO_OUT_BUFFER_SIZE);
+}
+#endif
 
 /**
   * @brief  Display interface touch screen buttons
@@ -318,6 +866,9 @@ static void AUDIO_REC_DisplayButtons(void)
   BSP_LCD_FillRect(TOUCH_STOP_XMIN, TOUCH_STOP_YMIN , /* Stop rectangle */
                    TOUCH_STOP_XMAX - TOUCH_STOP_XMIN,
                    TOUCH_STOP_YMAX - TOUCH_STOP_YMIN);
+  BSP_LCD_DisplayStringAt(TOUCH_VOL_MINUS_XMIN, TOUCH_VOL_MINUS_YMIN + 10, (uint8_t *)"VOL-", LEFT_MODE);
+  BSP_LCD_DisplayStringAt(TOUCH_VOL_PLUS_XMIN, TOUCH_VOL_PLUS_YMIN + 10, (uint8_t *)"VOL+", LEFT_MODE);
+  BSP_LCD_DisplayStringAt(TOUCH_RATE_XMIN, TOUCH_RATE_YMIN + 10, (uint8_t *)"RATE", LEFT_MODE);
   BSP_LCD_SetTextColor(LCD_COLOR_GREEN);
   BSP_LCD_SetFont(&LCD_LOG_TEXT_FONT);
   BSP_LCD_DisplayStringAtLine(15, (uint8_t *)"Use record button to start record, stop to exit");
@@ -21,6 +21,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "stm32f7xx_it.h"
+#include "mem_dma.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -187,6 +188,16 @@ void AUDIO_DFSDMx_DMAx_TOP_RIGHT_IRQHandler(void)
   HAL_DMA_IRQHandler(hAudioInTopRightFilter.hdmaReg);
 }
 
+/**
+  * @brief This function handles DMA2 Stream 2 interrupt request.
+  * @param None
+  * @retval None
+  */
+void MEM_DMA_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_mem);
+}
+
 /**
   * @brief  This function handles PPP interrupt request.
   * @param  None
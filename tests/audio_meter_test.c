@@ -0,0 +1,214 @@
+/**
+ * @file    audio_meter_test.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   aggregation of the audio callback costs by audio_meter
+ *
+ * - audio_meter_add() fills the histogram bucket of 1% of the budget and counts the xruns;
+ * - audio_meter_report() gives the 99th percentile from the histogram, the load and the headroom;
+ * - audio_meter_set_budget() moves the buckets and the xrun threshold and clears the stats;
+ * - audio_meter_reset() is applied by the next audio_meter_add(), and a snapshot taken while a
+ *   writer thread adds and a reader resets is always consistent.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <pthread.h>
+#include <stdio.h>
+
+#include <audio_meter.h>
+
+#define CHECK(cond, ...)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("%s:%d: ", __FILE__, __LINE__);                                                                     \
+            printf(__VA_ARGS__);                                                                                       \
+            printf("\n");                                                                                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+/* 100 cycles per bucket, the measures sit inside their bucket: the reciprocal of the budget is
+   rounded down, so a measure on a bucket edge may land in the bucket below */
+#define TEST_BUDGET 10000
+/* Callbacks of the writer thread: a quarter of the budget, then twice the budget (an xrun) */
+#define TEST_ADDS 2000000
+#define TEST_LOW (TEST_BUDGET / 4 + 50)
+#define TEST_HIGH (TEST_BUDGET * 2)
+
+static uint32_t failures;
+static audio_meter_t meter;
+static volatile int writer_done;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Buckets, xruns and the report of one set of measures
+ */
+static void test_report(void)
+{
+    audio_meter_stats_t s;
+    audio_meter_report_t r;
+
+    audio_meter_init(&meter, TEST_BUDGET);
+    audio_meter_snapshot(&meter, &s);
+    audio_meter_report(&s, meter.budget, &r);
+    CHECK(!r.count && !r.p99 && !r.peak_x100 && !r.headroom_x100, "report without measures");
+
+    /* 99 callbacks at 12.34% and one at 90.50%: the 99th percentile is the upper edge of bucket 12 */
+    for (int i = 0; i < 99; i++)
+        audio_meter_add(&meter, 1234);
+    audio_meter_add(&meter, 9050);
+    audio_meter_snapshot(&meter, &s);
+    CHECK((s.hist[12] == 99) && (s.hist[90] == 1), "buckets 12 and 90 hold %u and %u", s.hist[12], s.hist[90]);
+    audio_meter_report(&s, meter.budget, &r);
+    CHECK(r.count == 100, "count %u instead of 100", r.count);
+    CHECK((r.min == 1234) && (r.max == 9050), "min %u max %u", r.min, r.max);
+    CHECK(r.avg == (99 * 1234 + 9050) / 100, "average %u", r.avg);
+    CHECK(r.p99 == 1300, "p99 %u instead of 1300", r.p99);
+    CHECK(r.p99_x100 == 1300, "p99 %u instead of 13.00%%", r.p99_x100);
+    CHECK(r.load_x100 == 1312, "load %u instead of 13.12%%", r.load_x100);
+    CHECK(!r.xruns && (r.peak_x100 == 9050) && (r.headroom_x100 == 950), "xruns %u peak %u headroom %d", r.xruns,
+          r.peak_x100, r.headroom_x100);
+
+    /* a second callback at 90.50%: the percentile moves to bucket 90, capped by the worst callback */
+    audio_meter_add(&meter, 9050);
+    audio_meter_snapshot(&meter, &s);
+    audio_meter_report(&s, meter.budget, &r);
+    CHECK(r.p99 == 9050, "p99 %u instead of the worst callback 9050", r.p99);
+
+    /* exactly the budget is not an xrun, above it is; far above lands in the last bucket */
+    audio_meter_add(&meter, TEST_BUDGET);
+    audio_meter_add(&meter, 12050);
+    audio_meter_add(&meter, 200000);
+    audio_meter_snapshot(&meter, &s);
+    CHECK(s.xruns == 2, "%u xruns instead of 2", s.xruns);
+    CHECK((s.hist[120] == 1) && (s.hist[AUDIO_METER_BUCKETS - 1] == 1), "buckets 120 and last hold %u and %u",
+          s.hist[120], s.hist[AUDIO_METER_BUCKETS - 1]);
+    audio_meter_report(&s, meter.budget, &r);
+    CHECK(r.xruns == 2, "%u xruns reported instead of 2", r.xruns);
+    CHECK((r.peak_x100 == 200000) && (r.headroom_x100 == -190000), "peak %u headroom %d after an xrun",
+          r.peak_x100, r.headroom_x100);
+}
+
+/**
+ * @brief A new budget clears the stats, moves the buckets and the xrun threshold
+ */
+static void test_set_budget(void)
+{
+    audio_meter_stats_t s;
+    audio_meter_report_t r;
+    uint32_t sum = 0;
+
+    audio_meter_init(&meter, TEST_BUDGET);
+    audio_meter_add(&meter, 12050);
+    audio_meter_set_budget(&meter, 2 * TEST_BUDGET);
+    audio_meter_snapshot(&meter, &s);
+    CHECK(!s.count && !s.xruns && !s.sum && (s.min == UINT32_MAX), "stats kept across a new budget");
+    for (int b = 0; b < AUDIO_METER_BUCKETS; b++)
+        sum += s.hist[b];
+    CHECK(!sum, "%u callbacks left in the histogram", sum);
+
+    audio_meter_add(&meter, 12050);
+    audio_meter_snapshot(&meter, &s);
+    CHECK(!s.xruns && (s.hist[60] == 1), "12050 cycles of 20000: xruns %u, bucket 60 holds %u", s.xruns, s.hist[60]);
+    audio_meter_report(&s, meter.budget, &r);
+    CHECK((r.peak_x100 == 6025) && (r.headroom_x100 == 3975), "peak %u headroom %d", r.peak_x100, r.headroom_x100);
+
+    /* no budget: 1 cycle, every callback is an xrun */
+    audio_meter_set_budget(&meter, 0);
+    CHECK(meter.budget == 1, "budget %u instead of 1", meter.budget);
+    audio_meter_add(&meter, 2);
+    audio_meter_snapshot(&meter, &s);
+    CHECK((s.count == 1) && (s.xruns == 1), "count %u xruns %u without a budget", s.count, s.xruns);
+}
+
+/**
+ * @brief The reset is applied by the writer: the stats stay until its next measure
+ */
+static void test_reset(void)
+{
+    audio_meter_stats_t s;
+
+    audio_meter_init(&meter, TEST_BUDGET);
+    audio_meter_add(&meter, 550);
+    audio_meter_add(&meter, 750);
+    audio_meter_reset(&meter);
+    audio_meter_snapshot(&meter, &s);
+    CHECK(s.count == 2, "count %u before the next measure instead of 2", s.count);
+    audio_meter_add(&meter, 950);
+    audio_meter_snapshot(&meter, &s);
+    CHECK((s.count == 1) && (s.sum == 950) && (s.min == 950) && (s.max == 950) && (s.hist[9] == 1) && !s.hist[5] &&
+              !s.hist[7],
+          "after the reset: count %u sum %llu min %u max %u", s.count, (unsigned long long)s.sum, s.min, s.max);
+    CHECK(!meter.reset, "reset request still pending");
+}
+
+static void *writer(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < TEST_ADDS; i++)
+        audio_meter_add(&meter, (i & 1) ? TEST_HIGH : TEST_LOW);
+    __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief Every snapshot taken while the writer adds and the reader resets holds whole callbacks
+ */
+static void test_concurrent(void)
+{
+    pthread_t thread;
+    uint32_t snapshots = 0;
+    uint32_t bad = 0;
+
+    audio_meter_init(&meter, TEST_BUDGET);
+    writer_done = 0;
+    if (pthread_create(&thread, NULL, writer, NULL))
+    {
+        CHECK(0, "cannot start the writer");
+        return;
+    }
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE))
+    {
+        audio_meter_stats_t s;
+        uint32_t low;
+        uint32_t high;
+        uint32_t others = 0;
+
+        audio_meter_snapshot(&meter, &s);
+        low = s.hist[TEST_LOW * 100 / TEST_BUDGET];
+        high = s.hist[AUDIO_METER_BUCKETS - 1];
+        for (int b = 0; b < AUDIO_METER_BUCKETS; b++)
+            others += s.hist[b];
+        others -= low + high;
+        /* the sum, the extremes and the xruns agree with the histogram */
+        if (others || (s.count != low + high) || (s.xruns != high) ||
+            (s.sum != (uint64_t)low * TEST_LOW + (uint64_t)high * TEST_HIGH) ||
+            (s.min != (low ? TEST_LOW : high ? TEST_HIGH : UINT32_MAX)) ||
+            (s.max != (high ? TEST_HIGH : low ? TEST_LOW : 0)))
+        {
+            if (!bad++)
+                printf("inconsistent snapshot: count %u low %u high %u xruns %u sum %llu min %u max %u\n", s.count,
+                       low, high, s.xruns, (unsigned long long)s.sum, s.min, s.max);
+        }
+        if (!(++snapshots % 8))
+            audio_meter_reset(&meter);
+    }
+    pthread_join(thread, NULL);
+    CHECK(!bad, "%u inconsistent snapshots out of %u", bad, snapshots);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(void)
+{
+    test_report();
+    test_set_budget();
+    test_reset();
+    test_concurrent();
+    printf("%u failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file    cycle_bench_test.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   cycle measures of cycle_bench on a fake counter
+ *
+ * - cycle_bench_init() takes the cheapest of its empty measures as the overhead;
+ * - cycle_bench_elapsed() subtracts across a wrap of the 32-bit counter and never goes below 0;
+ * - cycle_bench_run() and cycle_stats_add() accumulate min, max and sum;
+ * - cycle_budget() and cycle_stats_report() give the cycles per sample and the share of the
+ *   budget with two decimals.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+
+#include <cycle_bench.h>
+
+#define CHECK(cond, ...)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("%s:%d: ", __FILE__, __LINE__);                                                                     \
+            printf(__VA_ARGS__);                                                                                       \
+            printf("\n");                                                                                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+/* Fake counter: every read costs the next entry of cost[], the measured work adds its own cycles */
+typedef struct
+{
+    uint32_t now;
+    const uint32_t *cost;
+    uint32_t n;
+    uint32_t i;
+} fake_counter_t;
+
+/* Work of one call of fake_work() */
+typedef struct
+{
+    fake_counter_t *counter;
+    const uint32_t *cycles;
+    uint32_t i;
+} fake_work_t;
+
+static uint32_t failures;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+static uint32_t fake_read(void *ctx)
+{
+    fake_counter_t *c = ctx;
+    uint32_t t = c->now;
+
+    c->now += c->cost[c->i++ % c->n];
+    return t;
+}
+
+static void fake_work(void *arg)
+{
+    fake_work_t *w = arg;
+
+    w->counter->now += w->cycles[w->i++];
+}
+
+/**
+ * @brief The overhead is the cheapest empty measure, it is taken off every measure
+ */
+static void test_calibration(void)
+{
+    /* odd count: the start reads of the calibration go through every cost */
+    static const uint32_t jitter[] = {9, 12, 7, 11, 8};
+    static const uint32_t steady[] = {5};
+    fake_counter_t c = {0, jitter, 5, 0};
+    cycle_bench_t cb;
+    uint32_t start;
+    uint32_t t;
+
+    cycle_bench_init(&cb, fake_read, &c);
+    CHECK(cb.overhead == 7, "overhead %u instead of 7", cb.overhead);
+
+    c = (fake_counter_t){1000, steady, 1, 0};
+    cycle_bench_init(&cb, fake_read, &c);
+    CHECK(cb.overhead == 5, "overhead %u instead of 5", cb.overhead);
+    start = cycle_bench_start(&cb);
+    t = cycle_bench_elapsed(&cb, start);
+    CHECK(t == 0, "empty measure of %u cycles", t);
+    start = cycle_bench_start(&cb);
+    c.now += 1234;
+    t = cycle_bench_elapsed(&cb, start);
+    CHECK(t == 1234, "work of 1234 cycles measured as %u", t);
+}
+
+/**
+ * @brief A measure across the wrap of the counter, and a measure cheaper than the overhead
+ */
+static void test_wrap(void)
+{
+    static const uint32_t steady[] = {5};
+    fake_counter_t c = {0, steady, 1, 0};
+    cycle_bench_t cb;
+    uint32_t start;
+    uint32_t t;
+
+    cycle_bench_init(&cb, fake_read, &c);
+    for (uint32_t before = 1; before <= 1000; before += 333)
+    {
+        c.now = UINT32_MAX - before;
+        start = cycle_bench_start(&cb);
+        c.now += 2000;
+        t = cycle_bench_elapsed(&cb, start);
+        CHECK(t == 2000, "wrap %u cycles after the start: %u instead of 2000", before, t);
+    }
+
+    /* a read cheaper than the calibration gives 0, not 4 billion cycles */
+    cb.overhead = 50;
+    start = cycle_bench_start(&cb);
+    c.now += 10;
+    t = cycle_bench_elapsed(&cb, start);
+    CHECK(t == 0, "measure below the overhead: %u instead of 0", t);
+}
+
+/**
+ * @brief min, max, sum and count of cycle_bench_run() and cycle_stats_add()
+ */
+static void test_stats(void)
+{
+    static const uint32_t steady[] = {3};
+    static const uint32_t cycles[] = {300, 100, 200, 100};
+    fake_counter_t c = {0xFFFFFF00u, steady, 1, 0};
+    fake_work_t w = {&c, cycles, 0};
+    cycle_bench_t cb;
+    cycle_stats_t stats;
+
+    cycle_stats_reset(&stats);
+    CHECK((stats.count == 0) && (stats.sum == 0) && (stats.max == 0) && (stats.min == UINT32_MAX),
+          "reset: count %u sum %llu min %u max %u", stats.count, (unsigned long long)stats.sum, stats.min, stats.max);
+
+    cycle_bench_init(&cb, fake_read, &c);
+    cycle_bench_run(&cb, fake_work, &w, 4, &stats);
+    CHECK(w.i == 4, "%u calls instead of 4", w.i);
+    CHECK(stats.count == 4, "count %u instead of 4", stats.count);
+    CHECK(stats.sum == 700, "sum %llu instead of 700", (unsigned long long)stats.sum);
+    CHECK(stats.min == 100, "min %u instead of 100", stats.min);
+    CHECK(stats.max == 300, "max %u instead of 300", stats.max);
+
+    /* the sum does not overflow on 32 bits */
+    cycle_stats_reset(&stats);
+    cycle_stats_add(&stats, UINT32_MAX);
+    cycle_stats_add(&stats, UINT32_MAX);
+    cycle_stats_add(&stats, 0);
+    CHECK(stats.sum == 2ull * UINT32_MAX, "sum %llu instead of %llu", (unsigned long long)stats.sum,
+          2ull * UINT32_MAX);
+    CHECK((stats.min == 0) && (stats.max == UINT32_MAX), "min %u max %u", stats.min, stats.max);
+}
+
+/**
+ * @brief Budget and report arithmetic
+ */
+static void test_report(void)
+{
+    cycle_stats_t stats;
+    cycle_report_t r;
+    uint32_t budget;
+
+    /* 216 MHz core, 64 frames at 48 kHz */
+    budget = cycle_budget(216000000, 48000, 64);
+    CHECK(budget == 288000, "budget %u instead of 288000", budget);
+    /* 216e6 * 4096 does not fit in 32 bits */
+    budget = cycle_budget(216000000, 8000, 4096);
+    CHECK(budget == 110592000, "budget %u instead of 110592000", budget);
+    CHECK(cycle_budget(216000000, 0, 64) == 0, "budget without a rate");
+
+    cycle_stats_reset(&stats);
+    cycle_stats_report(&stats, 128, 288000, &r);
+    CHECK(!r.avg_x100 && !r.max_x100 && !r.load_x100 && !r.peak_x100, "report without measures");
+
+    cycle_stats_add(&stats, 144000);
+    cycle_stats_add(&stats, 288000);
+    cycle_stats_add(&stats, 216000);
+    cycle_stats_report(&stats, 128, 288000, &r);
+    CHECK(r.avg_x100 == 168750, "average %u instead of 1687.50 cycles per sample", r.avg_x100);
+    CHECK(r.max_x100 == 225000, "worst %u instead of 2250.00 cycles per sample", r.max_x100);
+    CHECK(r.load_x100 == 7500, "load %u instead of 75.00%%", r.load_x100);
+    CHECK(r.peak_x100 == 10000, "peak %u instead of 100.00%%", r.peak_x100);
+
+    /* 200 cycles per 3 samples: the decimals are truncated */
+    cycle_stats_reset(&stats);
+    cycle_stats_add(&stats, 200);
+    cycle_stats_report(&stats, 3, 0, &r);
+    CHECK((r.avg_x100 == 6666) && (r.max_x100 == 6666), "average %u worst %u instead of 66.66", r.avg_x100,
+          r.max_x100);
+    CHECK(!r.load_x100 && !r.peak_x100, "load without a budget");
+    cycle_stats_report(&stats, 0, 800, &r);
+    CHECK(!r.avg_x100 && !r.max_x100, "cycles per sample without samples");
+    CHECK((r.load_x100 == 2500) && (r.peak_x100 == 2500), "load %u peak %u instead of 25.00%%", r.load_x100,
+          r.peak_x100);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(void)
+{
+    test_calibration();
+    test_wrap();
+    test_stats();
+    test_report();
+    printf("%u failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
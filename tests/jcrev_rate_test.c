@@ -0,0 +1,278 @@
+/**
+ * @file    jcrev_rate_test.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   delays in milliseconds and sample rate switch of jcrev, at every codec rate
+ *
+ * For 8, 16, 32 and 48 kHz:
+ * - jcrev_params_from_config() rounds each delay and moves it up to the first length mutually
+ *   prime with the lengths before it, so the lengths are pairwise coprime;
+ * - jcrev_set_rate() switches an instance in place: same memory, delays of the new rate, tail
+ *   cleared;
+ * - a rate out of range is rejected and leaves the instance (and its tail) as it was;
+ * - jcrev_check_rate() accepts exactly the rates jcrev_set_rate() accepts, without a change.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jcrev.h>
+
+#define TEST_FAST_SIZE (64 * 1024)
+#define TEST_SLOW_SIZE (512 * 1024)
+#define TEST_BLOCK 64
+#define TEST_LINES (JCREV_COMBS + JCREV_ALLPASSES)
+
+#define CHECK(cond, ...)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("%s:%d: ", __FILE__, __LINE__);                                                                     \
+            printf(__VA_ARGS__);                                                                                       \
+            printf("\n");                                                                                              \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+static const uint32_t rates[] = {8000, 16000, 32000, 48000};
+static uint32_t failures;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Delay lines of an instance in the order of jcrev_params_from_config() (combs first)
+ *
+ * @param rv instance
+ * @param k line index
+ * @return delay_line_t* line
+ */
+static delay_line_t *line(jcrev_t *rv, int k)
+{
+    return (k < JCREV_COMBS) ? &rv->comb[k] : &rv->ap[k - JCREV_COMBS];
+}
+
+/**
+ * @brief Feed an instance with noise so every line holds a tail
+ *
+ * @param rv instance
+ */
+static void fill_tail(jcrev_t *rv)
+{
+    int16_t buf[TEST_BLOCK];
+    uint32_t x = 0x12345678u;
+
+    for (uint32_t b = 0; b < JCREV_RATE_MAX / TEST_BLOCK / 2; b++)
+    {
+        for (uint32_t i = 0; i < TEST_BLOCK; i++)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            buf[i] = (int16_t)(x >> 18);
+        }
+        jcrev_process(rv, buf, buf, TEST_BLOCK);
+    }
+}
+
+/**
+ * @brief Check whether every sample of the lines of an instance is 0
+ *
+ * @param rv instance
+ * @return int 1 if silent
+ */
+static int lines_silent(jcrev_t *rv)
+{
+    for (int k = 0; k < TEST_LINES; k++)
+    {
+        delay_line_t *l = line(rv, k);
+
+        for (uint32_t i = 0; i < l->len; i++)
+            if (l->buf[i])
+                return 0;
+        for (uint32_t w = 0; l->window[0] && (w < 2); w++)
+            for (uint32_t i = 0; i < l->block; i++)
+                if (l->window[w][i])
+                    return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Delays of the default configuration at a rate: rounded, moved up to the first length
+ *        coprime with the previous ones, pairwise coprime
+ *
+ * @param rate sample rate
+ */
+static void test_params(uint32_t rate)
+{
+    const jcrev_config_t *c = &jcrev_config_default;
+    jcrev_params_t p;
+    uint32_t m[TEST_LINES];
+
+    jcrev_params_from_config(c, rate, &p);
+    for (int k = 0; k < TEST_LINES; k++)
+    {
+        double ms = (k < JCREV_COMBS) ? c->ms_comb[k] : c->ms_ap[k - JCREV_COMBS];
+        uint32_t rounded = (uint32_t)(ms * rate / 1000.0 + 0.5);
+
+        m[k] = (k < JCREV_COMBS) ? p.m_comb[k] : p.m_ap[k - JCREV_COMBS];
+        CHECK(m[k] >= rounded, "%u Hz: line %d has %u samples, below %u", rate, k, m[k], rounded);
+        /* every length skipped shares a factor with a previous line */
+        for (uint32_t d = rounded; d < m[k]; d++)
+        {
+            int shared = 0;
+
+            for (int j = 0; j < k; j++)
+                shared |= (gcd(d, m[j]) != 1);
+            CHECK(shared, "%u Hz: line %d skipped %u which is coprime with the previous lines", rate, k, d);
+        }
+        for (int j = 0; j < k; j++)
+            CHECK(gcd(m[k], m[j]) == 1, "%u Hz: lines %d and %d (%u, %u) are not coprime", rate, j, k, m[j], m[k]);
+    }
+}
+
+/**
+ * @brief Switch an instance to a rate from every other one, then try rates out of range
+ *
+ * @param rate sample rate
+ * @param fast fast memory
+ * @param slow slow memory
+ */
+static void test_set_rate(uint32_t rate, void *fast, void *slow)
+{
+    for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        static jcrev_t rv;
+        static jcrev_t before;
+        reverb_mem_t mem;
+        jcrev_params_t p;
+        size_t fast_used;
+        size_t slow_used;
+        int32_t *buf[TEST_LINES];
+        int16_t silence[TEST_BLOCK] = {0};
+        int16_t out[TEST_BLOCK];
+        int quiet = 1;
+
+        if (rates[r] == rate)
+            continue;
+        reverb_mem_init(&mem, fast, TEST_FAST_SIZE, slow, TEST_SLOW_SIZE);
+        if (jcrev_init_config(&rv, &jcrev_config_default, rates[r], TEST_BLOCK, &mem))
+        {
+            CHECK(0, "%u Hz: cannot set up an instance", rates[r]);
+            return;
+        }
+        CHECK(rv.comb[0].window[0], "%u Hz: the combs should be streamed from slow memory", rates[r]);
+        fast_used = mem.fast.used;
+        slow_used = mem.slow.used;
+        for (int k = 0; k < TEST_LINES; k++)
+            buf[k] = line(&rv, k)->buf;
+
+        fill_tail(&rv);
+        before = rv;
+        CHECK(jcrev_check_rate(&rv, rate) == 0, "%u to %u Hz: not accepted by the check", rates[r], rate);
+        CHECK(!memcmp(&rv, &before, sizeof(rv)) && !lines_silent(&rv), "%u to %u Hz: the check changed the instance",
+              rates[r], rate);
+        CHECK(jcrev_set_rate(&rv, rate) == 0, "%u to %u Hz: rejected", rates[r], rate);
+        jcrev_params_from_config(&jcrev_config_default, rate, &p);
+        CHECK(rv.rate == rate, "%u to %u Hz: rate %u", rates[r], rate, rv.rate);
+        CHECK((mem.fast.used == fast_used) && (mem.slow.used == slow_used), "%u to %u Hz: memory was allocated",
+              rates[r], rate);
+        for (int k = 0; k < TEST_LINES; k++)
+        {
+            uint32_t m = (k < JCREV_COMBS) ? p.m_comb[k] : p.m_ap[k - JCREV_COMBS];
+
+            CHECK(line(&rv, k)->buf == buf[k], "%u to %u Hz: line %d moved", rates[r], rate, k);
+            CHECK(line(&rv, k)->delay == m, "%u to %u Hz: line %d delay %u instead of %u", rates[r], rate, k,
+                  line(&rv, k)->delay, m);
+        }
+        CHECK(lines_silent(&rv), "%u to %u Hz: the tail was not cleared", rates[r], rate);
+        for (uint32_t b = 0; b < rate / TEST_BLOCK; b++)
+        {
+            jcrev_process(&rv, silence, out, TEST_BLOCK);
+            for (uint32_t i = 0; i < TEST_BLOCK; i++)
+                quiet &= !out[i];
+        }
+        CHECK(quiet, "%u to %u Hz: output after the switch without input", rates[r], rate);
+
+        /* out of range: nothing changes, the tail included */
+        fill_tail(&rv);
+        before = rv;
+        CHECK(jcrev_check_rate(&rv, 0) == 3, "0 Hz accepted by the check");
+        CHECK(jcrev_check_rate(&rv, JCREV_RATE_MAX + 1) == 3, "%u Hz accepted by the check", JCREV_RATE_MAX + 1);
+        CHECK(jcrev_set_rate(&rv, 0) == 3, "0 Hz accepted");
+        CHECK(jcrev_set_rate(&rv, JCREV_RATE_MAX + 1) == 3, "%u Hz accepted", JCREV_RATE_MAX + 1);
+        CHECK(!memcmp(&rv, &before, sizeof(rv)), "%u Hz: a rejected rate changed the instance", rate);
+        CHECK(!lines_silent(&rv), "%u Hz: a rejected rate cleared the tail", rate);
+    }
+}
+
+/**
+ * @brief An instance sized for a lower highest rate rejects the rates above it
+ *
+ * @param rate sample rate
+ * @param fast fast memory
+ * @param slow slow memory
+ */
+static void test_max_rate(uint32_t rate, void *fast, void *slow)
+{
+    static jcrev_t rv;
+    static jcrev_t before;
+    reverb_mem_t mem;
+
+    reverb_mem_init(&mem, fast, TEST_FAST_SIZE, slow, TEST_SLOW_SIZE);
+    CHECK(jcrev_init_config_max(&rv, &jcrev_config_default, rate, rate, TEST_BLOCK, &mem) == 0,
+          "%u Hz: cannot set up an instance sized for %u Hz", rate, rate);
+    for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        fill_tail(&rv);
+        before = rv;
+        CHECK(jcrev_check_rate(&rv, rates[r]) == ((rates[r] <= rate) ? 0 : 3),
+              "sized for %u Hz: the check disagrees on %u Hz", rate, rates[r]);
+        if (rates[r] <= rate)
+        {
+            CHECK(jcrev_set_rate(&rv, rates[r]) == 0, "sized for %u Hz: %u Hz rejected", rate, rates[r]);
+            continue;
+        }
+        CHECK(jcrev_set_rate(&rv, rates[r]) == 3, "sized for %u Hz: %u Hz accepted", rate, rates[r]);
+        CHECK(!memcmp(&rv, &before, sizeof(rv)), "sized for %u Hz: %u Hz changed the instance", rate, rates[r]);
+    }
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(void)
+{
+    void *fast = malloc(TEST_FAST_SIZE);
+    void *slow = malloc(TEST_SLOW_SIZE);
+
+    if (!fast || !slow)
+    {
+        printf("not enough memory\n");
+        return 1;
+    }
+    for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        test_params(rates[r]);
+        test_set_rate(rates[r], fast, slow);
+        test_max_rate(rates[r], fast, slow);
+    }
+    free(fast);
+    free(slow);
+    printf("%u failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
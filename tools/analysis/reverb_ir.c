@@ -0,0 +1,321 @@
+/**
+ * @file    reverb_ir.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   impulse response analysis of an engine or of a wav file
+ *
+ * The response is rendered with the engine and the settings of reverb_render (or read from a wav
+ * file) and measured with ir_analyze(): EDT, T20, T30, C50, C80 and the echo density over time.
+ * The energy decay curve and the echo density can be written as CSV to be plotted.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ir_metrics.h"
+#include "render.h"
+#include "wavfile.h"
+
+#define IR_LENGTH_DEFAULT 3000 /* ms of response rendered */
+#define IR_LENGTH_MAX 60000
+#define IR_RATE_DEFAULT 48000
+#define IR_HOP_MS 1 /* step of the echo density and of the CSV rows */
+#define IR_ARENA_SIZE (16u << 20)
+#define IR_READ_CHUNK 4096
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -i  analyse the response of a wav file instead of rendering one\n"
+            "  -c  channel of the wav file (default 0)\n"
+            "  -e  engine: jcrev, jcrev_tiered, jcrev_er, jcrev_mr2, jcrev_mr4 or legacy (default jcrev)\n"
+            "  -b  frames per block, up to %u (default %u)\n"
+            "  -g  gains of the %u combs, comma separated\n"
+            "  -m  delays of the combs in ms\n"
+            "  -G  gains of the %u allpasses\n"
+            "  -M  delays of the allpasses in ms\n"
+            "  -d  dry gain (default 0)\n"
+            "  -w  wet gain (default 1)\n"
+            "  -v  volume (default 1)\n"
+            "  -r  sample rate, up to %u Hz (default %u)\n"
+            "  -l  length of the rendered response in ms (default %u)\n"
+            "  -s  save the response as a float wav file\n"
+            "  -o  write the energy decay curve and the echo density as CSV (one row per %u ms)\n",
+            name, RENDER_BLOCK_MAX, RENDER_BLOCK_DEFAULT, JCREV_COMBS, JCREV_ALLPASSES, JCREV_RATE_MAX,
+            IR_RATE_DEFAULT, IR_LENGTH_DEFAULT, IR_HOP_MS);
+}
+
+/**
+ * @brief Read one channel of a wav file
+ *
+ * @param path file name
+ * @param channel channel to keep
+ * @param rate sample rate of the file
+ * @param n number of samples
+ * @return float* samples, full scale at 1.0, NULL on error (printed)
+ */
+static float *read_ir(const char *path, uint32_t channel, uint32_t *rate, uint32_t *n)
+{
+    wav_file_t wav;
+    float *buf;
+    float *ir;
+    uint32_t pos = 0;
+    uint32_t got;
+
+    if (wav_open_read(&wav, path))
+    {
+        fprintf(stderr, "%s: not a supported wav file\n", path);
+        return NULL;
+    }
+    if (channel >= wav.channels)
+    {
+        fprintf(stderr, "%s: no channel %u\n", path, channel);
+        wav_close(&wav);
+        return NULL;
+    }
+    buf = malloc((size_t)IR_READ_CHUNK * wav.channels * sizeof(float));
+    ir = malloc((size_t)wav.frames * sizeof(float) + 1);
+    if (!buf || !ir)
+    {
+        fprintf(stderr, "not enough memory\n");
+        free(buf);
+        free(ir);
+        wav_close(&wav);
+        return NULL;
+    }
+    while ((got = wav_read_f32(&wav, buf, IR_READ_CHUNK)) > 0)
+    {
+        for (uint32_t i = 0; i < got; i++)
+            ir[pos + i] = buf[(size_t)i * wav.channels + channel];
+        pos += got;
+    }
+    *rate = wav.rate;
+    *n = pos;
+    free(buf);
+    wav_close(&wav);
+    return ir;
+}
+
+/**
+ * @brief Save the response as a float wav file
+ *
+ * @param path file name
+ * @param ir samples
+ * @param n number of samples
+ * @param rate sample rate
+ * @return uint8_t 0 if success, 1 on I/O error
+ */
+static uint8_t save_ir(const char *path, const float *ir, uint32_t n, uint32_t rate)
+{
+    wav_file_t wav;
+    uint8_t ret;
+
+    if (wav_open_write_format(&wav, path, rate, 1, WAV_FORMAT_FLOAT, 32))
+        return 1;
+    ret = (wav_write_f32(&wav, ir, n) != n);
+    return wav_close(&wav) ? 1 : ret;
+}
+
+/**
+ * @brief Write the energy decay curve and the echo density, one row per hop from the onset
+ *
+ * @param path file name
+ * @param edc_db energy decay curve
+ * @param n number of samples
+ * @param ned echo densities
+ * @param params onset
+ * @param rate sample rate
+ * @param hop samples between two rows
+ * @return uint8_t 0 if success, 1 on I/O error
+ */
+static uint8_t write_csv(const char *path, const float *edc_db, uint32_t n, const float *ned,
+                         const ir_params_t *params, uint32_t rate, uint32_t hop)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+        return 1;
+    fprintf(f, "time_ms,edc_db,echo_density\n");
+    for (uint32_t i = params->onset, j = 0; i < n; i += hop, j++)
+        fprintf(f, "%.3f,%.3f,%.4f\n", (i - params->onset) * 1000.0 / rate, (double)edc_db[i], (double)ned[j]);
+    return fclose(f) ? 1 : 0;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    render_opts_t opts;
+    reverb_arena_t arena;
+    ir_params_t params;
+    const char *in_path = NULL;
+    const char *save_path = NULL;
+    const char *csv_path = NULL;
+    uint32_t channel = 0;
+    uint32_t rate = IR_RATE_DEFAULT;
+    uint32_t n;
+    uint32_t hop;
+    float *ir = NULL;
+    float *edc = NULL;
+    float *ned = NULL;
+    void *mem = NULL;
+    double start;
+    double elapsed;
+    int ret = 1;
+    int opt;
+
+    render_opts_default(&opts);
+    opts.tail_ms = IR_LENGTH_DEFAULT;
+    while ((opt = getopt(argc, argv, "i:c:e:b:g:m:G:M:d:w:v:r:l:s:o:")) != -1)
+    {
+        uint8_t bad = 0;
+
+        switch (opt)
+        {
+        case 'i':
+            in_path = optarg;
+            break;
+        case 'c':
+            channel = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rate = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !rate || (rate > JCREV_RATE_MAX);
+            break;
+        case 'l':
+            bad = render_option(&opts, opt, optarg) || !opts.tail_ms || (opts.tail_ms > IR_LENGTH_MAX);
+            break;
+        case 's':
+            save_path = optarg;
+            break;
+        case 'o':
+            csv_path = optarg;
+            break;
+        case '?':
+            bad = 1;
+            break;
+        default:
+            bad = render_option(&opts, opt, optarg);
+            break;
+        }
+        if (bad)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (in_path)
+    {
+        ir = read_ir(in_path, channel, &rate, &n);
+        if (!ir)
+            return 1;
+    }
+    else
+    {
+        uint8_t err;
+
+        n = (uint32_t)((uint64_t)opts.tail_ms * rate / 1000);
+        ir = malloc((size_t)n * sizeof(float));
+        mem = malloc(IR_ARENA_SIZE);
+        if (!ir || !mem)
+        {
+            fprintf(stderr, "not enough memory\n");
+            goto out;
+        }
+        reverb_arena_init(&arena, mem, IR_ARENA_SIZE);
+        err = render_impulse(&opts, rate, ir, n, &arena);
+        if (err)
+        {
+            fprintf(stderr, "cannot render %s at %u Hz%s\n", render_engine_name(opts.engine), rate,
+                    (err == 1) ? " (not enough memory)" : "");
+            goto out;
+        }
+    }
+    if (!n)
+    {
+        fprintf(stderr, "empty response\n");
+        goto out;
+    }
+
+    hop = IR_HOP_MS * rate / 1000;
+    if (!hop)
+        hop = 1;
+    edc = malloc((size_t)n * sizeof(float));
+    ned = malloc(((size_t)n / hop + 1) * sizeof(float));
+    if (!edc || !ned)
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+
+    start = now_s();
+    ir_analyze(ir, n, rate, hop, edc, ned, &params);
+    elapsed = now_s() - start;
+
+    printf("response: %s, %u Hz, %.3f s, onset %.2f ms\n", in_path ? in_path : render_engine_name(opts.engine),
+           rate, (double)n / rate, params.onset * 1000.0 / rate);
+    printf("EDT  %7.3f s\n", (double)params.edt);
+    printf("T20  %7.3f s\n", (double)params.t20);
+    printf("T30  %7.3f s\n", (double)params.t30);
+    printf("C50  %7.2f dB\n", (double)params.c50);
+    printf("C80  %7.2f dB\n", (double)params.c80);
+    printf("echo density %.3f on average, ", (double)params.ned_mean);
+    if (params.mixing_ms >= 0.0f)
+        printf("reaches 1 after %.0f ms\n", (double)params.mixing_ms);
+    else
+        printf("never reaches 1\n");
+    printf("analysis in %.2f ms\n", elapsed * 1000.0);
+    if (!params.t30)
+        fprintf(stderr, "the response does not decay by 35 dB, a longer one (-l) gives T30\n");
+
+    ret = 0;
+    if (save_path && save_ir(save_path, ir, n, rate))
+    {
+        fprintf(stderr, "cannot write %s\n", save_path);
+        ret = 1;
+    }
+    if (csv_path && write_csv(csv_path, edc, n, ned, &params, rate, hop))
+    {
+        fprintf(stderr, "cannot write %s\n", csv_path);
+        ret = 1;
+    }
+
+out:
+    free(ned);
+    free(edc);
+    free(ir);
+    free(mem);
+    return ret;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file    perf_counters.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   hardware counters of the host (Linux perf_event) and time stamp counter
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* ----- Static function ------------------------------------------------------------------------ */
+#if defined(__linux__)
+/**
+ * @brief Open one counter of the calling thread, user space only (allowed with perf_event_paranoid 2)
+ *
+ * @param type PERF_TYPE_HARDWARE or PERF_TYPE_HW_CACHE
+ * @param config event
+ * @return int file descriptor, -1 if the counter is not available
+ */
+static int open_counter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Open the counters: cycles, instructions, L1 data read misses and last level cache misses
+ *
+ * @param pc counters
+ * @return uint8_t 0 if at least one counter is available
+ */
+uint8_t perf_counters_open(perf_counters_t *pc)
+{
+    uint8_t any = 0;
+
+    memset(pc, 0, sizeof(*pc));
+    for (int k = 0; k < PERF_COUNTERS; k++)
+        pc->fd[k] = -1;
+
+#if defined(__linux__)
+    pc->fd[PERF_CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    pc->fd[PERF_INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    pc->fd[PERF_L1D_MISSES] = open_counter(PERF_TYPE_HW_CACHE,
+                                           PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    pc->fd[PERF_LLC_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+
+    for (int k = 0; k < PERF_COUNTERS; k++)
+        any |= (pc->fd[k] >= 0);
+    return any ? 0 : 1;
+}
+
+/**
+ * @brief Reset and start the counters
+ *
+ * @param pc counters
+ */
+void perf_counters_start(perf_counters_t *pc)
+{
+#if defined(__linux__)
+    for (int k = 0; k < PERF_COUNTERS; k++)
+    {
+        if (pc->fd[k] < 0)
+            continue;
+        ioctl(pc->fd[k], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fd[k], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)pc;
+#endif
+}
+
+/**
+ * @brief Stop the counters and read them
+ *
+ * @param pc counters, value and valid are updated
+ */
+void perf_counters_stop(perf_counters_t *pc)
+{
+    for (int k = 0; k < PERF_COUNTERS; k++)
+    {
+        pc->valid[k] = 0;
+#if defined(__linux__)
+        if (pc->fd[k] < 0)
+            continue;
+        ioctl(pc->fd[k], PERF_EVENT_IOC_DISABLE, 0);
+        pc->valid[k] = (read(pc->fd[k], &pc->value[k], sizeof(pc->value[k])) == sizeof(pc->value[k]));
+#endif
+    }
+}
+
+/**
+ * @brief Close the counters
+ *
+ * @param pc counters
+ */
+void perf_counters_close(perf_counters_t *pc)
+{
+    for (int k = 0; k < PERF_COUNTERS; k++)
+    {
+#if defined(__linux__)
+        if (pc->fd[k] >= 0)
+            close(pc->fd[k]);
+#endif
+        pc->fd[k] = -1;
+    }
+}
+
+/**
+ * @brief Time stamp counter: constant rate reference cycles on x86, the virtual counter on AArch64
+ *
+ * @return uint64_t ticks, 0 if the architecture has none
+ */
+uint64_t perf_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t t;
+
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,31 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+/* Hardware counters read around a measured region */
+enum
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_COUNTERS
+};
+
+/* Group of counters, a counter the kernel refused stays at -1 */
+typedef struct
+{
+    int fd[PERF_COUNTERS];
+    uint64_t value[PERF_COUNTERS];
+    uint8_t valid[PERF_COUNTERS];
+} perf_counters_t;
+
+uint8_t perf_counters_open(perf_counters_t *pc);
+void perf_counters_start(perf_counters_t *pc);
+void perf_counters_stop(perf_counters_t *pc);
+void perf_counters_close(perf_counters_t *pc);
+
+uint64_t perf_tsc(void);
+
+#endif /*PERF_COUNTERS_H*/
@@ -0,0 +1,933 @@
+/**
+ * @file    reverb_bench.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   benchmark of the reverb engines over synthetic inputs, block sizes and channel counts
+ *
+ * Every run processes the same number of samples per channel, block after block, each block going
+ * through every channel like the firmware callback does. The best of the repeats is reported as
+ * ns/sample, samples/s, cycles/sample and, when the kernel allows it, hardware counters.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <biquad.h>
+#include <jcrev.h>
+#include <jcrev_heap.h>
+#include <jcrev_multirate.h>
+#include <reverb.h>
+#include <reverb_port.h>
+#include <reverb_trace.h>
+
+#include "perf_counters.h"
+
+#define BENCH_RATE_DEFAULT 48000
+#define BENCH_CHANNELS_MAX 16
+#define BENCH_BLOCK_MAX 4096
+#define BENCH_LIST_MAX 32
+#define BENCH_ALLOC_PAD 1024 /* alignment slack of the arenas per channel */
+#define BENCH_TAIL_WINDOW 4  /* windows per second of the tail benchmark */
+#define BENCH_TAIL_DECAY 300.0 /* dB/s of the float input of the tail benchmark */
+#define BENCH_EARLY_SEND 0.5f  /* level of the reflections in the network of jcrev_er */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* One configuration being measured */
+typedef struct
+{
+    uint32_t channels;
+    uint32_t block;
+    uint32_t rate;
+    jcrev_params_t params;
+    jcrev_t inst[BENCH_CHANNELS_MAX];
+    early_t early[BENCH_CHANNELS_MAX];
+    jcrev_multirate_t multi[BENCH_CHANNELS_MAX];
+    reverb_mem_t mem;
+    void *fast;
+    void *slow;
+} bench_run_t;
+
+/* Engine or kernel variant */
+typedef struct
+{
+    const char *name;
+    uint8_t (*setup)(bench_run_t *run);
+    void (*reset)(bench_run_t *run);
+    void (*process)(bench_run_t *run, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n);
+    void (*teardown)(bench_run_t *run);
+} bench_engine_t;
+
+/* Synthetic input */
+typedef struct
+{
+    const char *name;
+    void (*fill)(int16_t *buf, uint32_t n, uint32_t ch, uint32_t rate);
+} bench_input_t;
+
+/* Result of one configuration, the best of the repeats */
+typedef struct
+{
+    double ns;
+    uint64_t tsc;
+    perf_counters_t pc;
+    uint32_t checksum;
+} bench_result_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double nanoseconds
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Total length in samples of the delay lines of one jcrev instance
+ *
+ * @param comb add the comb lines
+ * @param ap add the allpass lines
+ * @return size_t samples
+ */
+static size_t jcrev_line_samples(uint8_t comb, uint8_t ap)
+{
+    jcrev_params_t params;
+    size_t total = 0;
+
+    jcrev_params_from_config(&jcrev_config_default, JCREV_RATE_MAX, &params);
+    for (int k = 0; comb && (k < JCREV_COMBS); k++)
+        total += params.m_comb[k];
+    for (int k = 0; ap && (k < JCREV_ALLPASSES); k++)
+        total += params.m_ap[k];
+    return total;
+}
+
+/**
+ * @brief Set up one jcrev instance per channel
+ *
+ * @param run configuration
+ * @param tiered comb lines in the slow tier (memcpy copies), else every line in the fast tier
+ * @param early pattern of early reflections before the network, NULL without
+ * @return uint8_t 0 if success
+ */
+static uint8_t jcrev_setup(bench_run_t *run, uint8_t tiered, const early_config_t *early)
+{
+    /* the reflections line: up to 100 ms at the highest rate and a block, plus the block sum */
+    size_t reflections = early ? (JCREV_RATE_MAX / 10 + 2 * run->block) * sizeof(float) : 0;
+    size_t fast = run->channels * ((jcrev_line_samples(!tiered, 1) + 10 * run->block) * sizeof(int32_t) + reflections +
+                                   BENCH_ALLOC_PAD);
+    size_t slow = tiered ? run->channels * (jcrev_line_samples(1, 0) * sizeof(int32_t) + BENCH_ALLOC_PAD) : 0;
+
+    run->fast = malloc(fast);
+    run->slow = slow ? malloc(slow) : NULL;
+    if (!run->fast || (slow && !run->slow))
+        return 1;
+
+    reverb_mem_init(&run->mem, run->fast, fast, run->slow, slow);
+    for (uint32_t ch = 0; ch < run->channels; ch++)
+    {
+        if (jcrev_init_config(&run->inst[ch], &jcrev_config_default, run->rate, run->block, &run->mem))
+            return 1;
+        if (early && (early_init(&run->early[ch], early, run->rate, JCREV_RATE_MAX, run->block, &run->mem.fast) ||
+                      jcrev_set_early(&run->inst[ch], &run->early[ch], BENCH_EARLY_SEND)))
+            return 1;
+    }
+    return 0;
+}
+
+static uint8_t jcrev_fast_setup(bench_run_t *run)
+{
+    return jcrev_setup(run, 0, NULL);
+}
+
+static uint8_t jcrev_tiered_setup(bench_run_t *run)
+{
+    return jcrev_setup(run, 1, NULL);
+}
+
+static uint8_t jcrev_early_setup(bench_run_t *run)
+{
+    return jcrev_setup(run, 0, &early_config_default);
+}
+
+/**
+ * @brief jcrev with the largest pattern of reflections: EARLY_TAPS_MAX plain taps spread over 4
+ *        to 80 ms, the gains falling with the delay
+ *
+ * @param run configuration
+ * @return uint8_t 0 if success
+ */
+static uint8_t jcrev_early64_setup(bench_run_t *run)
+{
+    early_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.taps = EARLY_TAPS_MAX;
+    for (uint32_t t = 0; t < EARLY_TAPS_MAX; t++)
+    {
+        config.tap[t].ms = 4.0f + 76.0f * t / (EARLY_TAPS_MAX - 1);
+        config.tap[t].gain = 0.2f * (1.0f - 0.75f * t / EARLY_TAPS_MAX);
+    }
+    return jcrev_setup(run, 0, &config);
+}
+
+/**
+ * @brief Set up one multirate jcrev instance per channel, every line in the fast tier
+ *
+ * @param run configuration
+ * @param factor decimation of the network
+ * @return uint8_t 0 if success
+ */
+static uint8_t multirate_setup(bench_run_t *run, uint32_t factor)
+{
+    size_t fast = run->channels * (jcrev_line_samples(1, 1) / factor * sizeof(int32_t) +
+                                   (8 * run->block + 8 * HALFBAND_TAPS) * sizeof(float) + BENCH_ALLOC_PAD);
+
+    run->fast = malloc(fast);
+    if (!run->fast)
+        return 1;
+
+    reverb_mem_init(&run->mem, run->fast, fast, NULL, 0);
+    for (uint32_t ch = 0; ch < run->channels; ch++)
+    {
+        if (jcrev_multirate_init(&run->multi[ch], &jcrev_config_default, run->rate, factor, run->block, &run->mem))
+            return 1;
+    }
+    return 0;
+}
+
+static uint8_t multirate2_setup(bench_run_t *run)
+{
+    return multirate_setup(run, 2);
+}
+
+static uint8_t multirate4_setup(bench_run_t *run)
+{
+    return multirate_setup(run, 4);
+}
+
+static void multirate_reset(bench_run_t *run)
+{
+    for (uint32_t ch = 0; ch < run->channels; ch++)
+        jcrev_multirate_reset(&run->multi[ch]);
+}
+
+static void multirate_process(bench_run_t *run, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    jcrev_multirate_process(&run->multi[ch], in, out, n);
+}
+
+static void jcrev_bench_reset(bench_run_t *run)
+{
+    for (uint32_t ch = 0; ch < run->channels; ch++)
+        jcrev_reset(&run->inst[ch]);
+}
+
+static void jcrev_bench_process(bench_run_t *run, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    jcrev_process(&run->inst[ch], in, out, n);
+}
+
+static void jcrev_teardown(bench_run_t *run)
+{
+    free(run->fast);
+    free(run->slow);
+    run->fast = NULL;
+    run->slow = NULL;
+}
+
+/**
+ * @brief The legacy per-sample engine has a single global state, all the channels share it (the
+ *        cost per sample is the same, the output is not a multichannel reverb)
+ *
+ * @param run configuration
+ * @return uint8_t 0 if success
+ */
+static uint8_t legacy_setup(bench_run_t *run)
+{
+    if (run->params.m_comb[0] > INT16_MAX)
+        return 3;
+    return reverb_init((int)run->params.m_comb[0]);
+}
+
+static void legacy_reset(bench_run_t *run)
+{
+    reverb_deinit();
+    reverb_init((int)run->params.m_comb[0]);
+}
+
+static void legacy_process(bench_run_t *run, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    const jcrev_params_t *p = &run->params;
+
+    (void)ch;
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = reverb(in[i], p->g_comb[0], p->g_comb[1], (int16_t)p->m_comb[1], p->g_comb[2],
+                        (int16_t)p->m_comb[2], p->g_comb[3], (int16_t)p->m_comb[3], p->g_ap[0],
+                        (int16_t)p->m_ap[0], p->g_ap[1], (int16_t)p->m_ap[1], p->g_ap[2], (int16_t)p->m_ap[2]);
+}
+
+static void legacy_teardown(bench_run_t *run)
+{
+    (void)run;
+    reverb_deinit();
+}
+
+static void fill_impulse(int16_t *buf, uint32_t n, uint32_t ch, uint32_t rate)
+{
+    (void)ch;
+    (void)rate;
+    memset(buf, 0, n * sizeof(int16_t));
+    buf[0] = INT16_MAX / 2;
+}
+
+static void fill_noise(int16_t *buf, uint32_t n, uint32_t ch, uint32_t rate)
+{
+    uint32_t x = 0x12345678u + ch;
+
+    (void)rate;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = (int16_t)((int32_t)x >> 17); /* half of the full scale */
+    }
+}
+
+static void fill_sweep(int16_t *buf, uint32_t n, uint32_t ch, uint32_t rate)
+{
+    double f0 = 20.0;
+    double f1 = (rate * 0.45 < 20000.0) ? rate * 0.45 : 20000.0;
+    double t = (double)n / rate;
+    double k = log(f1 / f0);
+
+    (void)ch;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double phase = 2.0 * M_PI * f0 * t / k * (exp((double)i / rate / t * k) - 1.0);
+
+        buf[i] = (int16_t)(16384.0 * sin(phase));
+    }
+}
+
+static const bench_engine_t engines[] = {
+    {"legacy", legacy_setup, legacy_reset, legacy_process, legacy_teardown},
+    {"jcrev", jcrev_fast_setup, jcrev_bench_reset, jcrev_bench_process, jcrev_teardown},
+    {"jcrev_tiered", jcrev_tiered_setup, jcrev_bench_reset, jcrev_bench_process, jcrev_teardown},
+    {"jcrev_er", jcrev_early_setup, jcrev_bench_reset, jcrev_bench_process, jcrev_teardown},
+    {"jcrev_er64", jcrev_early64_setup, jcrev_bench_reset, jcrev_bench_process, jcrev_teardown},
+    {"jcrev_mr2", multirate2_setup, multirate_reset, multirate_process, jcrev_teardown},
+    {"jcrev_mr4", multirate4_setup, multirate_reset, multirate_process, jcrev_teardown},
+};
+
+static const bench_input_t inputs[] = {
+    {"impulse", fill_impulse},
+    {"noise", fill_noise},
+    {"sweep", fill_sweep},
+};
+
+#define ENGINES (sizeof(engines) / sizeof(engines[0]))
+#define INPUTS (sizeof(inputs) / sizeof(inputs[0]))
+
+/**
+ * @brief Parse a comma separated list of numbers
+ *
+ * @param s list
+ * @param list parsed numbers
+ * @param max maximum value
+ * @return uint32_t count, 0 if the list is not valid
+ */
+static uint32_t parse_list(const char *s, uint32_t *list, uint32_t max)
+{
+    uint32_t count = 0;
+
+    while (*s && (count < BENCH_LIST_MAX))
+    {
+        char *end;
+        unsigned long v = strtoul(s, &end, 0);
+
+        if ((end == s) || !v || (v > max) || (*end && (*end != ',')))
+            return 0;
+        list[count++] = (uint32_t)v;
+        s = *end ? end + 1 : end;
+    }
+    return *s ? 0 : count;
+}
+
+/**
+ * @brief Check if a name is selected
+ *
+ * @param names comma separated names, NULL selects all
+ * @param name name
+ * @return int 1 if selected
+ */
+static int selected(const char *names, const char *name)
+{
+    size_t len = strlen(name);
+
+    while (names && *names)
+    {
+        const char *end = strchr(names, ',');
+        size_t n = end ? (size_t)(end - names) : strlen(names);
+
+        if ((n == len) && !strncmp(names, name, len))
+            return 1;
+        names += n + (end ? 1 : 0);
+    }
+    return names ? 0 : 1;
+}
+
+/**
+ * @brief Measure one configuration
+ *
+ * @param engine engine
+ * @param run configuration, set up
+ * @param in input per channel
+ * @param out output per channel
+ * @param n samples per channel
+ * @param repeats number of measures, the fastest is kept
+ * @param pc counters
+ * @param res result
+ */
+static void measure(const bench_engine_t *engine, bench_run_t *run, int16_t **in, int16_t **out, uint32_t n,
+                    uint32_t repeats, perf_counters_t *pc, bench_result_t *res)
+{
+    res->ns = 0;
+    for (uint32_t r = 0; r < repeats; r++)
+    {
+        double t;
+        uint64_t tsc;
+
+        engine->reset(run);
+        perf_counters_start(pc);
+        tsc = perf_tsc();
+        t = now_ns();
+        for (uint32_t off = 0; off < n; off += run->block)
+        {
+            uint32_t len = (n - off < run->block) ? (n - off) : run->block;
+
+            for (uint32_t ch = 0; ch < run->channels; ch++)
+                engine->process(run, ch, &in[ch][off], &out[ch][off], len);
+        }
+        t = now_ns() - t;
+        tsc = perf_tsc() - tsc;
+        perf_counters_stop(pc);
+
+        if (!r || (t < res->ns))
+        {
+            res->ns = t;
+            res->tsc = tsc;
+            res->pc = *pc;
+        }
+    }
+
+    /* FNV-1a of the output, to spot a kernel change which is not only faster */
+    res->checksum = 2166136261u;
+    for (uint32_t ch = 0; ch < run->channels; ch++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            res->checksum = (res->checksum ^ (uint16_t)out[ch][i]) * 16777619u;
+    }
+}
+
+/**
+ * @brief Print a column of the text output, '-' if not valid
+ *
+ * @param f file
+ * @param width column width
+ * @param valid value is valid
+ * @param v value
+ */
+static void text_number(FILE *f, int width, int valid, double v)
+{
+    if (valid)
+        fprintf(f, " %*.2f", width, v);
+    else
+        fprintf(f, " %*s", width, "-");
+}
+
+/**
+ * @brief Print a value of the JSON output, null if not valid
+ *
+ * @param f file
+ * @param name key
+ * @param valid value is valid
+ * @param v value
+ */
+static void json_number(FILE *f, const char *name, int valid, double v)
+{
+    if (valid)
+        fprintf(f, ", \"%s\": %.4f", name, v);
+    else
+        fprintf(f, ", \"%s\": null", name);
+}
+
+/**
+ * @brief Float input of the tail benchmark: a noise burst of 10 ms then its exponential decay,
+ *        like the tail of a float effect upstream, which goes through the subnormal range (below
+ *        -758 dB) to zero a few seconds later
+ *
+ * @param buf samples
+ * @param n number of samples
+ * @param rate sample rate
+ */
+static void fill_tail_f32(float *buf, uint32_t n, uint32_t rate)
+{
+    uint32_t x = 0x12345678u;
+    uint32_t burst = rate / 100;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double t = (i < burst) ? 0.0 : (double)(i - burst) / rate;
+
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = (float)((int32_t)x * (0.5 / 2147483648.0) * pow(10.0, -BENCH_TAIL_DECAY * t / 20.0));
+    }
+}
+
+/**
+ * @brief Cost of the reverb along a long tail, window after window: a noise burst then silence
+ *        (jcrev, jcrev with the silence gate) and a float burst which decays through the
+ *        subnormals (jcrev_f32). Each window is the best of the repeats.
+ *
+ * @param text output
+ * @param rate sample rate
+ * @param block block size
+ * @param seconds length of the tail
+ * @param repeats number of measures
+ * @return int exit status
+ */
+static int tail_bench(FILE *text, uint32_t rate, uint32_t block, double seconds, uint32_t repeats)
+{
+    static const char *const names[] = {"jcrev", "jcrev_gate", "jcrev_f32"};
+    uint32_t n = (uint32_t)(seconds * rate);
+    uint32_t win = rate / BENCH_TAIL_WINDOW;
+    uint32_t windows = (n + win - 1) / win;
+    int16_t *in16 = malloc(n * sizeof(int16_t));
+    int16_t *out16 = malloc(n * sizeof(int16_t));
+    float *inf = malloc(n * sizeof(float));
+    float *outf = malloc(n * sizeof(float));
+    double *ns = malloc(3 * windows * sizeof(double));
+    jcrev_t *rv = jcrev_create(NULL, rate, block);
+    int ret = 1;
+
+    if (!in16 || !out16 || !inf || !outf || !ns || !rv)
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    fill_tail_f32(inf, n, rate);
+    for (uint32_t i = 0; i < n; i++)
+        in16[i] = (int16_t)(inf[i] * 32768.0f);
+
+    for (uint32_t e = 0; e < 3; e++)
+    {
+        jcrev_set_gate(rv, (e == 1) ? 1 : 0, 0);
+        for (uint32_t r = 0; r < repeats; r++)
+        {
+            jcrev_reset(rv);
+            for (uint32_t w = 0; w < windows; w++)
+            {
+                uint32_t off = w * win;
+                uint32_t len = (n - off < win) ? (n - off) : win;
+                double t = now_ns();
+
+                for (uint32_t b = 0; b < len; b += block)
+                {
+                    uint32_t m = (len - b < block) ? (len - b) : block;
+
+                    if (e == 2)
+                        jcrev_process_f32(rv, &inf[off + b], &outf[off + b], m);
+                    else
+                        jcrev_process(rv, &in16[off + b], &out16[off + b], m);
+                }
+                t = (now_ns() - t) / len;
+                if (!r || (t < ns[e * windows + w]))
+                    ns[e * windows + w] = t;
+            }
+        }
+    }
+
+    fprintf(text, "tail of %.1f s at %u Hz, block %u, best of %u, float input decaying %.0f dB/s, FPU flush %s\n",
+            seconds, rate, block, repeats, BENCH_TAIL_DECAY, REVERB_FPU_FLUSH ? "on" : "off (software guard)");
+    fprintf(text, "%8s %11s %11s %11s %10s\n", "t (s)", names[0], names[1], names[2], "f32 input");
+    for (uint32_t w = 0; w < windows; w++)
+    {
+        float level = fabsf(inf[w * win]);
+
+        fprintf(text, "%8.2f %11.2f %11.2f %11.2f %10s\n", (double)w / BENCH_TAIL_WINDOW, ns[w], ns[windows + w],
+                ns[2 * windows + w], !level ? "zero" : ((level < 1.17549435e-38f) ? "subnormal" : "normal"));
+    }
+    fprintf(text, "(ns/sample)\n");
+    ret = 0;
+
+out:
+    jcrev_destroy(rv);
+    free(in16);
+    free(out16);
+    free(inf);
+    free(outf);
+    free(ns);
+    return ret;
+}
+
+/**
+ * @brief Cost of the biquad cascades, float and Q31, from one section up to 'stages' and over
+ *        1, 2 and BIQUAD_LANES interleaved channels of noise: a high-pass, a peak, a high shelf and
+ *        a low-pass, in this order. Each figure is the best of the repeats.
+ *
+ * @param text output
+ * @param rate sample rate
+ * @param block block size in frames
+ * @param seconds audio per channel
+ * @param stages largest number of sections, up to BIQUAD_STAGES_MAX
+ * @param repeats number of measures
+ * @return int exit status
+ */
+static int eq_bench(FILE *text, uint32_t rate, uint32_t block, double seconds, uint32_t stages, uint32_t repeats)
+{
+    static const uint32_t lanes[] = {1, 2, BIQUAD_LANES};
+    uint32_t n = (uint32_t)(seconds * rate);
+    int16_t *in16 = malloc(n * BIQUAD_LANES * sizeof(int16_t));
+    int16_t *out16 = malloc(n * BIQUAD_LANES * sizeof(int16_t));
+    float *inf = malloc(n * BIQUAD_LANES * sizeof(float));
+    float *outf = malloc(n * BIQUAD_LANES * sizeof(float));
+    biquad_coef_t coef[BIQUAD_STAGES_MAX];
+    uint32_t x = 0x12345678u;
+    int ret = 1;
+
+    if (!stages || (stages > BIQUAD_STAGES_MAX) ||
+        (biquad_design(&coef[0], BIQUAD_HIGHPASS, rate, 80.0f, 0.7071f, 0.0f)) ||
+        (biquad_design(&coef[1], BIQUAD_PEAK, rate, 0.02f * rate, 1.0f, 4.0f)) ||
+        (biquad_design(&coef[2], BIQUAD_HIGHSHELF, rate, 0.1f * rate, 0.7071f, -3.0f)) ||
+        (biquad_design(&coef[3], BIQUAD_LOWPASS, rate, 0.4f * rate, 0.7071f, 0.0f)))
+    {
+        fprintf(stderr, "-Q: 1 to %u stages, rate above 200 Hz\n", BIQUAD_STAGES_MAX);
+        goto out;
+    }
+    if (!in16 || !out16 || !inf || !outf)
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    for (uint32_t i = 0; i < n * BIQUAD_LANES; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        in16[i] = (int16_t)(x >> 17);
+        inf[i] = in16[i] / 32768.0f;
+    }
+
+    fprintf(text, "biquad cascades, %u frames at %u Hz, block %u, best of %u\n", n, rate, block, repeats);
+    fprintf(text, "%6s %3s %11s %11s %11s %11s\n", "stages", "ch", "f32", "f32/stage", "q31", "q31/stage");
+    for (uint32_t st = 1; st <= stages; st++)
+    {
+        for (uint32_t c = 0; c < sizeof(lanes) / sizeof(lanes[0]); c++)
+        {
+            static biquad_f32_t bf;
+            static biquad_q31_t bq;
+            double ns[2] = {0.0, 0.0};
+
+            biquad_f32_init(&bf, lanes[c], st);
+            biquad_q31_init(&bq, lanes[c], st);
+            for (uint32_t s = 0; s < st; s++)
+            {
+                biquad_f32_set(&bf, s, BIQUAD_ALL, &coef[s]);
+                biquad_q31_set(&bq, s, BIQUAD_ALL, &coef[s]);
+            }
+            for (uint32_t e = 0; e < 2; e++)
+            {
+                for (uint32_t r = 0; r < repeats; r++)
+                {
+                    double t;
+
+                    biquad_f32_reset(&bf);
+                    biquad_q31_reset(&bq);
+                    t = now_ns();
+                    for (uint32_t b = 0; b < n; b += block)
+                    {
+                        uint32_t m = (n - b < block) ? (n - b) : block;
+                        uint32_t off = b * lanes[c];
+
+                        if (e)
+                            biquad_q31_process(&bq, &in16[off], &out16[off], m);
+                        else
+                            biquad_f32_process(&bf, &inf[off], &outf[off], m);
+                    }
+                    t = (now_ns() - t) / ((double)n * lanes[c]);
+                    if (!r || (t < ns[e]))
+                        ns[e] = t;
+                }
+            }
+            fprintf(text, "%6u %3u %11.2f %11.2f %11.2f %11.2f\n", st, lanes[c], ns[0], ns[0] / st, ns[1],
+                    ns[1] / st);
+        }
+    }
+    fprintf(text, "(ns/sample of one channel)\n");
+    ret = 0;
+
+out:
+    free(in16);
+    free(out16);
+    free(inf);
+    free(outf);
+    return ret;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-e engines] [-i inputs] [-b blocks] [-c channels] [-r rate] [-s seconds]\n"
+            "          [-n repeats] [-j file.json] [-t trace.bin] [-T seconds] [-Q stages]\n"
+            "  -e  engines: legacy,jcrev,jcrev_tiered,jcrev_er,jcrev_er64,jcrev_mr2,jcrev_mr4 (default all)\n"
+            "  -i  inputs: impulse,noise,sweep (default all)\n"
+            "  -b  block sizes, up to %u (default 1,2,4,...,4096)\n"
+            "  -c  channel counts, up to %u (default 1,2,4,8,16)\n"
+            "  -r  sample rate, up to %u (default %u)\n"
+            "  -s  seconds of audio per channel and run (default 1)\n"
+            "  -n  repeats, the fastest is reported (default 3)\n"
+            "  -j  write the results as JSON ('-' for stdout)\n"
+            "  -t  save the trace ring of the legacy kernel (library built with REVERB_TRACE)\n"
+            "  -T  seconds: cost along a reverb tail instead, window by window, for the first\n"
+            "      block size (default 256)\n"
+            "  -Q  stages: cost of the float and Q31 biquad cascades instead, 1 to %u sections over\n"
+            "      1, 2 and %u channels, for the first block size\n",
+            name, BENCH_BLOCK_MAX, BENCH_CHANNELS_MAX, JCREV_RATE_MAX, BENCH_RATE_DEFAULT, BIQUAD_STAGES_MAX,
+            BIQUAD_LANES);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    uint32_t blocks[BENCH_LIST_MAX] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+    uint32_t block_count = 13;
+    uint32_t channels[BENCH_LIST_MAX] = {1, 2, 4, 8, 16};
+    uint32_t channel_count = 5;
+    const char *engine_names = NULL;
+    const char *input_names = NULL;
+    const char *json_name = NULL;
+    const char *trace_name = NULL;
+    uint32_t rate = BENCH_RATE_DEFAULT;
+    uint32_t repeats = 3;
+    double seconds = 1.0;
+    double tail = 0.0;
+    uint32_t tail_block = 256;
+    uint32_t eq_stages = 0;
+    int16_t *in[BENCH_CHANNELS_MAX];
+    int16_t *out[BENCH_CHANNELS_MAX];
+    perf_counters_t pc;
+    uint8_t have_pc;
+    FILE *json = NULL;
+    FILE *text = stdout;
+    uint32_t n;
+    int first = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:i:b:c:r:s:n:j:t:T:Q:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'e':
+            engine_names = optarg;
+            break;
+        case 'i':
+            input_names = optarg;
+            break;
+        case 'b':
+            block_count = parse_list(optarg, blocks, BENCH_BLOCK_MAX);
+            tail_block = blocks[0];
+            break;
+        case 'c':
+            channel_count = parse_list(optarg, channels, BENCH_CHANNELS_MAX);
+            break;
+        case 'r':
+            rate = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'n':
+            repeats = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            json_name = optarg;
+            break;
+        case 't':
+            trace_name = optarg;
+            break;
+        case 'T':
+            tail = atof(optarg);
+            break;
+        case 'Q':
+            eq_stages = (uint32_t)strtoul(optarg, NULL, 0);
+            if (!eq_stages)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    n = (uint32_t)(seconds * rate);
+    if ((optind != argc) || !block_count || !channel_count || !rate || (rate > JCREV_RATE_MAX) || !repeats || !n)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (tail > 0.0)
+        return tail_bench(stdout, rate, tail_block, tail, repeats);
+    if (eq_stages)
+        return eq_bench(stdout, rate, tail_block, seconds, eq_stages, repeats);
+#ifndef REVERB_TRACE
+    if (trace_name)
+    {
+        fprintf(stderr, "-t: the library is built without REVERB_TRACE\n");
+        return 1;
+    }
+#endif
+
+    if (json_name)
+    {
+        json = strcmp(json_name, "-") ? fopen(json_name, "w") : stdout;
+        if (!json)
+        {
+            fprintf(stderr, "cannot create %s\n", json_name);
+            return 1;
+        }
+        if (json == stdout)
+            text = stderr;
+    }
+
+    for (uint32_t ch = 0; ch < BENCH_CHANNELS_MAX; ch++)
+    {
+        in[ch] = malloc(n * sizeof(int16_t));
+        out[ch] = malloc(n * sizeof(int16_t));
+        if (!in[ch] || !out[ch])
+        {
+            fprintf(stderr, "not enough memory\n");
+            return 1;
+        }
+    }
+
+    have_pc = !perf_counters_open(&pc);
+    fprintf(text, "%u samples per channel at %u Hz, best of %u, hardware counters %s\n", n, rate, repeats,
+            have_pc ? "on" : "not available");
+    fprintf(text, "%-13s %-8s %3s %5s %9s %9s %9s %9s %6s %9s %9s\n", "engine", "input", "ch", "block", "ns/smp",
+            "Msmp/s", "cyc/smp", "tsc/smp", "IPC", "L1Dm/ks", "LLCm/ks");
+    if (json)
+        fprintf(json, "{\n  \"rate\": %u,\n  \"samples\": %u,\n  \"repeats\": %u,\n  \"compiler\": \"%s\",\n"
+                      "  \"results\": [",
+                rate, n, repeats, __VERSION__);
+
+    for (uint32_t e = 0; e < ENGINES; e++)
+    {
+        if (!selected(engine_names, engines[e].name))
+            continue;
+        for (uint32_t i = 0; i < INPUTS; i++)
+        {
+            if (!selected(input_names, inputs[i].name))
+                continue;
+            for (uint32_t ch = 0; ch < BENCH_CHANNELS_MAX; ch++)
+                inputs[i].fill(in[ch], n, ch, rate);
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                for (uint32_t b = 0; b < block_count; b++)
+                {
+                    static bench_run_t run;
+                    bench_result_t res;
+                    double samples = (double)n * channels[c];
+                    const uint64_t *v = res.pc.value;
+                    const uint8_t *ok = res.pc.valid;
+
+                    memset(&run, 0, sizeof(run));
+                    run.channels = channels[c];
+                    run.block = blocks[b];
+                    run.rate = rate;
+                    jcrev_params_from_config(&jcrev_config_default, rate, &run.params);
+                    if (engines[e].setup(&run))
+                    {
+                        fprintf(text, "%-13s %-8s %3u %5u not supported\n", engines[e].name, inputs[i].name,
+                                run.channels, run.block);
+                        engines[e].teardown(&run);
+                        continue;
+                    }
+                    measure(&engines[e], &run, in, out, n, repeats, &pc, &res);
+                    engines[e].teardown(&run);
+
+                    fprintf(text, "%-13s %-8s %3u %5u %9.2f %9.2f", engines[e].name, inputs[i].name, run.channels,
+                            run.block, res.ns / samples, samples / res.ns * 1e3);
+                    text_number(text, 9, ok[PERF_CYCLES], v[PERF_CYCLES] / samples);
+                    text_number(text, 9, res.tsc != 0, res.tsc / samples);
+                    text_number(text, 6, ok[PERF_CYCLES] && ok[PERF_INSTRUCTIONS] && v[PERF_CYCLES],
+                                v[PERF_CYCLES] ? (double)v[PERF_INSTRUCTIONS] / v[PERF_CYCLES] : 0.0);
+                    text_number(text, 9, ok[PERF_L1D_MISSES], v[PERF_L1D_MISSES] / samples * 1e3);
+                    text_number(text, 9, ok[PERF_LLC_MISSES], v[PERF_LLC_MISSES] / samples * 1e3);
+                    fprintf(text, "\n");
+
+                    if (!json)
+                        continue;
+                    fprintf(json, "%s\n    {\"engine\": \"%s\", \"input\": \"%s\", \"channels\": %u, \"block\": %u",
+                            first ? "" : ",", engines[e].name, inputs[i].name, run.channels, run.block);
+                    json_number(json, "ns_per_sample", 1, res.ns / samples);
+                    json_number(json, "samples_per_s", 1, samples / res.ns * 1e9);
+                    json_number(json, "cycles_per_sample", ok[PERF_CYCLES], v[PERF_CYCLES] / samples);
+                    json_number(json, "tsc_per_sample", res.tsc != 0, res.tsc / samples);
+                    json_number(json, "ipc", ok[PERF_CYCLES] && ok[PERF_INSTRUCTIONS] && v[PERF_CYCLES],
+                                v[PERF_CYCLES] ? (double)v[PERF_INSTRUCTIONS] / v[PERF_CYCLES] : 0.0);
+                    json_number(json, "l1d_misses_per_ksample", ok[PERF_L1D_MISSES], v[PERF_L1D_MISSES] / samples * 1e3);
+                    json_number(json, "llc_misses_per_ksample", ok[PERF_LLC_MISSES], v[PERF_LLC_MISSES] / samples * 1e3);
+                    fprintf(json, ", \"checksum\": \"%08x\"}", res.checksum);
+                    first = 0;
+                }
+            }
+        }
+    }
+
+    if (json)
+    {
+        fprintf(json, "\n  ]\n}\n");
+        if (json != stdout)
+            fclose(json);
+    }
+#ifdef REVERB_TRACE
+    /* the ring keeps the last events of the last legacy run */
+    if (trace_name && reverb_trace_save(trace_name))
+        fprintf(stderr, "cannot write %s\n", trace_name);
+#endif
+    perf_counters_close(&pc);
+    for (uint32_t ch = 0; ch < BENCH_CHANNELS_MAX; ch++)
+    {
+        free(in[ch]);
+        free(out[ch]);
+    }
+    return 0;
+}
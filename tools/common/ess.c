@@ -0,0 +1,204 @@
+/**
+ * @file    ess.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   exponential sine sweep and its deconvolution into impulse responses
+ *
+ * The sweep x(t) = sin(2·pi·f1·L·(e^(t/L) - 1)), L = T / ln(f2/f1), spends the same time in every
+ * octave. Its inverse filter is the time reversed sweep with a +6 dB per octave gain, so the
+ * convolution of the sweep with it is a band limited impulse. Convolving the recording of a path
+ * gives its linear response and, earlier by L·ln(k), the response of the harmonic k of every
+ * non-linearity. The convolution is an overlap-add over blocks, so recordings of any length are
+ * processed with memory bounded by the transform size (twice the sweep).
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ess.h>
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a sweep
+ *
+ * @param sweep sweep
+ * @param rate sample rate in Hz
+ * @param f1 start frequency in Hz
+ * @param f2 end frequency in Hz, below rate / 2
+ * @param seconds length
+ * @param level peak amplitude, full scale at 1.0
+ * @return uint8_t 0 if success, 3 if an argument is not valid
+ */
+uint8_t ess_setup(ess_sweep_t *sweep, uint32_t rate, float f1, float f2, float seconds, float level)
+{
+    double n = (double)seconds * rate;
+
+    memset(sweep, 0, sizeof(*sweep));
+    if (!rate || !(f1 > 0.0f) || !(f2 > f1) || (f2 >= rate / 2.0f) || (f2 < 4.0f * f1) || (n < rate / 10.0) ||
+        (n > FFT_SIZE_MAX / 2) || !(level > 0.0f) || (level > 1.0f))
+        return 3; // BADARG
+
+    sweep->rate = rate;
+    sweep->f1 = f1;
+    sweep->f2 = f2;
+    sweep->level = level;
+    sweep->n = (uint32_t)n;
+    sweep->L = seconds / log((double)f2 / f1);
+    return 0;
+}
+
+/**
+ * @brief Samples of the sweep
+ *
+ * @param sweep sweep
+ * @param x sweep->n samples
+ */
+void ess_generate(const ess_sweep_t *sweep, float *x)
+{
+    uint32_t fade_in = (uint32_t)(sweep->L * log(2.0) * ESS_FADE_IN * sweep->rate);
+    uint32_t fade_out = (uint32_t)(sweep->L * log(2.0) * ESS_FADE_OUT * sweep->rate);
+
+    for (uint32_t i = 0; i < sweep->n; i++)
+    {
+        double t = (double)i / sweep->rate;
+        double g = sweep->level;
+
+        if (i < fade_in)
+            g *= 0.5 - 0.5 * cos(M_PI * i / fade_in);
+        else if (i >= sweep->n - fade_out)
+            g *= 0.5 - 0.5 * cos(M_PI * (sweep->n - 1 - i) / fade_out);
+        x[i] = (float)(g * sin(2.0 * M_PI * sweep->f1 * sweep->L * (exp(t / sweep->L) - 1.0)));
+    }
+}
+
+/**
+ * @brief Distance of the response of a harmonic before the linear response
+ *
+ * @param sweep sweep
+ * @param k harmonic, 1 for the linear response
+ * @return uint32_t samples
+ */
+uint32_t ess_harmonic_offset(const ess_sweep_t *sweep, uint32_t k)
+{
+    return (uint32_t)lround(sweep->L * log((double)k) * sweep->rate);
+}
+
+/**
+ * @brief Build the inverse filter of a sweep
+ *
+ * @param dc deconvolution, released with ess_deconv_deinit()
+ * @param sweep sweep, kept by reference
+ * @return uint8_t 0 if success, 1 if out of memory
+ */
+uint8_t ess_deconv_init(ess_deconv_t *dc, const ess_sweep_t *sweep)
+{
+    uint32_t m = sweep->n;
+    uint32_t lo;
+    uint32_t hi;
+    double gain = 0.0;
+    float *x;
+
+    memset(dc, 0, sizeof(*dc));
+    dc->sweep = sweep;
+    if (fft_init(&dc->plan, 2 * fft_size(m)))
+        return 1;
+    dc->block = dc->plan.n - m + 1;
+    dc->inv = malloc(dc->plan.n * sizeof(fft_complex_t));
+    dc->work = malloc(dc->plan.n * sizeof(fft_complex_t));
+    dc->tail = calloc(dc->plan.n, sizeof(float));
+    x = malloc(m * sizeof(float));
+    if (!dc->inv || !dc->work || !dc->tail || !x)
+    {
+        free(x);
+        ess_deconv_deinit(dc);
+        return 1;
+    }
+
+    /*
+     * time reversed sweep: the sweep spends a time proportional to 1/f at f, so its gain must grow
+     * with the frequency, its envelope falls by 6 dB per octave as the reversed sweep goes down
+     */
+    ess_generate(sweep, x);
+    for (uint32_t i = 0; i < m; i++)
+    {
+        double t = (double)(m - 1 - i) / sweep->rate;
+
+        dc->inv[i].re = (float)(x[m - 1 - i] * exp((t - (double)(m - 1) / sweep->rate) / sweep->L));
+        dc->inv[i].im = 0.0f;
+    }
+    memset(&dc->inv[m], 0, (dc->plan.n - m) * sizeof(fft_complex_t));
+    fft_forward(&dc->plan, dc->inv);
+
+    /* unit gain in the middle of the band, away from the fades */
+    fft_real(&dc->plan, x, m, dc->work);
+    lo = (uint32_t)(2.0f * sweep->f1 * dc->plan.n / sweep->rate);
+    hi = (uint32_t)(0.5f * sweep->f2 * dc->plan.n / sweep->rate);
+    for (uint32_t k = lo; k < hi; k++)
+    {
+        double re = (double)dc->work[k].re * dc->inv[k].re - (double)dc->work[k].im * dc->inv[k].im;
+        double im = (double)dc->work[k].re * dc->inv[k].im + (double)dc->work[k].im * dc->inv[k].re;
+
+        gain += sqrt(re * re + im * im);
+    }
+    gain = (hi > lo) ? gain / (hi - lo) : 1.0;
+    for (uint32_t k = 0; k < dc->plan.n; k++)
+    {
+        dc->inv[k].re = (float)(dc->inv[k].re / gain);
+        dc->inv[k].im = (float)(dc->inv[k].im / gain);
+    }
+    free(x);
+    return 0;
+}
+
+/**
+ * @brief Deconvolve the next block of the recording
+ *
+ * @param dc deconvolution
+ * @param in samples of the recording (zeros after its end to flush the response)
+ * @param n number of samples, up to dc->block
+ * @param out n samples of the convolution, following the previous block
+ */
+void ess_deconv_block(ess_deconv_t *dc, const float *in, uint32_t n, float *out)
+{
+    uint32_t size = dc->plan.n;
+
+    fft_real(&dc->plan, in, n, dc->work);
+    for (uint32_t k = 0; k < size; k++)
+    {
+        fft_complex_t a = dc->work[k];
+        fft_complex_t b = dc->inv[k];
+
+        dc->work[k].re = a.re * b.re - a.im * b.im;
+        dc->work[k].im = a.re * b.im + a.im * b.re;
+    }
+    fft_inverse(&dc->plan, dc->work);
+
+    /* the first n samples are complete, the rest is added to the next blocks */
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = dc->tail[i] + dc->work[i].re;
+    memmove(dc->tail, &dc->tail[n], (size - n) * sizeof(float));
+    memset(&dc->tail[size - n], 0, n * sizeof(float));
+    for (uint32_t i = n; i < size; i++)
+        dc->tail[i - n] += dc->work[i].re;
+}
+
+/**
+ * @brief Release the inverse filter
+ *
+ * @param dc deconvolution
+ */
+void ess_deconv_deinit(ess_deconv_t *dc)
+{
+    fft_deinit(&dc->plan);
+    free(dc->inv);
+    free(dc->work);
+    free(dc->tail);
+    dc->inv = NULL;
+    dc->work = NULL;
+    dc->tail = NULL;
+}
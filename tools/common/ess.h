@@ -0,0 +1,45 @@
+#ifndef ESS_H
+#define ESS_H
+
+#include <stdint.h>
+
+#include <fft.h>
+
+/* Half Hann fades at both ends of the sweep, in octaves: the band edges of the response are smooth */
+#define ESS_FADE_IN 0.5
+#define ESS_FADE_OUT 0.1
+
+/* Exponential sine sweep from f1 to f2 (Farina) */
+typedef struct
+{
+    uint32_t rate;
+    float f1;    /* Hz */
+    float f2;    /* Hz */
+    float level; /* peak amplitude, full scale at 1.0 */
+    uint32_t n;  /* samples of the sweep */
+    double L;    /* seconds for the frequency to grow by e */
+} ess_sweep_t;
+
+/*
+ * Streaming deconvolution: the recording is convolved block after block with the inverse filter of
+ * the sweep (overlap-add). The linear response starts at output sample sweep->n - 1 and the
+ * harmonic k ess_harmonic_offset() samples before it.
+ */
+typedef struct
+{
+    const ess_sweep_t *sweep;
+    fft_plan_t plan;
+    fft_complex_t *inv;  /* spectrum of the inverse filter, normalized to a unit gain */
+    fft_complex_t *work; /* transform of the current block */
+    float *tail;         /* overlap added to the next blocks */
+    uint32_t block;      /* input samples per transform */
+} ess_deconv_t;
+
+uint8_t ess_setup(ess_sweep_t *sweep, uint32_t rate, float f1, float f2, float seconds, float level);
+void ess_generate(const ess_sweep_t *sweep, float *x);
+uint32_t ess_harmonic_offset(const ess_sweep_t *sweep, uint32_t k);
+uint8_t ess_deconv_init(ess_deconv_t *dc, const ess_sweep_t *sweep);
+void ess_deconv_block(ess_deconv_t *dc, const float *in, uint32_t n, float *out);
+void ess_deconv_deinit(ess_deconv_t *dc);
+
+#endif /*ESS_H*/
@@ -0,0 +1,197 @@
+/**
+ * @file    fft.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   radix-2 complex FFT for the host tools
+ *
+ * Iterative decimation in time over a power of two size. The twiddles (computed in double) and the
+ * bit reversal permutation are tabulated once per size by fft_init(), so a transform does no
+ * trigonometry and no allocation.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fft.h>
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Butterflies of all the stages, the input is already in bit reversed order
+ *
+ * @param plan tables
+ * @param x samples, replaced with the transform
+ * @param sign -1 for the forward transform, 1 for the inverse one
+ */
+static void fft_stages(const fft_plan_t *plan, fft_complex_t *x, float sign)
+{
+    uint32_t n = plan->n;
+
+    for (uint32_t half = 1, stride = n / 2; half < n; half *= 2, stride /= 2)
+    {
+        for (uint32_t start = 0; start < n; start += 2 * half)
+        {
+            fft_complex_t *a = &x[start];
+            fft_complex_t *b = &x[start + half];
+
+            for (uint32_t k = 0; k < half; k++)
+            {
+                fft_complex_t w = plan->twiddle[k * stride];
+                float wi = sign * -w.im;
+                float tr = b[k].re * w.re - b[k].im * wi;
+                float ti = b[k].re * wi + b[k].im * w.re;
+
+                b[k].re = a[k].re - tr;
+                b[k].im = a[k].im - ti;
+                a[k].re += tr;
+                a[k].im += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Put the samples in bit reversed order
+ *
+ * @param plan tables
+ * @param x samples
+ */
+static void fft_permute(const fft_plan_t *plan, fft_complex_t *x)
+{
+    for (uint32_t i = 0; i < plan->n; i++)
+    {
+        uint32_t j = plan->bitrev[i];
+
+        if (j > i)
+        {
+            fft_complex_t t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Smallest transform size which holds n samples
+ *
+ * @param n number of samples
+ * @return uint32_t power of two, 0 if above FFT_SIZE_MAX
+ */
+uint32_t fft_size(uint32_t n)
+{
+    uint32_t size = 1;
+
+    while (size < n)
+    {
+        if (size >= FFT_SIZE_MAX)
+            return 0;
+        size *= 2;
+    }
+    return size;
+}
+
+/**
+ * @brief Build the tables of one transform size
+ *
+ * @param plan tables, released with fft_deinit()
+ * @param n size, a power of two from 2 to FFT_SIZE_MAX
+ * @return uint8_t 0 if success, 1 if out of memory, 3 if n is not valid
+ */
+uint8_t fft_init(fft_plan_t *plan, uint32_t n)
+{
+    memset(plan, 0, sizeof(*plan));
+    if ((n < 2) || (n > FFT_SIZE_MAX) || (n & (n - 1)))
+        return 3; // BADARG
+
+    plan->n = n;
+    while ((1u << plan->log2n) < n)
+        plan->log2n++;
+    plan->twiddle = malloc(n / 2 * sizeof(fft_complex_t));
+    plan->bitrev = malloc(n * sizeof(uint32_t));
+    if (!plan->twiddle || !plan->bitrev)
+    {
+        fft_deinit(plan);
+        return 1;
+    }
+
+    for (uint32_t k = 0; k < n / 2; k++)
+    {
+        double phi = -2.0 * M_PI * k / n;
+
+        plan->twiddle[k].re = (float)cos(phi);
+        plan->twiddle[k].im = (float)sin(phi);
+    }
+    plan->bitrev[0] = 0;
+    for (uint32_t i = 1; i < n; i++)
+        plan->bitrev[i] = (plan->bitrev[i >> 1] >> 1) | ((i & 1) << (plan->log2n - 1));
+    return 0;
+}
+
+/**
+ * @brief Release the tables
+ *
+ * @param plan tables
+ */
+void fft_deinit(fft_plan_t *plan)
+{
+    free(plan->twiddle);
+    free(plan->bitrev);
+    memset(plan, 0, sizeof(*plan));
+}
+
+/**
+ * @brief Forward transform in place, X[k] = sum x[n]·e^(-2·pi·i·k·n/N)
+ *
+ * @param plan tables
+ * @param x plan->n samples, replaced with the spectrum
+ */
+void fft_forward(const fft_plan_t *plan, fft_complex_t *x)
+{
+    fft_permute(plan, x);
+    fft_stages(plan, x, -1.0f);
+}
+
+/**
+ * @brief Inverse transform in place, scaled by 1/N so it undoes fft_forward()
+ *
+ * @param plan tables
+ * @param x plan->n bins, replaced with the samples
+ */
+void fft_inverse(const fft_plan_t *plan, fft_complex_t *x)
+{
+    float scale = 1.0f / plan->n;
+
+    fft_permute(plan, x);
+    fft_stages(plan, x, 1.0f);
+    for (uint32_t i = 0; i < plan->n; i++)
+    {
+        x[i].re *= scale;
+        x[i].im *= scale;
+    }
+}
+
+/**
+ * @brief Forward transform of real samples, zero padded to the plan size
+ *
+ * @param plan tables
+ * @param in samples
+ * @param len number of samples, the first plan->n are used
+ * @param x plan->n bins, the spectrum
+ */
+void fft_real(const fft_plan_t *plan, const float *in, uint32_t len, fft_complex_t *x)
+{
+    if (len > plan->n)
+        len = plan->n;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        x[i].re = in[i];
+        x[i].im = 0.0f;
+    }
+    memset(&x[len], 0, (plan->n - len) * sizeof(fft_complex_t));
+    fft_forward(plan, x);
+}
@@ -0,0 +1,30 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+#define FFT_SIZE_MAX (1u << 26)
+
+typedef struct
+{
+    float re;
+    float im;
+} fft_complex_t;
+
+/* Tables of one transform size, read only once set up so it could be shared by threads */
+typedef struct
+{
+    uint32_t n;
+    uint32_t log2n;
+    fft_complex_t *twiddle; /* e^(-2·pi·i·k/n) for k < n/2 */
+    uint32_t *bitrev;       /* index of every input after the bit reversal */
+} fft_plan_t;
+
+uint32_t fft_size(uint32_t n);
+uint8_t fft_init(fft_plan_t *plan, uint32_t n);
+void fft_deinit(fft_plan_t *plan);
+void fft_forward(const fft_plan_t *plan, fft_complex_t *x);
+void fft_inverse(const fft_plan_t *plan, fft_complex_t *x);
+void fft_real(const fft_plan_t *plan, const float *in, uint32_t len, fft_complex_t *x);
+
+#endif /*FFT_H*/
@@ -0,0 +1,265 @@
+/**
+ * @file    ir_metrics.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   objective measures of an impulse response
+ *
+ * The energy decay curve is the backward (Schroeder) integral of the squared response, computed in
+ * one pass from the end. The decay times are the least squares slope of that curve between two
+ * levels, extrapolated to 60 dB. The echo density is the normalized count of Abel and Huang: the
+ * share of the samples of a window above its standard deviation, divided by the share expected for
+ * Gaussian noise (erfc(1/sqrt(2))), so a diffuse tail gives 1. ir_analyze() gives the parameters
+ * of ISO 3382 (EDT, T20, T30, C50, C80) measured from the onset of the direct sound.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+
+#include <ir_metrics.h>
+
+/* Share of the samples of Gaussian noise above its standard deviation, erfc(1/sqrt(2)) */
+#define IR_NED_GAUSS 0.3173105078629141
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Energy decay curve: energy left after each sample, relative to the total
+ *
+ * @param ir impulse response
+ * @param n number of samples
+ * @param edc_db n levels in dB, 0 at the start, IR_EDC_FLOOR_DB once nothing is left
+ */
+void ir_edc(const float *ir, uint32_t n, float *edc_db)
+{
+    double total = 0.0;
+    double scale;
+
+    for (uint32_t i = n; i-- > 0;)
+    {
+        total += (double)ir[i] * ir[i];
+        edc_db[i] = (float)total;
+    }
+    if (total <= 0.0)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            edc_db[i] = IR_EDC_FLOOR_DB;
+        return;
+    }
+
+    scale = 1.0 / total;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float e = (float)(edc_db[i] * scale);
+
+        edc_db[i] = (e > 0.0f) ? 10.0f * log10f(e) : IR_EDC_FLOOR_DB;
+        if (edc_db[i] < IR_EDC_FLOOR_DB)
+            edc_db[i] = IR_EDC_FLOOR_DB;
+    }
+}
+
+/**
+ * @brief Decay time from the slope of the energy decay curve between two levels, e.g. T30 from
+ *        -5 to -35 dB, EDT from 0 to -10 dB
+ *
+ * @param edc_db energy decay curve, ir_edc()
+ * @param n number of samples
+ * @param rate sample rate in Hz
+ * @param start_db first level of the fit
+ * @param end_db last level of the fit, lower than start_db
+ * @return float seconds to decay by 60 dB, 0 if the curve does not reach end_db
+ */
+float ir_decay_time(const float *edc_db, uint32_t n, uint32_t rate, float start_db, float end_db)
+{
+    uint32_t first = 0;
+    uint32_t last;
+    double st = 0.0, sy = 0.0, stt = 0.0, sty = 0.0;
+    double count;
+    double slope;
+
+    while ((first < n) && (edc_db[first] > start_db))
+        first++;
+    last = first;
+    while ((last < n) && (edc_db[last] > end_db))
+        last++;
+    if ((last >= n) || (last - first < 2))
+        return 0.0f;
+
+    /* fit over the samples (relative to the first one) and convert the slope to dB per second */
+    for (uint32_t i = first; i <= last; i++)
+    {
+        double t = i - first;
+
+        st += t;
+        sy += edc_db[i];
+        stt += t * t;
+        sty += t * edc_db[i];
+    }
+    count = last - first + 1;
+    slope = (count * sty - st * sy) / (count * stt - st * st) * rate;
+    return (slope < 0.0) ? (float)(-60.0 / slope) : 0.0f;
+}
+
+/**
+ * @brief Normalized echo density over time
+ *
+ * @param ir impulse response
+ * @param n number of samples
+ * @param window samples of the window (IR_NED_WINDOW_MS), clipped at both ends of the response
+ * @param hop samples between two windows, the window j is centered on sample j·hop
+ * @param ned (n + hop - 1) / hop densities, about 0 for sparse echoes and 1 for a diffuse tail
+ * @return uint32_t number of densities written
+ */
+uint32_t ir_echo_density(const float *ir, uint32_t n, uint32_t window, uint32_t hop, float *ned)
+{
+    uint32_t count = 0;
+
+    if (!window || !hop)
+        return 0;
+
+    for (uint32_t c = 0; c < n; c += hop)
+    {
+        uint32_t lo = (c > window / 2) ? c - window / 2 : 0;
+        uint32_t hi = (c + window - window / 2 < n) ? c + window - window / 2 : n;
+        double energy = 0.0;
+        float sigma;
+        uint32_t above = 0;
+
+        for (uint32_t i = lo; i < hi; i++)
+            energy += (double)ir[i] * ir[i];
+        sigma = (float)sqrt(energy / (hi - lo));
+        for (uint32_t i = lo; i < hi; i++)
+            above += (fabsf(ir[i]) > sigma);
+        ned[count++] = (float)(above / ((hi - lo) * IR_NED_GAUSS));
+    }
+    return count;
+}
+
+/**
+ * @brief Start of the direct sound
+ *
+ * @param ir impulse response
+ * @param n number of samples
+ * @param level_db level relative to the peak, IR_ONSET_DB
+ * @return uint32_t first sample reaching the level, 0 for a silent response
+ */
+uint32_t ir_onset(const float *ir, uint32_t n, float level_db)
+{
+    float peak = 0.0f;
+    float level;
+
+    for (uint32_t i = 0; i < n; i++)
+        peak = fmaxf(peak, fabsf(ir[i]));
+    level = peak * powf(10.0f, level_db / 20.0f);
+    for (uint32_t i = 0; i < n; i++)
+        if ((peak > 0.0f) && (fabsf(ir[i]) >= level))
+            return i;
+    return 0;
+}
+
+/**
+ * @brief Clarity: energy before a split point over the energy after it
+ *
+ * @param ir impulse response, starting at the direct sound
+ * @param n number of samples
+ * @param split first sample of the late part (50 ms for C50, 80 ms for C80)
+ * @return float dB, clamped to +-100 dB when one part is silent
+ */
+float ir_clarity(const float *ir, uint32_t n, uint32_t split)
+{
+    double early = 0.0;
+    double late = 0.0;
+
+    if (split > n)
+        split = n;
+    for (uint32_t i = 0; i < split; i++)
+        early += (double)ir[i] * ir[i];
+    for (uint32_t i = split; i < n; i++)
+        late += (double)ir[i] * ir[i];
+    if (late <= 0.0)
+        return (early > 0.0) ? 100.0f : 0.0f;
+    if (early <= 0.0)
+        return -100.0f;
+    return (float)(10.0 * log10(early / late));
+}
+
+/**
+ * @brief Measure a response: onset, energy decay curve, decay times, clarity and echo density
+ *
+ * @param ir impulse response
+ * @param n number of samples
+ * @param rate sample rate in Hz
+ * @param hop samples between two echo density windows
+ * @param edc_db n levels, the energy decay curve from the onset (0 dB before it)
+ * @param ned (n + hop - 1) / hop echo densities, window j centered on onset + j·hop
+ * @param params measures
+ */
+void ir_analyze(const float *ir, uint32_t n, uint32_t rate, uint32_t hop, float *edc_db, float *ned,
+                ir_params_t *params)
+{
+    const float *start;
+    uint32_t len;
+    uint32_t points;
+    double sum = 0.0;
+
+    params->onset = ir_onset(ir, n, IR_ONSET_DB);
+    start = ir + params->onset;
+    len = n - params->onset;
+    for (uint32_t i = 0; i < params->onset; i++)
+        edc_db[i] = 0.0f;
+    ir_edc(start, len, edc_db + params->onset);
+
+    params->edt = ir_decay_time(edc_db + params->onset, len, rate, 0.0f, -10.0f);
+    params->t20 = ir_decay_time(edc_db + params->onset, len, rate, -5.0f, -25.0f);
+    params->t30 = ir_decay_time(edc_db + params->onset, len, rate, -5.0f, -35.0f);
+    params->c50 = ir_clarity(start, len, rate / 20);
+    params->c80 = ir_clarity(start, len, rate * 2 / 25);
+
+    points = ir_echo_density(start, len, (uint32_t)(IR_NED_WINDOW_MS * rate / 1000.0f), hop, ned);
+    params->mixing_ms = -1.0f;
+    for (uint32_t j = 0; j < points; j++)
+    {
+        sum += ned[j];
+        if ((params->mixing_ms < 0.0f) && (ned[j] >= 1.0f))
+            params->mixing_ms = (float)j * hop * 1000.0f / rate;
+    }
+    params->ned_mean = points ? (float)(sum / points) : 0.0f;
+}
+
+/**
+ * @brief Spectral flatness of the response: geometric over arithmetic mean of the power spectrum,
+ *        1 for a white response, towards 0 for the peaks of a coloured one
+ *
+ * @param plan transform, the response is zero padded or cut to its size
+ * @param ir impulse response
+ * @param n number of samples
+ * @param work plan->n bins
+ * @param lo_bin first bin of the band
+ * @param hi_bin bin after the band, up to plan->n / 2
+ * @return float flatness from 0 to 1
+ */
+float ir_flatness(const fft_plan_t *plan, const float *ir, uint32_t n, fft_complex_t *work, uint32_t lo_bin,
+                  uint32_t hi_bin)
+{
+    double log_sum = 0.0;
+    double sum = 0.0;
+    uint32_t bins;
+
+    if (hi_bin > plan->n / 2)
+        hi_bin = plan->n / 2;
+    if (lo_bin >= hi_bin)
+        return 0.0f;
+
+    fft_real(plan, ir, n, work);
+    for (uint32_t k = lo_bin; k < hi_bin; k++)
+    {
+        /* the floor keeps log() finite for a band without energy */
+        double p = (double)work[k].re * work[k].re + (double)work[k].im * work[k].im + 1e-30;
+
+        log_sum += log(p);
+        sum += p;
+    }
+    bins = hi_bin - lo_bin;
+    return (float)(exp(log_sum / bins) / (sum / bins));
+}
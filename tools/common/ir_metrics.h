@@ -0,0 +1,40 @@
+#ifndef IR_METRICS_H
+#define IR_METRICS_H
+
+#include <stdint.h>
+
+#include <fft.h>
+
+/* Level given to the silent end of an energy decay curve */
+#define IR_EDC_FLOOR_DB -200.0f
+
+/* Window of the echo density (Abel and Huang: 20 ms) */
+#define IR_NED_WINDOW_MS 20.0f
+
+/* The direct sound starts at the first sample within 20 dB of the peak (ISO 3382) */
+#define IR_ONSET_DB -20.0f
+
+/* Room acoustic parameters of a response, the decay times are 0 when not reached */
+typedef struct
+{
+    uint32_t onset;  /* sample of the direct sound, the times below start from it */
+    float edt;       /* s, fit from 0 to -10 dB */
+    float t20;       /* s, fit from -5 to -25 dB */
+    float t30;       /* s, fit from -5 to -35 dB */
+    float c50;       /* dB, energy of the first 50 ms over the rest */
+    float c80;       /* dB, energy of the first 80 ms over the rest */
+    float ned_mean;  /* echo density averaged after the onset */
+    float mixing_ms; /* ms after the onset at which the echo density first reaches 1, -1 if never */
+} ir_params_t;
+
+void ir_edc(const float *ir, uint32_t n, float *edc_db);
+float ir_decay_time(const float *edc_db, uint32_t n, uint32_t rate, float start_db, float end_db);
+uint32_t ir_echo_density(const float *ir, uint32_t n, uint32_t window, uint32_t hop, float *ned);
+uint32_t ir_onset(const float *ir, uint32_t n, float level_db);
+float ir_clarity(const float *ir, uint32_t n, uint32_t split);
+void ir_analyze(const float *ir, uint32_t n, uint32_t rate, uint32_t hop, float *edc_db, float *ned,
+                ir_params_t *params);
+float ir_flatness(const fft_plan_t *plan, const float *ir, uint32_t n, fft_complex_t *work, uint32_t lo_bin,
+                  uint32_t hi_bin);
+
+#endif /*IR_METRICS_H*/
@@ -0,0 +1,212 @@
+/**
+ * @file    thread_pool.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   work-stealing thread pool for the host tools
+ *
+ * The jobs are spread round robin over one deque per worker. A worker takes its newest job first
+ * and, once its deque is empty, steals the oldest job of the next non-empty deque, so long jobs do
+ * not leave the other threads idle. The jobs are coarse (a file each), a mutex per deque is enough.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread_pool.h>
+
+#define POOL_DEQUE_INIT 16
+
+/* Argument of a worker thread */
+typedef struct
+{
+    thread_pool_t *pool;
+    uint32_t id;
+} pool_worker_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Take the newest job of the own deque
+ *
+ * @param d deque
+ * @return void* job, NULL if empty
+ */
+static void *deque_pop(pool_deque_t *d)
+{
+    void *job = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->tail != d->head)
+        job = d->jobs[--d->tail];
+    pthread_mutex_unlock(&d->lock);
+    return job;
+}
+
+/**
+ * @brief Take the oldest job of another deque
+ *
+ * @param d deque
+ * @return void* job, NULL if empty
+ */
+static void *deque_steal(pool_deque_t *d)
+{
+    void *job = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->tail != d->head)
+        job = d->jobs[d->head++];
+    pthread_mutex_unlock(&d->lock);
+    return job;
+}
+
+/**
+ * @brief Worker thread: runs jobs until every deque is empty
+ *
+ * @param arg pool_worker_t
+ * @return void* NULL
+ */
+static void *pool_worker(void *arg)
+{
+    pool_worker_t *w = (pool_worker_t *)arg;
+    thread_pool_t *pool = w->pool;
+
+    for (;;)
+    {
+        void *job = deque_pop(&pool->deques[w->id]);
+
+        for (uint32_t k = 1; !job && (k < pool->workers); k++)
+            job = deque_steal(&pool->deques[(w->id + k) % pool->workers]);
+        if (!job)
+            break;
+        pool->fn(job, w->id, pool->ctx);
+    }
+    return NULL;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Set up a pool, no thread is started before pool_run()
+ *
+ * @param pool pool
+ * @param workers number of threads, at least 1
+ * @param fn runs one job
+ * @param ctx argument of fn
+ * @return uint8_t 0 if success, 1 if out of memory, 3 if workers is 0
+ */
+uint8_t pool_init(thread_pool_t *pool, uint32_t workers, pool_job_fn_t fn, void *ctx)
+{
+    memset(pool, 0, sizeof(*pool));
+    if (!workers)
+        return 3; // BADARG
+
+    pool->deques = calloc(workers, sizeof(pool_deque_t));
+    if (!pool->deques)
+        return 1;
+    pool->workers = workers;
+    pool->fn = fn;
+    pool->ctx = ctx;
+    for (uint32_t k = 0; k < workers; k++)
+        pthread_mutex_init(&pool->deques[k].lock, NULL);
+    return 0;
+}
+
+/**
+ * @brief Queue a job, also allowed from a running job (a worker leaves once it finds every deque
+ *        empty, so the submitting worker runs it if nobody else does)
+ *
+ * @param pool pool
+ * @param job argument of the job function
+ * @return uint8_t 0 if success, 1 if out of memory
+ */
+uint8_t pool_submit(thread_pool_t *pool, void *job)
+{
+    pool_deque_t *d = &pool->deques[__atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED) % pool->workers];
+    uint8_t ret = 0;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->head && (d->tail == d->cap))
+    {
+        /* reuse the room left by the stolen jobs */
+        memmove(d->jobs, &d->jobs[d->head], (d->tail - d->head) * sizeof(void *));
+        d->tail -= d->head;
+        d->head = 0;
+    }
+    if (d->tail == d->cap)
+    {
+        uint32_t cap = d->cap ? d->cap * 2 : POOL_DEQUE_INIT;
+        void **jobs = realloc(d->jobs, cap * sizeof(void *));
+
+        if (jobs)
+        {
+            d->jobs = jobs;
+            d->cap = cap;
+        }
+    }
+    if (d->tail < d->cap)
+        d->jobs[d->tail++] = job;
+    else
+        ret = 1;
+    pthread_mutex_unlock(&d->lock);
+    return ret;
+}
+
+/**
+ * @brief Run the queued jobs on the workers and wait for all of them
+ *
+ * @param pool pool
+ * @return uint8_t 0 if success, 1 if a thread cannot be started (its jobs are run by the others)
+ */
+uint8_t pool_run(thread_pool_t *pool)
+{
+    pthread_t *threads = calloc(pool->workers, sizeof(pthread_t));
+    pool_worker_t *args = calloc(pool->workers, sizeof(pool_worker_t));
+    uint8_t *started = calloc(pool->workers, 1);
+    uint8_t ret = 0;
+
+    if (!threads || !args || !started)
+    {
+        free(threads);
+        free(args);
+        free(started);
+        return 1;
+    }
+
+    /* the calling thread is worker 0 */
+    for (uint32_t k = 0; k < pool->workers; k++)
+    {
+        args[k].pool = pool;
+        args[k].id = k;
+        if (k && pthread_create(&threads[k], NULL, pool_worker, &args[k]) == 0)
+            started[k] = 1;
+        else if (k)
+            ret = 1;
+    }
+    pool_worker(&args[0]);
+    for (uint32_t k = 1; k < pool->workers; k++)
+        if (started[k])
+            pthread_join(threads[k], NULL);
+
+    free(threads);
+    free(args);
+    free(started);
+    return ret;
+}
+
+/**
+ * @brief Release the deques, the pool must not run
+ *
+ * @param pool pool
+ */
+void pool_deinit(thread_pool_t *pool)
+{
+    for (uint32_t k = 0; k < pool->workers; k++)
+    {
+        pthread_mutex_destroy(&pool->deques[k].lock);
+        free(pool->deques[k].jobs);
+    }
+    free(pool->deques);
+    memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,35 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+/* Runs one job, worker is the index of the calling thread (0 to workers - 1) */
+typedef void (*pool_job_fn_t)(void *job, uint32_t worker, void *ctx);
+
+/* Jobs of one worker: the owner takes the newest one, the thieves the oldest one */
+typedef struct
+{
+    pthread_mutex_t lock;
+    void **jobs;
+    uint32_t head; /* oldest job */
+    uint32_t tail; /* after the newest job */
+    uint32_t cap;
+} pool_deque_t;
+
+/* Work-stealing pool: every worker runs its own jobs and steals from the others once it has none */
+typedef struct
+{
+    uint32_t workers;
+    pool_deque_t *deques;
+    pool_job_fn_t fn;
+    void *ctx;
+    uint32_t next; /* deque of the next submitted job (round robin) */
+} thread_pool_t;
+
+uint8_t pool_init(thread_pool_t *pool, uint32_t workers, pool_job_fn_t fn, void *ctx);
+uint8_t pool_submit(thread_pool_t *pool, void *job);
+uint8_t pool_run(thread_pool_t *pool);
+void pool_deinit(thread_pool_t *pool);
+
+#endif /*THREAD_POOL_H*/
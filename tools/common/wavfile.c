@@ -0,0 +1,514 @@
+/**
+ * @file    wavfile.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   minimal RIFF/WAVE reader and writer for the host tools
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <string.h>
+
+#include <wavfile.h>
+
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+#define WAV_HEADER_SIZE 44
+#define WAV_CHANNELS_MAX 256 /* a frame fits into the conversion buffer */
+#define WAV_CHUNK 4096       /* bytes converted at once */
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Little endian 16-bit value
+ *
+ * @param p bytes
+ * @return uint16_t
+ */
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Little endian 32-bit value
+ *
+ * @param p bytes
+ * @return uint32_t
+ */
+static uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Store a little endian 16-bit value
+ *
+ * @param p bytes
+ * @param v value
+ */
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * @brief Store a little endian 32-bit value
+ *
+ * @param p bytes
+ * @param v value
+ */
+static void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Formats the samples could be converted from and to
+ *
+ * @param format WAV_FORMAT_PCM or WAV_FORMAT_FLOAT
+ * @param bits bits per sample
+ * @return uint8_t 1 if supported
+ */
+static uint8_t format_supported(uint16_t format, uint16_t bits)
+{
+    if (format == WAV_FORMAT_PCM)
+        return (bits == 16) || (bits == 24) || (bits == 32);
+    return (format == WAV_FORMAT_FLOAT) && (bits == 32);
+}
+
+/**
+ * @brief One sample of the file as int16
+ *
+ * @param wav file
+ * @param p little endian sample
+ * @return int16_t sample, integer samples are truncated, float samples rounded and saturated
+ */
+static int16_t sample_get(const wav_file_t *wav, const uint8_t *p)
+{
+    union
+    {
+        uint32_t u;
+        float f;
+    } v;
+    float x;
+
+    /* integer samples: the two most significant bytes */
+    if (wav->format == WAV_FORMAT_PCM)
+        return (int16_t)get16(&p[wav->bits / 8 - 2]);
+
+    v.u = get32(p);
+    x = v.f * 32768.0f;
+    if (!(x > -32768.0f)) /* NaN too */
+        return INT16_MIN;
+    if (x >= 32767.0f)
+        return INT16_MAX;
+    return (int16_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f));
+}
+
+/**
+ * @brief One int16 sample in the format of the file
+ *
+ * @param wav file
+ * @param p little endian sample
+ * @param sample value
+ */
+static void sample_put(const wav_file_t *wav, uint8_t *p, int16_t sample)
+{
+    union
+    {
+        uint32_t u;
+        float f;
+    } v;
+
+    if (wav->format == WAV_FORMAT_PCM)
+    {
+        memset(p, 0, wav->bits / 8 - 2);
+        put16(&p[wav->bits / 8 - 2], (uint16_t)sample);
+        return;
+    }
+    v.f = sample / 32768.0f;
+    put32(p, v.u);
+}
+
+/**
+ * @brief One sample of the file as float
+ *
+ * @param wav file
+ * @param p little endian sample
+ * @return float sample, full scale at 1.0
+ */
+static float sample_get_f32(const wav_file_t *wav, const uint8_t *p)
+{
+    union
+    {
+        uint32_t u;
+        float f;
+    } v;
+
+    if (wav->format == WAV_FORMAT_FLOAT)
+    {
+        v.u = get32(p);
+        return v.f;
+    }
+    if (wav->bits == 16)
+        return (int16_t)get16(p) * (1.0f / 32768.0f);
+    if (wav->bits == 24)
+        return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) *
+               (1.0f / 2147483648.0f);
+    return (int32_t)get32(p) * (1.0f / 2147483648.0f);
+}
+
+/**
+ * @brief One float sample in the format of the file
+ *
+ * @param wav file
+ * @param p little endian sample
+ * @param sample value, full scale at 1.0, rounded and saturated for the integer formats
+ */
+static void sample_put_f32(const wav_file_t *wav, uint8_t *p, float sample)
+{
+    union
+    {
+        uint32_t u;
+        float f;
+    } v;
+    double x;
+    double max;
+
+    if (wav->format == WAV_FORMAT_FLOAT)
+    {
+        v.f = sample;
+        put32(p, v.u);
+        return;
+    }
+    max = (double)(1u << (wav->bits - 2)) * 2.0; /* 2^(bits-1) without overflow for 32 bits */
+    x = sample * max;
+    x = (x >= 0.0) ? x + 0.5 : x - 0.5;
+    if (!(x > -max)) /* NaN too */
+        x = -max;
+    if (x > max - 1.0)
+        x = max - 1.0;
+    v.u = (uint32_t)(int32_t)x;
+    for (uint32_t k = 0; k < wav->bits / 8u; k++)
+        p[k] = (uint8_t)(v.u >> (8 * k));
+}
+
+/**
+ * @brief Write the 44 bytes header at the beginning of the file
+ *
+ * @param wav file opened for writing
+ * @return uint8_t 0 if success
+ */
+static uint8_t write_header(wav_file_t *wav)
+{
+    uint8_t h[WAV_HEADER_SIZE];
+    uint32_t bytes = wav->bits / 8;
+    uint32_t data = wav->frames * wav->channels * bytes;
+
+    memcpy(&h[0], "RIFF", 4);
+    put32(&h[4], data + WAV_HEADER_SIZE - 8);
+    memcpy(&h[8], "WAVEfmt ", 8);
+    put32(&h[16], 16);
+    put16(&h[20], wav->format);
+    put16(&h[22], wav->channels);
+    put32(&h[24], wav->rate);
+    put32(&h[28], wav->rate * wav->channels * bytes);
+    put16(&h[32], (uint16_t)(wav->channels * bytes));
+    put16(&h[34], wav->bits);
+    memcpy(&h[36], "data", 4);
+    put32(&h[40], data);
+
+    if (fseek(wav->f, 0, SEEK_SET) || (fwrite(h, 1, sizeof(h), wav->f) != sizeof(h)))
+        return 1;
+    return fseek(wav->f, 0, SEEK_END) ? 1 : 0;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Open a 16, 24, 32-bit PCM or 32-bit float wav file and move to its first sample. Unknown
+ *        chunks are skipped.
+ *
+ * @param wav file to set up
+ * @param path file name
+ * @return uint8_t 0 success, 1 I/O error, 3 not a wav file of a supported format
+ */
+uint8_t wav_open_read(wav_file_t *wav, const char *path)
+{
+    uint8_t chunk[8];
+    uint8_t fmt[40];
+    uint8_t have_fmt = 0;
+
+    memset(wav, 0, sizeof(*wav));
+    wav->f = fopen(path, "rb");
+    if (!wav->f)
+        return 1;
+    setvbuf(wav->f, NULL, _IOFBF, WAV_IO_BUFFER);
+
+    if ((fread(chunk, 1, 8, wav->f) != 8) || memcmp(chunk, "RIFF", 4) ||
+        (fread(chunk, 1, 4, wav->f) != 4) || memcmp(chunk, "WAVE", 4))
+        goto bad;
+
+    while (fread(chunk, 1, 8, wav->f) == 8)
+    {
+        uint32_t size = get32(&chunk[4]);
+
+        if (!memcmp(chunk, "fmt ", 4))
+        {
+            uint16_t format;
+
+            if ((size < 16) || (size > sizeof(fmt)) || (fread(fmt, 1, size, wav->f) != size))
+                goto bad;
+            format = get16(&fmt[0]);
+            if ((format == WAV_FORMAT_EXTENSIBLE) && (size >= 26))
+                format = get16(&fmt[24]); /* first two bytes of the sub-format GUID */
+            wav->format = format;
+            wav->channels = get16(&fmt[2]);
+            wav->rate = get32(&fmt[4]);
+            wav->bits = get16(&fmt[14]);
+            if (!format_supported(format, wav->bits) || !wav->channels || (wav->channels > WAV_CHANNELS_MAX))
+                goto bad;
+            have_fmt = 1;
+        }
+        else if (!memcmp(chunk, "data", 4))
+        {
+            if (!have_fmt)
+                goto bad;
+            wav->frames = size / (wav->channels * (wav->bits / 8u));
+            wav->left = wav->frames;
+            return 0;
+        }
+        else if (fseek(wav->f, size, SEEK_CUR))
+        {
+            break;
+        }
+        if (size & 1)
+            fseek(wav->f, 1, SEEK_CUR);
+    }
+
+bad:
+    fclose(wav->f);
+    wav->f = NULL;
+    return 3; // BADARG
+}
+
+/**
+ * @brief Create a 16-bit PCM wav file, the sizes in the header are written by wav_close()
+ *
+ * @param wav file to set up
+ * @param path file name
+ * @param rate sample rate in Hz
+ * @param channels interleaved channels of a frame
+ * @return uint8_t 0 success, 1 I/O error
+ */
+uint8_t wav_open_write(wav_file_t *wav, const char *path, uint32_t rate, uint16_t channels)
+{
+    return wav_open_write_format(wav, path, rate, channels, WAV_FORMAT_PCM, 16);
+}
+
+/**
+ * @brief Create a wav file of any supported format, the sizes in the header are written by
+ *        wav_close()
+ *
+ * @param wav file to set up
+ * @param path file name
+ * @param rate sample rate in Hz
+ * @param channels interleaved channels of a frame
+ * @param format WAV_FORMAT_PCM (16, 24 or 32 bits) or WAV_FORMAT_FLOAT (32 bits)
+ * @param bits bits per sample
+ * @return uint8_t 0 success, 1 I/O error, 3 format not supported
+ */
+uint8_t wav_open_write_format(wav_file_t *wav, const char *path, uint32_t rate, uint16_t channels,
+                              uint16_t format, uint16_t bits)
+{
+    memset(wav, 0, sizeof(*wav));
+    if (!format_supported(format, bits) || !channels || (channels > WAV_CHANNELS_MAX))
+        return 3; // BADARG
+    wav->rate = rate;
+    wav->channels = channels;
+    wav->format = format;
+    wav->bits = bits;
+    wav->write = 1;
+    wav->f = fopen(path, "wb");
+    if (!wav->f)
+        return 1;
+    setvbuf(wav->f, NULL, _IOFBF, WAV_IO_BUFFER);
+
+    if (write_header(wav))
+    {
+        fclose(wav->f);
+        wav->f = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read interleaved frames
+ *
+ * @param wav file opened with wav_open_read()
+ * @param buf frames * channels samples
+ * @param frames number of frames
+ * @return uint32_t number of frames read, 0 at the end of the data
+ */
+uint32_t wav_read_i16(wav_file_t *wav, int16_t *buf, uint32_t frames)
+{
+    uint8_t raw[WAV_CHUNK];
+    uint32_t bytes = wav->bits / 8;
+    uint32_t chunk = WAV_CHUNK / (wav->channels * bytes);
+    uint32_t done = 0;
+
+    if (frames > wav->left)
+        frames = wav->left;
+
+    /* 16-bit samples are converted in place */
+    if (bytes == 2)
+    {
+        uint8_t *b = (uint8_t *)buf;
+
+        done = (uint32_t)fread(b, (size_t)wav->channels * 2, frames, wav->f);
+        for (size_t i = 0; i < (size_t)done * wav->channels; i++)
+            buf[i] = (int16_t)get16(&b[i * 2]);
+        wav->left -= done;
+        return done;
+    }
+
+    while (done < frames)
+    {
+        uint32_t n = frames - done;
+        size_t got;
+
+        if (n > chunk)
+            n = chunk;
+        got = fread(raw, (size_t)wav->channels * bytes, n, wav->f);
+        for (size_t i = 0; i < got * wav->channels; i++)
+            buf[(size_t)done * wav->channels + i] = sample_get(wav, &raw[i * bytes]);
+        done += (uint32_t)got;
+        if (got != n)
+            break;
+    }
+    wav->left -= done;
+    return done;
+}
+
+/**
+ * @brief Append interleaved frames
+ *
+ * @param wav file opened with wav_open_write()
+ * @param buf frames * channels samples
+ * @param frames number of frames
+ * @return uint32_t number of frames written
+ */
+uint32_t wav_write_i16(wav_file_t *wav, const int16_t *buf, uint32_t frames)
+{
+    uint8_t b[WAV_CHUNK];
+    uint32_t bytes = wav->bits / 8;
+    uint32_t samples = frames * wav->channels;
+    uint32_t done = 0;
+
+    while (done < samples)
+    {
+        uint32_t n = samples - done;
+
+        if (n > WAV_CHUNK / bytes)
+            n = WAV_CHUNK / bytes;
+        for (uint32_t i = 0; i < n; i++)
+            sample_put(wav, &b[i * bytes], buf[done + i]);
+        if (fwrite(b, bytes, n, wav->f) != n)
+            break;
+        done += n;
+    }
+    wav->frames += done / wav->channels;
+    return done / wav->channels;
+}
+
+/**
+ * @brief Read interleaved frames as float, without the loss of wav_read_i16() for the wide formats
+ *
+ * @param wav file opened with wav_open_read()
+ * @param buf frames * channels samples, full scale at 1.0
+ * @param frames number of frames
+ * @return uint32_t number of frames read, 0 at the end of the data
+ */
+uint32_t wav_read_f32(wav_file_t *wav, float *buf, uint32_t frames)
+{
+    uint8_t raw[WAV_CHUNK];
+    uint32_t bytes = wav->bits / 8;
+    uint32_t chunk = WAV_CHUNK / (wav->channels * bytes);
+    uint32_t done = 0;
+
+    if (frames > wav->left)
+        frames = wav->left;
+
+    while (done < frames)
+    {
+        uint32_t n = frames - done;
+        size_t got;
+
+        if (n > chunk)
+            n = chunk;
+        got = fread(raw, (size_t)wav->channels * bytes, n, wav->f);
+        for (size_t i = 0; i < got * wav->channels; i++)
+            buf[(size_t)done * wav->channels + i] = sample_get_f32(wav, &raw[i * bytes]);
+        done += (uint32_t)got;
+        if (got != n)
+            break;
+    }
+    wav->left -= done;
+    return done;
+}
+
+/**
+ * @brief Append interleaved float frames
+ *
+ * @param wav file opened with wav_open_write()
+ * @param buf frames * channels samples, full scale at 1.0
+ * @param frames number of frames
+ * @return uint32_t number of frames written
+ */
+uint32_t wav_write_f32(wav_file_t *wav, const float *buf, uint32_t frames)
+{
+    uint8_t b[WAV_CHUNK];
+    uint32_t bytes = wav->bits / 8;
+    uint32_t samples = frames * wav->channels;
+    uint32_t done = 0;
+
+    while (done < samples)
+    {
+        uint32_t n = samples - done;
+
+        if (n > WAV_CHUNK / bytes)
+            n = WAV_CHUNK / bytes;
+        for (uint32_t i = 0; i < n; i++)
+            sample_put_f32(wav, &b[i * bytes], buf[done + i]);
+        if (fwrite(b, bytes, n, wav->f) != n)
+            break;
+        done += n;
+    }
+    wav->frames += done / wav->channels;
+    return done / wav->channels;
+}
+
+/**
+ * @brief Close the file, a written file gets its final header
+ *
+ * @param wav file
+ * @return uint8_t 0 success, 1 I/O error
+ */
+uint8_t wav_close(wav_file_t *wav)
+{
+    uint8_t ret = 0;
+
+    if (!wav->f)
+        return 0;
+    if (wav->write)
+        ret = write_header(wav);
+    if (fclose(wav->f))
+        ret = 1;
+    wav->f = NULL;
+    return ret;
+}
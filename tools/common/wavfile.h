@@ -0,0 +1,40 @@
+#ifndef WAVFILE_H
+#define WAVFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define WAV_FORMAT_PCM 0x0001   /* 16, 24 or 32-bit integer samples */
+#define WAV_FORMAT_FLOAT 0x0003 /* 32-bit float samples, full scale at 1.0 */
+
+/* Size of the stdio buffer of a file, the samples are read and written in large sequential blocks */
+#define WAV_IO_BUFFER (1024 * 1024)
+
+/*
+ * RIFF/WAVE file opened either for reading or for writing. The samples are exchanged as int16
+ * whatever the format of the file: wider samples are truncated when read and widened when written.
+ * The _f32 functions exchange float samples (full scale at 1.0) without that loss.
+ */
+typedef struct
+{
+    FILE *f;
+    uint32_t rate;     /* sample rate in Hz */
+    uint16_t channels; /* interleaved channels of a frame */
+    uint16_t format;   /* WAV_FORMAT_PCM or WAV_FORMAT_FLOAT */
+    uint16_t bits;     /* bits per sample */
+    uint32_t frames;   /* frames in the file (read) or written so far (write) */
+    uint32_t left;     /* frames still to be read */
+    uint8_t write;     /* opened with wav_open_write() */
+} wav_file_t;
+
+uint8_t wav_open_read(wav_file_t *wav, const char *path);
+uint8_t wav_open_write(wav_file_t *wav, const char *path, uint32_t rate, uint16_t channels);
+uint8_t wav_open_write_format(wav_file_t *wav, const char *path, uint32_t rate, uint16_t channels,
+                              uint16_t format, uint16_t bits);
+uint32_t wav_read_i16(wav_file_t *wav, int16_t *buf, uint32_t frames);
+uint32_t wav_write_i16(wav_file_t *wav, const int16_t *buf, uint32_t frames);
+uint32_t wav_read_f32(wav_file_t *wav, float *buf, uint32_t frames);
+uint32_t wav_write_f32(wav_file_t *wav, const float *buf, uint32_t frames);
+uint8_t wav_close(wav_file_t *wav);
+
+#endif /*WAVFILE_H*/
@@ -0,0 +1,420 @@
+/**
+ * @file    reverb_ess.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   impulse response of any audio path measured with an exponential sine sweep
+ *
+ * The tool writes a sweep (-g) and deconvolves the recording of that sweep after it went through a
+ * path: an engine (reverb_render), the firmware loop on the virtual board (reverb_board_sim) or a
+ * real playback and recording. Both steps take the same sweep options. The result is the linear
+ * impulse response, from the start of the sweep so the latency of the path is kept, and the
+ * responses of the first harmonics with their level against the linear one.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ess.h"
+#include "wavfile.h"
+
+#define ESS_RATE_DEFAULT 48000
+#define ESS_F1_DEFAULT 20.0f
+#define ESS_F2_DEFAULT 20000.0f /* lowered to 0.45 of the rate when above */
+#define ESS_SECONDS_DEFAULT 10.0f
+#define ESS_LEVEL_DEFAULT -6.0f  /* dBFS */
+#define ESS_SILENCE_DEFAULT 5000 /* ms after the sweep, for the tail of the path */
+#define ESS_LENGTH_DEFAULT 3000  /* ms of linear response */
+#define ESS_HARMONICS_DEFAULT 5
+#define ESS_HARMONICS_MAX 16
+#define ESS_CHUNK 4096
+
+/* Command line */
+typedef struct
+{
+    uint32_t rate;
+    float f1;
+    float f2;
+    float seconds;
+    float level_db;
+    uint32_t silence_ms;
+    uint32_t length_ms;
+    uint32_t channel;
+    uint32_t harmonics;
+    const char *harm_path;
+} ess_opts_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [sweep options] -g sweep.wav\n"
+            "       %s [sweep options] [options] recorded.wav ir.wav\n"
+            "sweep options, the same for both steps:\n"
+            "  -f  frequency range in Hz, f1:f2 (default %.0f:%.0f, at most 0.45 of the rate)\n"
+            "  -T  length of the sweep in s (default %.0f)\n"
+            "  -a  level in dBFS (default %.0f)\n"
+            "  -r  sample rate of the sweep file (default %u, the recording gives it when deconvolving)\n"
+            "  -S  silence after the sweep in ms (default %u)\n"
+            "options:\n"
+            "  -c  channel of the recording (default 0)\n"
+            "  -l  length of the linear response in ms (default %u)\n"
+            "  -k  harmonics measured, up to %u (default %u)\n"
+            "  -H  write the harmonic responses, one channel each from the 2nd, to a wav file\n",
+            name, name, (double)ESS_F1_DEFAULT, (double)ESS_F2_DEFAULT, (double)ESS_SECONDS_DEFAULT,
+            (double)ESS_LEVEL_DEFAULT, ESS_RATE_DEFAULT, ESS_SILENCE_DEFAULT, ESS_LENGTH_DEFAULT, ESS_HARMONICS_MAX,
+            ESS_HARMONICS_DEFAULT);
+}
+
+/**
+ * @brief Set up the sweep of the options at a rate
+ *
+ * @param opts options
+ * @param rate sample rate
+ * @param sweep sweep
+ * @return uint8_t 0 if success, 3 if the options are not valid at that rate (printed)
+ */
+static uint8_t sweep_setup(const ess_opts_t *opts, uint32_t rate, ess_sweep_t *sweep)
+{
+    float f2 = opts->f2;
+
+    if (f2 > 0.45f * rate)
+        f2 = 0.45f * rate;
+    if (ess_setup(sweep, rate, opts->f1, f2, opts->seconds, powf(10.0f, opts->level_db / 20.0f)))
+    {
+        fprintf(stderr, "sweep %.0f-%.0f Hz of %.1f s at %.1f dBFS is not valid at %u Hz\n", (double)opts->f1,
+                (double)f2, (double)opts->seconds, (double)opts->level_db, rate);
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief Write the sweep followed by the silence
+ *
+ * @param opts options
+ * @param path file name
+ * @return int exit code
+ */
+static int generate(const ess_opts_t *opts, const char *path)
+{
+    ess_sweep_t sweep;
+    wav_file_t wav;
+    float *x;
+    uint32_t silence = (uint32_t)((uint64_t)opts->silence_ms * opts->rate / 1000);
+    uint8_t err;
+
+    if (sweep_setup(opts, opts->rate, &sweep))
+        return 1;
+    x = calloc((size_t)sweep.n + silence, sizeof(float));
+    if (!x)
+    {
+        fprintf(stderr, "not enough memory\n");
+        return 1;
+    }
+    ess_generate(&sweep, x);
+    err = wav_open_write_format(&wav, path, opts->rate, 1, WAV_FORMAT_FLOAT, 32);
+    if (!err)
+    {
+        err = (wav_write_f32(&wav, x, sweep.n + silence) != sweep.n + silence);
+        err |= wav_close(&wav);
+    }
+    free(x);
+    if (err)
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(stderr, "sweep %.0f-%.0f Hz, %.1f s at %.1f dBFS and %u ms of silence, %u Hz\n", (double)sweep.f1,
+            (double)sweep.f2, (double)opts->seconds, (double)opts->level_db, opts->silence_ms, opts->rate);
+    return 0;
+}
+
+/**
+ * @brief Energy of a part of the response
+ *
+ * @param x samples
+ * @param n number of samples
+ * @return double sum of the squares
+ */
+static double energy(const float *x, uint32_t n)
+{
+    double e = 0.0;
+
+    for (uint32_t i = 0; i < n; i++)
+        e += (double)x[i] * x[i];
+    return e;
+}
+
+/**
+ * @brief Deconvolve a recording: the convolution is streamed block after block and only the part
+ *        holding the linear and harmonic responses is kept
+ *
+ * @param opts options
+ * @param in_path recording
+ * @param out_path linear response
+ * @return int exit code
+ */
+static int deconvolve(const ess_opts_t *opts, const char *in_path, const char *out_path)
+{
+    ess_sweep_t sweep;
+    ess_deconv_t dc;
+    wav_file_t in;
+    wav_file_t out;
+    float *frames = NULL;
+    float *block = NULL;
+    float *conv = NULL;
+    float *region = NULL;
+    float *harm = NULL;
+    uint64_t lag;
+    uint64_t first;
+    uint64_t end;
+    uint64_t pos = 0;
+    uint32_t length;
+    uint32_t span[ESS_HARMONICS_MAX + 1];
+    double start = now_s();
+    double wall;
+    int ret = 1;
+
+    if (wav_open_read(&in, in_path))
+    {
+        fprintf(stderr, "%s: not a supported wav file\n", in_path);
+        return 1;
+    }
+    if (opts->channel >= in.channels)
+    {
+        fprintf(stderr, "%s: no channel %u\n", in_path, opts->channel);
+        wav_close(&in);
+        return 1;
+    }
+    if (sweep_setup(opts, in.rate, &sweep))
+    {
+        wav_close(&in);
+        return 1;
+    }
+    if (ess_deconv_init(&dc, &sweep))
+    {
+        fprintf(stderr, "not enough memory\n");
+        wav_close(&in);
+        return 1;
+    }
+
+    /* the linear response starts at lag, the harmonic k at lag - offset(k) */
+    length = (uint32_t)((uint64_t)opts->length_ms * in.rate / 1000);
+    lag = sweep.n - 1;
+    if (ess_harmonic_offset(&sweep, opts->harmonics + 1) > lag)
+    {
+        fprintf(stderr, "the sweep is too short for %u harmonics\n", opts->harmonics);
+        goto out;
+    }
+    first = lag - ess_harmonic_offset(&sweep, opts->harmonics);
+    end = lag + length;
+    for (uint32_t k = 2; k <= opts->harmonics; k++)
+    {
+        /* up to the next harmonic, never longer than the linear response */
+        span[k] = ess_harmonic_offset(&sweep, k + 1) - ess_harmonic_offset(&sweep, k);
+        if (span[k] > length)
+            span[k] = length;
+    }
+
+    frames = malloc((size_t)ESS_CHUNK * in.channels * sizeof(float));
+    block = malloc(dc.block * sizeof(float));
+    conv = malloc(dc.block * sizeof(float));
+    region = calloc(end - first, sizeof(float));
+    harm = calloc((size_t)length * (opts->harmonics > 1 ? opts->harmonics - 1 : 1), sizeof(float));
+    if (!frames || !block || !conv || !region || !harm)
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+
+    while (pos < end)
+    {
+        uint32_t n = 0;
+
+        /* one block of the channel, zeros once the recording is over */
+        while (n < dc.block)
+        {
+            uint32_t want = (dc.block - n < ESS_CHUNK) ? dc.block - n : ESS_CHUNK;
+            uint32_t got = wav_read_f32(&in, frames, want);
+
+            for (uint32_t i = 0; i < got; i++)
+                block[n + i] = frames[(size_t)i * in.channels + opts->channel];
+            n += got;
+            if (got < want)
+                break;
+        }
+        memset(&block[n], 0, (dc.block - n) * sizeof(float));
+
+        ess_deconv_block(&dc, block, dc.block, conv);
+        for (uint32_t i = 0; i < dc.block; i++)
+        {
+            if ((pos + i >= first) && (pos + i < end))
+                region[pos + i - first] = conv[i];
+        }
+        pos += dc.block;
+    }
+    wall = now_s() - start;
+
+    if (wav_open_write_format(&out, out_path, in.rate, 1, WAV_FORMAT_FLOAT, 32))
+    {
+        fprintf(stderr, "cannot create %s\n", out_path);
+        goto out;
+    }
+    ret = (wav_write_f32(&out, &region[lag - first], length) != length);
+    if (wav_close(&out) || ret)
+    {
+        fprintf(stderr, "cannot write %s\n", out_path);
+        ret = 1;
+        goto out;
+    }
+
+    {
+        const float *lin = &region[lag - first];
+        uint32_t peak = 0;
+
+        for (uint32_t i = 1; i < length; i++)
+            if (fabsf(lin[i]) > fabsf(lin[peak]))
+                peak = i;
+        printf("sweep %.0f-%.0f Hz, %.1f s at %u Hz, recording of %.1f s\n", (double)sweep.f1, (double)sweep.f2,
+               sweep.n / (double)in.rate, in.rate, in.frames / (double)in.rate);
+        printf("linear response: peak %.2f dB at %.2f ms (latency of the path), %u ms in %s\n",
+               20.0 * log10(fabs(lin[peak]) + 1e-30), peak * 1000.0 / in.rate, opts->length_ms, out_path);
+
+        for (uint32_t k = 2; k <= opts->harmonics; k++)
+        {
+            const float *h = &region[lag - ess_harmonic_offset(&sweep, k) - first];
+            double e = energy(h, span[k]);
+            double linear = energy(lin, span[k]);
+
+            printf("harmonic %2u: %7.1f dB (%.0f ms window)\n", k,
+                   (linear > 0.0 && e > 0.0) ? 10.0 * log10(e / linear) : -INFINITY, span[k] * 1000.0 / in.rate);
+            for (uint32_t i = 0; i < span[k]; i++)
+                harm[(size_t)i * (opts->harmonics - 1) + (k - 2)] = h[i];
+        }
+    }
+    printf("deconvolution in %.2f s (x%.0f real time)\n", wall, (wall > 0.0) ? pos / (double)in.rate / wall : 0.0);
+
+    if (opts->harm_path && (opts->harmonics > 1))
+    {
+        uint8_t err = wav_open_write_format(&out, opts->harm_path, in.rate, (uint16_t)(opts->harmonics - 1),
+                                            WAV_FORMAT_FLOAT, 32);
+
+        if (!err)
+        {
+            err = (wav_write_f32(&out, harm, length) != length);
+            err |= wav_close(&out);
+        }
+        if (err)
+        {
+            fprintf(stderr, "cannot write %s\n", opts->harm_path);
+            ret = 1;
+        }
+    }
+
+out:
+    free(harm);
+    free(region);
+    free(conv);
+    free(block);
+    free(frames);
+    ess_deconv_deinit(&dc);
+    wav_close(&in);
+    return ret;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    ess_opts_t opts = {
+        ESS_RATE_DEFAULT, ESS_F1_DEFAULT, ESS_F2_DEFAULT, ESS_SECONDS_DEFAULT, ESS_LEVEL_DEFAULT,
+        ESS_SILENCE_DEFAULT, ESS_LENGTH_DEFAULT, 0, ESS_HARMONICS_DEFAULT, NULL,
+    };
+    const char *sweep_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:f:T:a:r:S:c:l:k:H:")) != -1)
+    {
+        uint8_t bad = 0;
+        char *end;
+
+        switch (opt)
+        {
+        case 'g':
+            sweep_path = optarg;
+            break;
+        case 'f':
+            opts.f1 = strtof(optarg, &end);
+            bad = (*end != ':');
+            if (!bad)
+                opts.f2 = strtof(end + 1, NULL);
+            break;
+        case 'T':
+            opts.seconds = strtof(optarg, NULL);
+            break;
+        case 'a':
+            opts.level_db = strtof(optarg, NULL);
+            break;
+        case 'r':
+            opts.rate = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'S':
+            opts.silence_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            opts.channel = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            opts.length_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.length_ms;
+            break;
+        case 'k':
+            opts.harmonics = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.harmonics || (opts.harmonics > ESS_HARMONICS_MAX);
+            break;
+        case 'H':
+            opts.harm_path = optarg;
+            break;
+        default:
+            bad = 1;
+            break;
+        }
+        if (bad)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (sweep_path && (optind == argc))
+        return generate(&opts, sweep_path);
+    if (!sweep_path && (optind + 2 == argc))
+        return deconvolve(&opts, argv[optind], argv[optind + 1]);
+    usage(argv[0]);
+    return 1;
+}
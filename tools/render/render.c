@@ -0,0 +1,833 @@
+/**
+ * @file    render.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   offline render of one wav file: engines, options and the read/process/write pipeline
+ *
+ * The input is read in blocks of frames (16, 24, 32-bit PCM or 32-bit float, converted to the
+ * int16 samples of the engines), every channel goes through its own instance and the block is
+ * written back, so the memory does not depend on the length of the file. A reader and a writer
+ * thread move the blocks through a ring of RENDER_SLOTS buffers: the next block is read and the
+ * previous one written while the current one is processed. Everything a render needs comes from
+ * the arena given by the caller (one per thread in batch mode), which is reset at the end.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <jcrev_multirate.h>
+#include <resample.h>
+#include <reverb.h>
+#include <reverb_port.h>
+
+#include "render.h"
+#include "wavfile.h"
+
+#define RENDER_SLOTS 4 /* blocks in flight: being read, processed, written and one spare */
+#define RENDER_EARLY_SEND 0.5f /* level of the reflections in the network of jcrev_er */
+
+/* Conversion of one channel between the rate of the file and the one of the engine */
+typedef struct
+{
+    resample_t down; /* file to engine */
+    resample_t up;   /* engine to file */
+    int16_t *queue;  /* output waiting for its input samples */
+    uint32_t queued;
+} render_src_t;
+
+/* Engine state of one render */
+typedef struct
+{
+    const render_opts_t *opts;
+    uint32_t channels;
+    uint32_t rate;         /* of the engine */
+    jcrev_params_t params; /* at the rate of the engine, for the legacy engine */
+    jcrev_t *inst;
+    early_t *early;
+    jcrev_multirate_t *multi;
+    reverb_mem_t mem;
+    reverb_arena_t *arena;
+    render_src_t *src; /* one per channel, NULL when the engine runs at the rate of the file */
+    float *work;       /* a block at the rate of the file */
+    float *mid;        /* a block at the rate of the engine */
+    int16_t *low;      /* the same, engine input and output */
+} render_t;
+
+/* Engine: set up, process one channel of a block, release */
+typedef struct
+{
+    const char *name;
+    uint8_t (*setup)(render_t *r);
+    void (*process)(render_t *r, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n);
+    void (*teardown)(render_t *r);
+} render_engine_t;
+
+/* Blocks travelling from the reader thread to the engine and to the writer thread */
+typedef struct
+{
+    wav_file_t *in;
+    wav_file_t *out;
+    int16_t *buf[RENDER_SLOTS];
+    uint32_t frames[RENDER_SLOTS];
+    uint32_t block;
+    uint64_t total; /* frames to produce, tail included */
+    uint64_t given; /* frames handed over by the reader */
+    uint64_t read;  /* blocks read, processed and written so far */
+    uint64_t processed;
+    uint64_t written;
+    uint8_t eof;      /* reader done */
+    uint8_t finished; /* engine done */
+    uint8_t error;    /* read or write error, everybody stops */
+    uint8_t read_error;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} render_pipe_t;
+
+/* The legacy engine has one global state, its renders run one at a time */
+static pthread_mutex_t legacy_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Total length in samples of the delay lines of one jcrev instance, at the highest rate
+ *        (jcrev_init_config() sizes the lines for it)
+ *
+ * @param config gains and delays
+ * @return size_t samples
+ */
+static size_t jcrev_line_samples(const jcrev_config_t *config)
+{
+    jcrev_params_t params;
+    size_t total = 0;
+
+    jcrev_params_from_config(config, JCREV_RATE_MAX, &params);
+    for (int k = 0; k < JCREV_COMBS; k++)
+        total += params.m_comb[k];
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        total += params.m_ap[k];
+    return total;
+}
+
+/**
+ * @brief Set up one jcrev instance per channel
+ *
+ * @param r renderer
+ * @param tiered comb lines in the slow tier, else every line in the fast tier
+ * @param early early reflections (early_config_default) before the network
+ * @return uint8_t 0 if success
+ */
+static uint8_t jcrev_setup(render_t *r, uint8_t tiered, uint8_t early)
+{
+    /* lines shorter than REVERB_MEM_SLOW_THRESHOLD stay in the fast tier even when tiered */
+    size_t lines = r->channels * (jcrev_line_samples(&r->opts->config) * sizeof(int32_t) + REVERB_MEM_ALIGN * 8);
+    size_t fast = lines + r->channels * (10 * r->opts->block * sizeof(int32_t) + REVERB_MEM_ALIGN * 16);
+    /* the reflections line: 80 ms at the highest rate and a block, plus the block sum */
+    size_t reflections = early ? r->channels * ((JCREV_RATE_MAX / 10 + 2 * r->opts->block) * sizeof(float) +
+                                                REVERB_MEM_ALIGN * 2)
+                               : 0;
+    size_t slow = tiered ? lines : 0;
+    void *fast_mem;
+    void *slow_mem;
+
+    r->inst = reverb_arena_alloc(r->arena, r->channels * sizeof(jcrev_t));
+    r->early = early ? reverb_arena_alloc(r->arena, r->channels * sizeof(early_t)) : NULL;
+    fast += reflections;
+    fast_mem = reverb_arena_alloc(r->arena, fast);
+    slow_mem = slow ? reverb_arena_alloc(r->arena, slow) : NULL;
+    if (!r->inst || (early && !r->early) || !fast_mem || (slow && !slow_mem))
+        return 1;
+
+    reverb_mem_init(&r->mem, fast_mem, fast, slow_mem, slow);
+    for (uint32_t ch = 0; ch < r->channels; ch++)
+    {
+        if (jcrev_init_config(&r->inst[ch], &r->opts->config, r->rate, r->opts->block, &r->mem))
+            return 1;
+        jcrev_set_output(&r->inst[ch], r->opts->dry, r->opts->wet, r->opts->volume);
+        if (early)
+        {
+            if (early_init(&r->early[ch], &early_config_default, r->rate, JCREV_RATE_MAX, r->opts->block,
+                           &r->mem.fast))
+                return 1;
+            jcrev_set_early(&r->inst[ch], &r->early[ch], RENDER_EARLY_SEND);
+        }
+    }
+    return 0;
+}
+
+static uint8_t jcrev_fast_setup(render_t *r)
+{
+    return jcrev_setup(r, 0, 0);
+}
+
+static uint8_t jcrev_tiered_setup(render_t *r)
+{
+    return jcrev_setup(r, 1, 0);
+}
+
+static uint8_t jcrev_early_setup(render_t *r)
+{
+    return jcrev_setup(r, 0, 1);
+}
+
+static void jcrev_render_process(render_t *r, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    jcrev_process(&r->inst[ch], in, out, n);
+}
+
+static void jcrev_teardown(render_t *r)
+{
+    r->inst = NULL;
+    r->early = NULL;
+}
+
+/**
+ * @brief Set up one multirate jcrev instance per channel, every line in the fast tier
+ *
+ * @param r renderer
+ * @param factor decimation of the network
+ * @return uint8_t 0 if success, 3 if the rate is not a multiple of factor
+ */
+static uint8_t multirate_setup(render_t *r, uint32_t factor)
+{
+    size_t lines = r->channels * (jcrev_line_samples(&r->opts->config) / factor * sizeof(int32_t) + REVERB_MEM_ALIGN * 8);
+    /* network blocks, stage histories and buffers, all smaller than 8 full rate blocks of floats */
+    size_t fast = lines + r->channels * ((8 * r->opts->block + 8 * HALFBAND_TAPS) * sizeof(float) + REVERB_MEM_ALIGN * 24);
+    void *fast_mem;
+
+    r->multi = reverb_arena_alloc(r->arena, r->channels * sizeof(jcrev_multirate_t));
+    fast_mem = reverb_arena_alloc(r->arena, fast);
+    if (!r->multi || !fast_mem)
+        return 1;
+
+    reverb_mem_init(&r->mem, fast_mem, fast, NULL, 0);
+    for (uint32_t ch = 0; ch < r->channels; ch++)
+    {
+        uint8_t ret = jcrev_multirate_init(&r->multi[ch], &r->opts->config, r->rate, factor, r->opts->block, &r->mem);
+
+        if (ret)
+            return ret;
+        jcrev_multirate_set_output(&r->multi[ch], r->opts->dry, r->opts->wet, r->opts->volume);
+    }
+    return 0;
+}
+
+static uint8_t multirate2_setup(render_t *r)
+{
+    return multirate_setup(r, 2);
+}
+
+static uint8_t multirate4_setup(render_t *r)
+{
+    return multirate_setup(r, 4);
+}
+
+static void multirate_process(render_t *r, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    jcrev_multirate_process(&r->multi[ch], in, out, n);
+}
+
+static void multirate_teardown(render_t *r)
+{
+    r->multi = NULL;
+}
+
+/**
+ * @brief The legacy per-sample engine has a single global state: mono files only, one render at a
+ *        time, without the output stage (wet signal only)
+ *
+ * @param r renderer
+ * @return uint8_t 0 if success
+ */
+static uint8_t legacy_setup(render_t *r)
+{
+    pthread_mutex_lock(&legacy_lock);
+    if (r->channels != 1)
+        return 3;
+    for (int k = 0; k < JCREV_COMBS; k++)
+        if (r->params.m_comb[k] > INT16_MAX)
+            return 3;
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        if (r->params.m_ap[k] > INT16_MAX)
+            return 3;
+    return reverb_init((int)r->params.m_comb[0]);
+}
+
+static void legacy_process(render_t *r, uint32_t ch, const int16_t *in, int16_t *out, uint32_t n)
+{
+    const jcrev_params_t *p = &r->params;
+
+    (void)ch;
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = reverb(in[i], p->g_comb[0], p->g_comb[1], (int16_t)p->m_comb[1], p->g_comb[2],
+                        (int16_t)p->m_comb[2], p->g_comb[3], (int16_t)p->m_comb[3], p->g_ap[0],
+                        (int16_t)p->m_ap[0], p->g_ap[1], (int16_t)p->m_ap[1], p->g_ap[2], (int16_t)p->m_ap[2]);
+}
+
+static void legacy_teardown(render_t *r)
+{
+    (void)r;
+    reverb_deinit();
+    pthread_mutex_unlock(&legacy_lock);
+}
+
+static const render_engine_t engines[] = {
+    {"jcrev", jcrev_fast_setup, jcrev_render_process, jcrev_teardown},
+    {"jcrev_tiered", jcrev_tiered_setup, jcrev_render_process, jcrev_teardown},
+    {"jcrev_er", jcrev_early_setup, jcrev_render_process, jcrev_teardown},
+    {"jcrev_mr2", multirate2_setup, multirate_process, multirate_teardown},
+    {"jcrev_mr4", multirate4_setup, multirate_process, multirate_teardown},
+    {"legacy", legacy_setup, legacy_process, legacy_teardown},
+};
+
+#define ENGINES (sizeof(engines) / sizeof(engines[0]))
+
+/**
+ * @brief Set up the converters of every channel, the engine runs at r->rate
+ *
+ * @param r renderer
+ * @param rate rate of the file
+ * @return uint8_t 0 if success, 1 if the arena is too small, 3 if the ratio of the rates is not supported
+ */
+static uint8_t src_setup(render_t *r, uint32_t rate)
+{
+    uint32_t block = r->opts->block;
+    uint32_t mid_max = 0;
+    uint32_t out_max = 0;
+
+    r->src = reverb_arena_alloc(r->arena, r->channels * sizeof(render_src_t));
+    if (!r->src)
+        return 1;
+    for (uint32_t ch = 0; ch < r->channels; ch++)
+    {
+        render_src_t *s = &r->src[ch];
+        uint8_t ret = resample_init(&s->down, rate, r->rate, block, r->arena);
+
+        if (!ret)
+        {
+            mid_max = resample_out_max(&s->down, block);
+            ret = resample_init(&s->up, r->rate, rate, mid_max, r->arena);
+        }
+        if (ret)
+            return ret;
+        out_max = resample_out_max(&s->up, mid_max);
+        /* a round trip gives at least as many samples as it was given, and less than
+           rate / r->rate + 1 more, which wait in the queue */
+        s->queue = reverb_arena_alloc(r->arena, (out_max + rate / r->rate + 2) * sizeof(int16_t));
+        if (!s->queue)
+            return 1;
+        s->queued = 0;
+    }
+    r->work = reverb_arena_alloc(r->arena, ((block > out_max) ? block : out_max) * sizeof(float));
+    r->mid = reverb_arena_alloc(r->arena, mid_max * sizeof(float));
+    r->low = reverb_arena_alloc(r->arena, mid_max * sizeof(int16_t));
+    return (r->work && r->mid && r->low) ? 0 : 1;
+}
+
+/**
+ * @brief Process one channel of a block through the converters: to the rate of the engine, in
+ *        blocks of at most opts->block samples through the engine, back to the rate of the file
+ *
+ * @param r renderer
+ * @param engine engine set up at r->rate
+ * @param ch channel
+ * @param buf n samples, processed in place
+ * @param n number of samples
+ */
+static void src_process(render_t *r, const render_engine_t *engine, uint32_t ch, int16_t *buf, uint32_t n)
+{
+    render_src_t *s = &r->src[ch];
+    uint32_t count;
+
+    for (uint32_t i = 0; i < n; i++)
+        r->work[i] = buf[i];
+    count = resample_process(&s->down, r->work, r->mid, n);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float x = r->mid[i];
+
+        r->low[i] = reverb_sat16((int32_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f)));
+    }
+    for (uint32_t pos = 0; pos < count; pos += r->opts->block)
+    {
+        uint32_t len = (count - pos < r->opts->block) ? count - pos : r->opts->block;
+
+        engine->process(r, ch, &r->low[pos], &r->low[pos], len);
+    }
+    for (uint32_t i = 0; i < count; i++)
+        r->mid[i] = r->low[i];
+
+    count = resample_process(&s->up, r->mid, r->work, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float x = r->work[i];
+
+        s->queue[s->queued + i] = reverb_sat16((int32_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f)));
+    }
+    s->queued += count;
+    memcpy(buf, s->queue, n * sizeof(int16_t));
+    s->queued -= n;
+    memmove(s->queue, &s->queue[n], s->queued * sizeof(int16_t));
+}
+
+/**
+ * @brief Parse a comma separated list of exactly count numbers
+ *
+ * @param s list
+ * @param values parsed numbers
+ * @param count expected numbers
+ * @return uint8_t 0 if success, 3 if the list is malformed
+ */
+static uint8_t parse_floats(const char *s, float *values, int count)
+{
+    char *end;
+
+    for (int k = 0; k < count; k++)
+    {
+        values[k] = strtof(s, &end);
+        if (end == s)
+            return 3;
+        s = end;
+        if (k < count - 1)
+        {
+            if (*s != ',')
+                return 3;
+            s++;
+        }
+    }
+    return *s ? 3 : 0;
+}
+
+/**
+ * @brief Reader thread: reads the input, then the silence of the tail, into the free slots
+ *
+ * @param arg render_pipe_t
+ * @return void* NULL
+ */
+static void *pipe_reader(void *arg)
+{
+    render_pipe_t *p = (render_pipe_t *)arg;
+    uint32_t channels = p->in->channels;
+
+    for (;;)
+    {
+        uint32_t slot;
+        uint32_t n;
+
+        pthread_mutex_lock(&p->lock);
+        while ((p->read - p->written >= RENDER_SLOTS) && !p->error)
+            pthread_cond_wait(&p->cond, &p->lock);
+        slot = (uint32_t)(p->read % RENDER_SLOTS);
+        n = p->error;
+        pthread_mutex_unlock(&p->lock);
+        if (n)
+            break;
+
+        n = wav_read_i16(p->in, p->buf[slot], p->block);
+        /* the tail (or a truncated file) is rendered from silence */
+        if ((n < p->block) && !p->in->left)
+        {
+            uint64_t pad = p->total - p->given - n;
+
+            pad = (pad > p->block - n) ? (p->block - n) : pad;
+            memset(&p->buf[slot][(size_t)n * channels], 0, (size_t)pad * channels * sizeof(int16_t));
+            n += (uint32_t)pad;
+        }
+        p->given += n;
+
+        pthread_mutex_lock(&p->lock);
+        if (n)
+        {
+            p->frames[slot] = n;
+            p->read++;
+        }
+        else
+        {
+            p->eof = 1;
+            p->read_error = (p->in->left != 0);
+            p->error |= p->read_error;
+        }
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+        if (!n)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writer thread: writes the processed slots in order
+ *
+ * @param arg render_pipe_t
+ * @return void* NULL
+ */
+static void *pipe_writer(void *arg)
+{
+    render_pipe_t *p = (render_pipe_t *)arg;
+
+    for (;;)
+    {
+        uint32_t slot;
+        uint8_t ok;
+
+        pthread_mutex_lock(&p->lock);
+        while ((p->written == p->processed) && !p->finished && !p->error)
+            pthread_cond_wait(&p->cond, &p->lock);
+        if ((p->written == p->processed) || p->error)
+        {
+            pthread_mutex_unlock(&p->lock);
+            break;
+        }
+        slot = (uint32_t)(p->written % RENDER_SLOTS);
+        pthread_mutex_unlock(&p->lock);
+
+        ok = (wav_write_i16(p->out, p->buf[slot], p->frames[slot]) == p->frames[slot]);
+
+        pthread_mutex_lock(&p->lock);
+        p->written++;
+        p->error |= !ok;
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return NULL;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Default settings: jcrev, default gains and delays, wet signal only
+ *
+ * @param opts settings
+ */
+void render_opts_default(render_opts_t *opts)
+{
+    memset(opts, 0, sizeof(*opts));
+    opts->block = RENDER_BLOCK_DEFAULT;
+    opts->config = jcrev_config_default;
+    opts->wet = 1.0f;
+    opts->volume = 1.0f;
+    opts->tail_ms = RENDER_TAIL_DEFAULT;
+}
+
+/**
+ * @brief Apply one option of the command line or of a job
+ *
+ * @param opts settings
+ * @param opt option letter
+ * @param arg its value, NULL for the options without value
+ * @return uint8_t 0 if success, 3 if the option or its value is not valid
+ */
+uint8_t render_option(render_opts_t *opts, int opt, const char *arg)
+{
+    if ((opt != 'q') && !arg)
+        return 3;
+
+    switch (opt)
+    {
+    case 'e':
+        for (uint32_t e = 0; e < ENGINES; e++)
+        {
+            if (!strcmp(arg, engines[e].name))
+            {
+                opts->engine = e;
+                return 0;
+            }
+        }
+        return 3;
+    case 'b':
+        opts->block = (uint32_t)strtoul(arg, NULL, 0);
+        return (!opts->block || (opts->block > RENDER_BLOCK_MAX)) ? 3 : 0;
+    case 'g':
+        return parse_floats(arg, opts->config.g_comb, JCREV_COMBS);
+    case 'm':
+        return parse_floats(arg, opts->config.ms_comb, JCREV_COMBS);
+    case 'G':
+        return parse_floats(arg, opts->config.g_ap, JCREV_ALLPASSES);
+    case 'M':
+        return parse_floats(arg, opts->config.ms_ap, JCREV_ALLPASSES);
+    case 'd':
+        opts->dry = strtof(arg, NULL);
+        return 0;
+    case 'w':
+        opts->wet = strtof(arg, NULL);
+        return 0;
+    case 'v':
+        opts->volume = strtof(arg, NULL);
+        return 0;
+    case 'l':
+        opts->tail_ms = (uint32_t)strtoul(arg, NULL, 0);
+        return 0;
+    case 'R':
+        opts->rate = (uint32_t)strtoul(arg, NULL, 0);
+        return (!opts->rate || (opts->rate > JCREV_RATE_MAX)) ? 3 : 0;
+    case 'f':
+        opts->format = WAV_FORMAT_PCM;
+        if (!strcmp(arg, "16") || !strcmp(arg, "24") || !strcmp(arg, "32"))
+            opts->bits = (uint16_t)atoi(arg);
+        else if (!strcmp(arg, "float"))
+            opts->format = WAV_FORMAT_FLOAT, opts->bits = 32;
+        else
+            return 3;
+        return 0;
+    case 'q':
+        opts->quiet = 1;
+        return 0;
+    default:
+        return 3;
+    }
+}
+
+/**
+ * @brief Name of an engine
+ *
+ * @param engine index
+ * @return const char* name, NULL after the last one
+ */
+const char *render_engine_name(uint32_t engine)
+{
+    return (engine < ENGINES) ? engines[engine].name : NULL;
+}
+
+/**
+ * @brief Render one file, the errors are printed on stderr
+ *
+ * @param opts settings
+ * @param in_path input wav file
+ * @param out_path output wav file
+ * @param arena memory of the render, reset before returning
+ * @param result what was done
+ * @return uint8_t 0 if success, 1 on I/O error, 3 if the file or the settings are not supported
+ */
+uint8_t render_file(const render_opts_t *opts, const char *in_path, const char *out_path, reverb_arena_t *arena,
+                    render_result_t *result)
+{
+    const render_engine_t *engine = &engines[opts->engine];
+    render_pipe_t p;
+    render_t r;
+    wav_file_t in;
+    wav_file_t out;
+    pthread_t reader;
+    pthread_t writer;
+    int16_t *chan;
+    double start = now_s();
+    uint64_t done = 0;
+    uint32_t percent = 0;
+    uint8_t setup = 0;
+    uint8_t ret;
+
+    memset(result, 0, sizeof(*result));
+    ret = wav_open_read(&in, in_path);
+    if (ret)
+    {
+        fprintf(stderr, "%s: %s\n", in_path, (ret == 3) ? "not a supported wav file" : "cannot be read");
+        return ret;
+    }
+    if (!in.rate || (!opts->rate && (in.rate > JCREV_RATE_MAX)))
+    {
+        fprintf(stderr, "%s: %u Hz is above the %u Hz of the engines\n", in_path, in.rate, JCREV_RATE_MAX);
+        wav_close(&in);
+        return 3;
+    }
+
+    memset(&r, 0, sizeof(r));
+    memset(&p, 0, sizeof(p));
+    r.opts = opts;
+    r.channels = in.channels;
+    r.rate = opts->rate ? opts->rate : in.rate;
+    r.arena = arena;
+    jcrev_params_from_config(&opts->config, r.rate, &r.params);
+    chan = reverb_arena_alloc(arena, (size_t)opts->block * sizeof(int16_t));
+    for (uint32_t k = 0; k < RENDER_SLOTS; k++)
+        p.buf[k] = reverb_arena_alloc(arena, (size_t)opts->block * r.channels * sizeof(int16_t));
+    ret = 1;
+    if (chan && p.buf[RENDER_SLOTS - 1])
+        ret = (r.rate != in.rate) ? src_setup(&r, in.rate) : 0;
+    if (!ret)
+    {
+        ret = engine->setup(&r);
+        setup = 1;
+    }
+    if (ret)
+    {
+        fprintf(stderr, "%s: cannot set up %s for %u channel(s) at %u Hz%s\n", in_path, engine->name, r.channels,
+                r.rate, (ret == 1) ? " (arena too small)" : "");
+        goto out_engine;
+    }
+    if (wav_open_write_format(&out, out_path, in.rate, in.channels, opts->format ? opts->format : in.format,
+                              opts->format ? opts->bits : in.bits))
+    {
+        fprintf(stderr, "cannot create %s\n", out_path);
+        ret = 1;
+        goto out_engine;
+    }
+
+    p.in = &in;
+    p.out = &out;
+    p.block = opts->block;
+    p.total = in.frames + (uint64_t)opts->tail_ms * in.rate / 1000;
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.cond, NULL);
+    if (pthread_create(&reader, NULL, pipe_reader, &p))
+    {
+        p.error = 1;
+    }
+    else if (pthread_create(&writer, NULL, pipe_writer, &p))
+    {
+        /* stop the reader through the error flag */
+        pthread_mutex_lock(&p.lock);
+        p.error = 1;
+        pthread_cond_broadcast(&p.cond);
+        pthread_mutex_unlock(&p.lock);
+        pthread_join(reader, NULL);
+    }
+    if (p.error)
+    {
+        fprintf(stderr, "%s: cannot start the I/O threads\n", in_path);
+        pthread_cond_destroy(&p.cond);
+        pthread_mutex_destroy(&p.lock);
+        wav_close(&out);
+        ret = 1;
+        goto out_engine;
+    }
+
+    for (;;)
+    {
+        uint32_t slot;
+        uint32_t n;
+        int16_t *buf;
+        double t;
+
+        pthread_mutex_lock(&p.lock);
+        while ((p.processed == p.read) && !p.eof && !p.error)
+            pthread_cond_wait(&p.cond, &p.lock);
+        if ((p.processed == p.read) || p.error)
+        {
+            p.finished = 1;
+            pthread_cond_broadcast(&p.cond);
+            pthread_mutex_unlock(&p.lock);
+            break;
+        }
+        slot = (uint32_t)(p.processed % RENDER_SLOTS);
+        pthread_mutex_unlock(&p.lock);
+
+        buf = p.buf[slot];
+        n = p.frames[slot];
+        t = now_s();
+        for (uint32_t ch = 0; ch < r.channels; ch++)
+        {
+            for (uint32_t i = 0; i < n; i++)
+                chan[i] = buf[(size_t)i * r.channels + ch];
+            if (r.src)
+                src_process(&r, engine, ch, chan, n);
+            else
+                engine->process(&r, ch, chan, chan, n);
+            for (uint32_t i = 0; i < n; i++)
+                buf[(size_t)i * r.channels + ch] = chan[i];
+        }
+        result->engine_s += now_s() - t;
+        done += n;
+
+        pthread_mutex_lock(&p.lock);
+        p.processed++;
+        pthread_cond_broadcast(&p.cond);
+        pthread_mutex_unlock(&p.lock);
+
+        if (!opts->quiet && (done * 10 / p.total > percent))
+        {
+            percent = (uint32_t)(done * 10 / p.total);
+            fprintf(stderr, "\r%3u%%", percent * 10);
+        }
+    }
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.lock);
+
+    ret = p.error;
+    if (wav_close(&out))
+        ret = 1;
+    if (p.read_error)
+        fprintf(stderr, "cannot read %s\n", in_path);
+    else if (ret)
+        fprintf(stderr, "cannot write %s\n", out_path);
+
+    result->frames = done;
+    result->channels = r.channels;
+    result->rate = in.rate;
+    result->audio_s = (double)done / in.rate;
+    result->total_s = now_s() - start;
+    if (!opts->quiet)
+        fprintf(stderr, "\r");
+
+out_engine:
+    if (setup)
+        engine->teardown(&r);
+    wav_close(&in);
+    reverb_arena_reset(arena);
+    return ret;
+}
+
+/**
+ * @brief Impulse response of an engine: one channel, a full scale impulse followed by silence,
+ *        through the output stage of the settings
+ *
+ * @param opts settings (engine, block, configuration, output stage)
+ * @param rate sample rate in Hz, up to JCREV_RATE_MAX
+ * @param ir frames samples of the response, full scale at 1.0
+ * @param frames length of the response
+ * @param arena memory of the engine, reset before returning
+ * @return uint8_t 0 if success, 1 if the arena is too small, 3 if the settings are not supported
+ */
+uint8_t render_impulse(const render_opts_t *opts, uint32_t rate, float *ir, uint32_t frames, reverb_arena_t *arena)
+{
+    const render_engine_t *engine = &engines[opts->engine];
+    render_t r;
+    int16_t *buf;
+    uint8_t ret;
+
+    if (!rate || (rate > JCREV_RATE_MAX))
+        return 3; // BADARG
+
+    memset(&r, 0, sizeof(r));
+    r.opts = opts;
+    r.channels = 1;
+    r.rate = rate;
+    r.arena = arena;
+    jcrev_params_from_config(&opts->config, rate, &r.params);
+    buf = reverb_arena_alloc(arena, (size_t)opts->block * sizeof(int16_t));
+    if (!buf)
+        return 1;
+
+    ret = engine->setup(&r);
+    for (uint32_t pos = 0; !ret && (pos < frames); pos += opts->block)
+    {
+        uint32_t n = (frames - pos < opts->block) ? frames - pos : opts->block;
+
+        memset(buf, 0, n * sizeof(int16_t));
+        if (!pos)
+            buf[0] = RENDER_IMPULSE;
+        engine->process(&r, 0, buf, buf, n);
+        for (uint32_t i = 0; i < n; i++)
+            ir[pos + i] = buf[i] * (1.0f / 32768.0f);
+    }
+    engine->teardown(&r);
+    reverb_arena_reset(arena);
+    return ret;
+}
@@ -0,0 +1,48 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+
+#include <jcrev.h>
+#include <reverb_mem.h>
+
+#define RENDER_BLOCK_DEFAULT 1024
+#define RENDER_BLOCK_MAX 65536
+#define RENDER_TAIL_DEFAULT 2000 /* ms of silence after the input */
+#define RENDER_IMPULSE 32767     /* full scale impulse of render_impulse() */
+
+/* Settings of one render, set from the command line or a line of a job list */
+typedef struct
+{
+    uint32_t engine; /* index in the engine table, render_engine_name() */
+    uint32_t block;  /* frames per block */
+    jcrev_config_t config;
+    float dry;
+    float wet;
+    float volume;
+    uint32_t tail_ms;
+    uint32_t rate;   /* of the engine in Hz, 0 for the rate of the file */
+    uint16_t format; /* output format, 0 for the input one */
+    uint16_t bits;
+    uint8_t quiet; /* no progress */
+} render_opts_t;
+
+/* What a render did */
+typedef struct
+{
+    uint64_t frames; /* output frames, tail included */
+    uint32_t channels;
+    uint32_t rate;
+    double audio_s;  /* output length */
+    double total_s;  /* wall time of the render */
+    double engine_s; /* time spent in the engine */
+} render_result_t;
+
+void render_opts_default(render_opts_t *opts);
+uint8_t render_option(render_opts_t *opts, int opt, const char *arg);
+const char *render_engine_name(uint32_t engine);
+uint8_t render_file(const render_opts_t *opts, const char *in_path, const char *out_path, reverb_arena_t *arena,
+                    render_result_t *result);
+uint8_t render_impulse(const render_opts_t *opts, uint32_t rate, float *ir, uint32_t frames, reverb_arena_t *arena);
+
+#endif /*RENDER_H*/
@@ -0,0 +1,400 @@
+/**
+ * @file    reverb_render.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   offline renderer of wav files, one file or a batch of jobs on a thread pool
+ *
+ * A job list has one job per line: the render options then the input and output files, as on the
+ * command line (no quoting, '#' starts a comment). The options given on the command line are the
+ * defaults of every job, so a list of "in.wav out.wav" lines renders a directory with one preset
+ * and a list of option lines renders one input with many presets. The jobs run on a work-stealing
+ * pool, each worker renders from its own preallocated arena.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "render.h"
+#include "thread_pool.h"
+
+#define RENDER_ARENA_DEFAULT 64 /* MB of memory per worker */
+#define RENDER_THREADS_MAX 256
+#define RENDER_LINE_MAX 4096
+#define RENDER_ARGS_MAX 64
+
+/* One line of the job list */
+typedef struct
+{
+    render_opts_t opts;
+    char *in;
+    char *out;
+    uint32_t line;
+    uint8_t status; /* render_file() result */
+    render_result_t result;
+} render_job_t;
+
+/* State shared by the workers of a batch */
+typedef struct
+{
+    reverb_arena_t *arenas; /* one per worker */
+    uint32_t total;
+    uint32_t done;
+} render_batch_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] in.wav out.wav\n"
+            "       %s [options] [-t threads] [-a MB] -j jobs.txt\n"
+            "  -e  engine: jcrev, jcrev_tiered, jcrev_er (early reflections), jcrev_mr2, jcrev_mr4 (network at\n"
+            "      1/2 or 1/4 of the rate) or legacy (mono, one job at a time) (default jcrev)\n"
+            "  -b  frames per block, up to %u (default %u)\n"
+            "  -g  gains of the %u combs, comma separated\n"
+            "  -m  delays of the combs in ms\n"
+            "  -G  gains of the %u allpasses\n"
+            "  -M  delays of the allpasses in ms\n"
+            "  -d  dry gain (default 0)\n"
+            "  -w  wet gain (default 1)\n"
+            "  -v  volume (default 1)\n"
+            "  -l  silence rendered after the input, to keep the tail (default %u ms)\n"
+            "  -R  rate of the engine in Hz, the file is converted to it and back (default the rate of the file)\n"
+            "  -f  output format: 16, 24, 32 or float (default the input one)\n"
+            "  -q  no progress\n"
+            "  -j  job list, one '[options] in.wav out.wav' per line, the options above are the defaults\n"
+            "  -t  worker threads (default the online CPUs)\n"
+            "  -a  memory of each worker in MB (default %u)\n"
+            "The input is 16, 24, 32-bit PCM or float at up to %u Hz (any rate with -R), processed as 16-bit\n"
+            "samples.\n",
+            name, name, RENDER_BLOCK_MAX, RENDER_BLOCK_DEFAULT, JCREV_COMBS, JCREV_ALLPASSES, RENDER_TAIL_DEFAULT,
+            RENDER_ARENA_DEFAULT, JCREV_RATE_MAX);
+}
+
+/**
+ * @brief Parse one line of the job list
+ *
+ * @param line text, modified (split into words)
+ * @param defaults options of the command line
+ * @param job parsed job
+ * @return uint8_t 0 if success, 2 if the line is empty, 3 if it is not valid
+ */
+static uint8_t parse_job(char *line, const render_opts_t *defaults, render_job_t *job)
+{
+    char *args[RENDER_ARGS_MAX];
+    int count = 0;
+    int k;
+
+    if (strchr(line, '#'))
+        *strchr(line, '#') = '\0';
+    for (char *w = strtok(line, " \t\r\n"); w; w = strtok(NULL, " \t\r\n"))
+    {
+        if (count == RENDER_ARGS_MAX)
+            return 3;
+        args[count++] = w;
+    }
+    if (!count)
+        return 2;
+
+    memset(job, 0, sizeof(*job));
+    job->opts = *defaults;
+    job->opts.quiet = 1;
+    for (k = 0; (k < count - 2) && (args[k][0] == '-') && args[k][1] && !args[k][2]; k++)
+    {
+        int opt = args[k][1];
+        const char *arg = NULL;
+
+        if (opt != 'q')
+        {
+            if (k + 1 >= count - 2)
+                return 3;
+            arg = args[++k];
+        }
+        if (render_option(&job->opts, opt, arg))
+            return 3;
+    }
+    if (k != count - 2)
+        return 3;
+    job->in = strdup(args[k]);
+    job->out = strdup(args[k + 1]);
+    return (job->in && job->out) ? 0 : 3;
+}
+
+/**
+ * @brief Read the job list
+ *
+ * @param path file name
+ * @param defaults options of the command line
+ * @param count number of jobs
+ * @return render_job_t* jobs, NULL on error (printed)
+ */
+static render_job_t *load_jobs(const char *path, const render_opts_t *defaults, uint32_t *count)
+{
+    FILE *f = fopen(path, "r");
+    render_job_t *jobs = NULL;
+    uint32_t cap = 0;
+    uint32_t line_no = 0;
+    char line[RENDER_LINE_MAX];
+
+    *count = 0;
+    if (!f)
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), f))
+    {
+        render_job_t job;
+        uint8_t ret;
+
+        line_no++;
+        ret = parse_job(line, defaults, &job);
+        if (ret == 2)
+            continue;
+        if (ret)
+        {
+            fprintf(stderr, "%s:%u: not a valid job\n", path, line_no);
+            goto bad;
+        }
+        if (*count == cap)
+        {
+            render_job_t *grown = realloc(jobs, (cap ? cap * 2 : 64) * sizeof(render_job_t));
+
+            if (!grown)
+                goto bad;
+            jobs = grown;
+            cap = cap ? cap * 2 : 64;
+        }
+        job.line = line_no;
+        jobs[(*count)++] = job;
+    }
+    fclose(f);
+    return jobs;
+
+bad:
+    fclose(f);
+    for (uint32_t k = 0; k < *count; k++)
+    {
+        free(jobs[k].in);
+        free(jobs[k].out);
+    }
+    free(jobs);
+    *count = 0;
+    return NULL;
+}
+
+/**
+ * @brief Pool job: render one line of the list with the arena of the worker
+ *
+ * @param arg render_job_t
+ * @param worker index of the thread
+ * @param ctx render_batch_t
+ */
+static void batch_job(void *arg, uint32_t worker, void *ctx)
+{
+    render_job_t *job = (render_job_t *)arg;
+    render_batch_t *batch = (render_batch_t *)ctx;
+    render_result_t *res = &job->result;
+    uint32_t done;
+
+    job->status = render_file(&job->opts, job->in, job->out, &batch->arenas[worker], res);
+    done = __atomic_add_fetch(&batch->done, 1, __ATOMIC_RELAXED);
+    if (job->status)
+        fprintf(stderr, "[%u/%u] worker %u: %s failed\n", done, batch->total, worker, job->in);
+    else
+        fprintf(stderr, "[%u/%u] worker %u: %s -> %s, %.1f s of audio in %.2f s (x%.0f real time)\n", done,
+                batch->total, worker, job->in, job->out, res->audio_s, res->total_s,
+                (res->total_s > 0.0) ? res->audio_s / res->total_s : 0.0);
+}
+
+/**
+ * @brief Run a job list on the pool
+ *
+ * @param path job list
+ * @param defaults options of the command line
+ * @param threads workers
+ * @param arena_size memory of each worker in bytes
+ * @return int exit code, 0 if every job succeeded
+ */
+static int run_batch(const char *path, const render_opts_t *defaults, uint32_t threads, size_t arena_size)
+{
+    render_batch_t batch;
+    thread_pool_t pool;
+    render_job_t *jobs;
+    uint32_t count;
+    uint32_t failed = 0;
+    double audio = 0.0;
+    double busy = 0.0;
+    double start;
+    double wall;
+    int ret = 1;
+
+    jobs = load_jobs(path, defaults, &count);
+    if (!jobs)
+        return 1;
+    if (threads > count)
+        threads = count ? count : 1;
+
+    memset(&batch, 0, sizeof(batch));
+    batch.total = count;
+    batch.arenas = calloc(threads, sizeof(reverb_arena_t));
+    if (!batch.arenas || pool_init(&pool, threads, batch_job, &batch))
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    for (uint32_t w = 0; w < threads; w++)
+    {
+        void *mem = malloc(arena_size);
+
+        if (!mem)
+        {
+            fprintf(stderr, "not enough memory for %u arenas of %zu MB\n", threads, arena_size >> 20);
+            goto out_pool;
+        }
+        reverb_arena_init(&batch.arenas[w], mem, arena_size);
+    }
+    for (uint32_t k = 0; k < count; k++)
+    {
+        if (pool_submit(&pool, &jobs[k]))
+        {
+            fprintf(stderr, "not enough memory\n");
+            goto out_pool;
+        }
+    }
+
+    fprintf(stderr, "%u job(s) on %u thread(s)\n", count, threads);
+    start = now_s();
+    if (pool_run(&pool))
+        fprintf(stderr, "some threads could not be started\n");
+    wall = now_s() - start;
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        failed += (jobs[k].status != 0);
+        audio += jobs[k].result.audio_s;
+        busy += jobs[k].result.total_s;
+    }
+    fprintf(stderr, "%u job(s) done, %u failed: %.1f s of audio in %.2f s (x%.0f real time), %.2f s of work "
+                    "(x%.2f parallel)\n",
+            count - failed, failed, audio, wall, (wall > 0.0) ? audio / wall : 0.0, busy,
+            (wall > 0.0) ? busy / wall : 0.0);
+    ret = failed ? 1 : 0;
+
+out_pool:
+    for (uint32_t w = 0; w < threads; w++)
+        free(batch.arenas[w].base);
+    pool_deinit(&pool);
+out:
+    free(batch.arenas);
+    for (uint32_t k = 0; k < count; k++)
+    {
+        free(jobs[k].in);
+        free(jobs[k].out);
+    }
+    free(jobs);
+    return ret;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    render_opts_t opts;
+    render_result_t res;
+    reverb_arena_t arena;
+    const char *job_list = NULL;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = (cpus > 0) ? (uint32_t)cpus : 1;
+    size_t arena_size = (size_t)RENDER_ARENA_DEFAULT << 20;
+    void *mem;
+    uint8_t ret;
+    int opt;
+
+    render_opts_default(&opts);
+    while ((opt = getopt(argc, argv, "e:b:g:m:G:M:d:w:v:l:R:f:qj:t:a:")) != -1)
+    {
+        uint8_t bad = 0;
+
+        switch (opt)
+        {
+        case 'j':
+            job_list = optarg;
+            break;
+        case 't':
+            threads = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !threads || (threads > RENDER_THREADS_MAX);
+            break;
+        case 'a':
+            arena_size = (size_t)strtoul(optarg, NULL, 0) << 20;
+            bad = !arena_size;
+            break;
+        case '?':
+            bad = 1;
+            break;
+        default:
+            bad = render_option(&opts, opt, optarg);
+            break;
+        }
+        if (bad)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (job_list)
+    {
+        if (optind != argc)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        return run_batch(job_list, &opts, threads, arena_size);
+    }
+
+    if (optind + 2 != argc)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    mem = malloc(arena_size);
+    if (!mem)
+    {
+        fprintf(stderr, "not enough memory\n");
+        return 1;
+    }
+    reverb_arena_init(&arena, mem, arena_size);
+    ret = render_file(&opts, argv[optind], argv[optind + 1], &arena, &res);
+    if (!ret && !opts.quiet)
+        fprintf(stderr, "%s: %.1f s of audio, %u channel(s) at %u Hz, %.2f s (x%.0f real time), engine %.2f s "
+                        "(x%.0f)\n",
+                render_engine_name(opts.engine), res.audio_s, res.channels, res.rate, res.total_s,
+                (res.total_s > 0.0) ? res.audio_s / res.total_s : 0.0, res.engine_s,
+                (res.engine_s > 0.0) ? res.audio_s / res.engine_s : 0.0);
+    free(mem);
+    return ret ? 1 : 0;
+}
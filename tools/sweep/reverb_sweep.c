@@ -0,0 +1,610 @@
+/**
+ * @file    reverb_sweep.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   parameter sweep of the jcrev gains and delays, ranked on measures of the impulse response
+ *
+ * Every candidate configuration is drawn at random in the given ranges (the CCRMA default is always
+ * candidate 0, as a reference), its impulse response is rendered with jcrev and scored on:
+ * - the reverberation time (T30 fit of the energy decay curve) against a target,
+ * - the echo density of the first SWEEP_NED_MS, how fast the echoes turn into a diffuse tail,
+ * - the spectral flatness of the first SWEEP_FLAT_MS, the colouration of the combs,
+ * - the stability margin 1 - max|g|, candidates below SWEEP_MARGIN_MIN are rejected.
+ * The candidates are evaluated in chunks on the work-stealing pool. Each worker owns its scratch
+ * (delay lines, response, decay curve, spectrum) allocated once, so a candidate allocates nothing.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jcrev.h>
+
+#include "fft.h"
+#include "ir_metrics.h"
+#include "thread_pool.h"
+
+#define SWEEP_COUNT_DEFAULT 4096
+#define SWEEP_LENGTH_DEFAULT 3000 /* ms of impulse response */
+#define SWEEP_TARGET_DEFAULT 2.0f /* RT60 in s */
+#define SWEEP_TOP_DEFAULT 20
+#define SWEEP_THREADS_MAX 256
+#define SWEEP_CHUNK 16   /* candidates per pool job */
+#define SWEEP_BLOCK 1024 /* samples rendered at once */
+#define SWEEP_IMPULSE 32767
+
+#define SWEEP_MARGIN_MIN 0.01f  /* lowest accepted 1 - max|g| */
+#define SWEEP_NED_MS 300        /* echo density averaged over the start of the response */
+#define SWEEP_NED_HOP_MS 5
+#define SWEEP_FLAT_MS 500       /* flatness of the start of the response */
+#define SWEEP_FLAT_LO_HZ 50.0f  /* band of the flatness, up to 0.45 of the rate */
+#define SWEEP_RT_WEIGHT 2.0f    /* score lost per octave of reverberation time away from the target */
+#define SWEEP_LINE_SLACK 64     /* samples added to a delay to make it mutually prime with the others */
+
+/* Range of one parameter, lo == hi keeps it fixed */
+typedef struct
+{
+    float lo;
+    float hi;
+} sweep_range_t;
+
+/* Command line */
+typedef struct
+{
+    sweep_range_t g_comb;
+    sweep_range_t ms_comb;
+    sweep_range_t g_ap;
+    sweep_range_t ms_ap;
+    uint32_t count;
+    uint32_t rate;
+    uint32_t length_ms;
+    uint32_t top;
+    uint32_t threads;
+    uint64_t seed;
+    float target;
+    const char *csv;
+} sweep_opts_t;
+
+/* One configuration and its measures */
+typedef struct
+{
+    jcrev_config_t config;
+    float rt60;     /* s */
+    float ned;      /* mean echo density */
+    float flatness; /* 0 to 1 */
+    float margin;   /* 1 - max|g| */
+    float score;
+    uint8_t valid; /* stable enough and the decay is measured within the response */
+} sweep_candidate_t;
+
+/* Scratch of one worker, allocated once */
+typedef struct
+{
+    void *lines; /* memory of the delay lines and block buffers */
+    size_t lines_size;
+    int16_t in[SWEEP_BLOCK];
+    int16_t out[SWEEP_BLOCK];
+    float *ir;
+    float *edc;
+    float *ned;
+    fft_complex_t *spec;
+} sweep_worker_t;
+
+/* State shared by the workers */
+typedef struct
+{
+    const sweep_opts_t *opts;
+    sweep_candidate_t *cands;
+    sweep_worker_t *workers;
+    fft_plan_t plan; /* read only */
+    uint32_t ir_len;
+    uint32_t ned_len;
+    uint32_t flat_len;
+    uint32_t window;
+    uint32_t hop;
+    uint32_t lo_bin;
+    uint32_t hi_bin;
+} sweep_t;
+
+/* Chunk of candidates run by one pool job */
+typedef struct
+{
+    uint32_t first;
+    uint32_t count;
+} sweep_job_t;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -n  candidates (default %u, the first one is the default configuration)\n"
+            "  -g  range of the comb gains, lo:hi or a fixed value (default 0.6:0.85)\n"
+            "  -m  range of the comb delays in ms (default 20:250)\n"
+            "  -G  range of the allpass gains (default 0.5:0.75)\n"
+            "  -M  range of the allpass delays in ms (default 1:50)\n"
+            "  -r  sample rate, up to %u Hz (default %u)\n"
+            "  -l  length of the impulse responses in ms (default %u)\n"
+            "  -T  target reverberation time in s (default %.1f)\n"
+            "  -k  rows of the ranking (default %u)\n"
+            "  -s  seed of the random draws (default 1)\n"
+            "  -t  worker threads (default the online CPUs)\n"
+            "  -o  write every candidate to a CSV file\n",
+            name, SWEEP_COUNT_DEFAULT, JCREV_RATE_MAX, JCREV_RATE_MAX, SWEEP_LENGTH_DEFAULT,
+            (double)SWEEP_TARGET_DEFAULT, SWEEP_TOP_DEFAULT);
+}
+
+/**
+ * @brief Parse a range
+ *
+ * @param s "lo:hi" or "value"
+ * @param range parsed range
+ * @return uint8_t 0 if success, 3 if not valid
+ */
+static uint8_t parse_range(const char *s, sweep_range_t *range)
+{
+    char *end;
+
+    range->lo = strtof(s, &end);
+    if (end == s)
+        return 3;
+    range->hi = range->lo;
+    if (*end == ':')
+    {
+        s = end + 1;
+        range->hi = strtof(s, &end);
+        if (end == s)
+            return 3;
+    }
+    return (*end || (range->hi < range->lo)) ? 3 : 0;
+}
+
+/**
+ * @brief Random number generator (xorshift64*)
+ *
+ * @param state seed, updated
+ * @return float uniform in [0, 1)
+ */
+static float rand_unit(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (float)((*state * 2685821657736338717ull) >> 40) / (float)(1u << 24);
+}
+
+static float rand_range(uint64_t *state, const sweep_range_t *range)
+{
+    return range->lo + (range->hi - range->lo) * rand_unit(state);
+}
+
+/**
+ * @brief Draw the candidates, the default configuration first
+ *
+ * @param opts ranges and seed
+ * @param cands opts->count candidates
+ */
+static void draw_candidates(const sweep_opts_t *opts, sweep_candidate_t *cands)
+{
+    uint64_t state = opts->seed ? opts->seed : 1;
+
+    memset(cands, 0, opts->count * sizeof(sweep_candidate_t));
+    cands[0].config = jcrev_config_default;
+    for (uint32_t c = 1; c < opts->count; c++)
+    {
+        jcrev_config_t *config = &cands[c].config;
+
+        for (int k = 0; k < JCREV_COMBS; k++)
+        {
+            config->g_comb[k] = rand_range(&state, &opts->g_comb);
+            config->ms_comb[k] = rand_range(&state, &opts->ms_comb);
+        }
+        for (int k = 0; k < JCREV_ALLPASSES; k++)
+        {
+            config->g_ap[k] = rand_range(&state, &opts->g_ap);
+            config->ms_ap[k] = rand_range(&state, &opts->ms_ap);
+        }
+    }
+}
+
+/**
+ * @brief Memory of the delay lines of any candidate: the longest delays of the ranges (and of the
+ *        default configuration) at JCREV_RATE_MAX, which jcrev_init_config() sizes the lines for
+ *
+ * @param opts ranges
+ * @return size_t bytes
+ */
+static size_t lines_size(const sweep_opts_t *opts)
+{
+    float comb = (opts->ms_comb.hi > 250.0f) ? opts->ms_comb.hi : 250.0f;
+    float ap = (opts->ms_ap.hi > 50.0f) ? opts->ms_ap.hi : 50.0f;
+    size_t samples = 2 * SWEEP_BLOCK;
+
+    samples += JCREV_COMBS * ((size_t)ceilf(comb * JCREV_RATE_MAX / 1000.0f) + SWEEP_LINE_SLACK);
+    samples += JCREV_ALLPASSES * ((size_t)ceilf(ap * JCREV_RATE_MAX / 1000.0f) + SWEEP_LINE_SLACK);
+    return samples * sizeof(int32_t) + (2 + JCREV_COMBS + JCREV_ALLPASSES) * REVERB_MEM_ALIGN;
+}
+
+/**
+ * @brief Render the impulse response of a candidate and measure it
+ *
+ * @param sw sweep
+ * @param w scratch of the calling worker
+ * @param cand candidate, its measures are written
+ */
+static void evaluate(const sweep_t *sw, sweep_worker_t *w, sweep_candidate_t *cand)
+{
+    const sweep_opts_t *opts = sw->opts;
+    reverb_mem_t mem;
+    jcrev_t rv;
+    float gmax = 0.0f;
+    uint32_t points;
+    double ned = 0.0;
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+        gmax = fmaxf(gmax, fabsf(cand->config.g_comb[k]));
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        gmax = fmaxf(gmax, fabsf(cand->config.g_ap[k]));
+    cand->margin = 1.0f - gmax;
+    cand->valid = 0;
+    if (cand->margin < SWEEP_MARGIN_MIN)
+        return;
+
+    reverb_mem_init(&mem, w->lines, w->lines_size, NULL, 0);
+    if (jcrev_init_config(&rv, &cand->config, opts->rate, SWEEP_BLOCK, &mem))
+        return;
+    jcrev_set_output(&rv, 0.0f, 1.0f, 1.0f);
+
+    memset(w->in, 0, sizeof(w->in));
+    w->in[0] = SWEEP_IMPULSE;
+    for (uint32_t pos = 0; pos < sw->ir_len; pos += SWEEP_BLOCK)
+    {
+        uint32_t n = (sw->ir_len - pos < SWEEP_BLOCK) ? sw->ir_len - pos : SWEEP_BLOCK;
+
+        jcrev_process(&rv, w->in, w->out, n);
+        w->in[0] = 0;
+        for (uint32_t i = 0; i < n; i++)
+            w->ir[pos + i] = w->out[i] * (1.0f / 32768.0f);
+    }
+
+    ir_edc(w->ir, sw->ir_len, w->edc);
+    cand->rt60 = ir_decay_time(w->edc, sw->ir_len, opts->rate, -5.0f, -35.0f);
+    points = ir_echo_density(w->ir, sw->ned_len, sw->window, sw->hop, w->ned);
+    for (uint32_t j = 0; j < points; j++)
+        ned += w->ned[j];
+    cand->ned = points ? (float)(ned / points) : 0.0f;
+    cand->flatness = ir_flatness(&sw->plan, w->ir, sw->flat_len, w->spec, sw->lo_bin, sw->hi_bin);
+    if (cand->rt60 <= 0.0f)
+        return;
+
+    cand->score = cand->ned + cand->flatness - SWEEP_RT_WEIGHT * fabsf(log2f(cand->rt60 / opts->target));
+    cand->valid = 1;
+}
+
+/**
+ * @brief Pool job: evaluate a chunk of candidates with the scratch of the worker
+ *
+ * @param arg sweep_job_t
+ * @param worker index of the thread
+ * @param ctx sweep_t
+ */
+static void sweep_job(void *arg, uint32_t worker, void *ctx)
+{
+    const sweep_job_t *job = (const sweep_job_t *)arg;
+    sweep_t *sw = (sweep_t *)ctx;
+
+    for (uint32_t c = job->first; c < job->first + job->count; c++)
+        evaluate(sw, &sw->workers[worker], &sw->cands[c]);
+}
+
+/* Candidates being ranked, qsort() has no context argument */
+static const sweep_candidate_t *sort_base;
+
+/**
+ * @brief Ranking order: valid candidates first, by decreasing score, then by number
+ */
+static int by_score(const void *a, const void *b)
+{
+    const sweep_candidate_t *ca = &sort_base[*(const uint32_t *)a];
+    const sweep_candidate_t *cb = &sort_base[*(const uint32_t *)b];
+
+    if (ca->valid != cb->valid)
+        return cb->valid - ca->valid;
+    if (ca->score != cb->score)
+        return (ca->score < cb->score) ? 1 : -1;
+    return (*(const uint32_t *)a > *(const uint32_t *)b) ? 1 : -1;
+}
+
+/**
+ * @brief Print one row of the ranking
+ *
+ * @param rank position, from 1
+ * @param index candidate number
+ * @param cand candidate
+ */
+static void print_row(uint32_t rank, uint32_t index, const sweep_candidate_t *cand)
+{
+    const jcrev_config_t *c = &cand->config;
+
+    printf("%5u %6u%c", rank, index, index ? ' ' : '*');
+    if (cand->valid)
+        printf(" %7.3f %6.2f %5.3f %5.3f", (double)cand->score, (double)cand->rt60, (double)cand->ned,
+               (double)cand->flatness);
+    else
+        printf(" %7s %6s %5s %5s", "-", "-", "-", "-");
+    printf(" %6.3f  %.3f,%.3f,%.3f,%.3f  %.2f,%.2f,%.2f,%.2f  %.3f,%.3f,%.3f  %.2f,%.2f,%.2f\n",
+           (double)cand->margin, (double)c->g_comb[0], (double)c->g_comb[1], (double)c->g_comb[2],
+           (double)c->g_comb[3], (double)c->ms_comb[0], (double)c->ms_comb[1], (double)c->ms_comb[2],
+           (double)c->ms_comb[3], (double)c->g_ap[0], (double)c->g_ap[1], (double)c->g_ap[2], (double)c->ms_ap[0],
+           (double)c->ms_ap[1], (double)c->ms_ap[2]);
+}
+
+/**
+ * @brief Write every candidate as CSV
+ *
+ * @param path file name
+ * @param cands candidates
+ * @param count number of candidates
+ * @return uint8_t 0 if success, 1 if the file cannot be written
+ */
+static uint8_t write_csv(const char *path, const sweep_candidate_t *cands, uint32_t count)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+        return 1;
+    fprintf(f, "index,valid,score,rt60,ned,flatness,margin");
+    for (int k = 0; k < JCREV_COMBS; k++)
+        fprintf(f, ",g_comb%d,ms_comb%d", k, k);
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        fprintf(f, ",g_ap%d,ms_ap%d", k, k);
+    fprintf(f, "\n");
+    for (uint32_t c = 0; c < count; c++)
+    {
+        const sweep_candidate_t *cand = &cands[c];
+
+        fprintf(f, "%u,%u,%.4f,%.4f,%.4f,%.4f,%.4f", c, cand->valid, (double)cand->score, (double)cand->rt60,
+                (double)cand->ned, (double)cand->flatness, (double)cand->margin);
+        for (int k = 0; k < JCREV_COMBS; k++)
+            fprintf(f, ",%.4f,%.3f", (double)cand->config.g_comb[k], (double)cand->config.ms_comb[k]);
+        for (int k = 0; k < JCREV_ALLPASSES; k++)
+            fprintf(f, ",%.4f,%.3f", (double)cand->config.g_ap[k], (double)cand->config.ms_ap[k]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) ? 1 : 0;
+}
+
+/**
+ * @brief Allocate the scratch of every worker
+ *
+ * @param sw sweep, sw->workers set
+ * @param threads workers
+ * @return uint8_t 0 if success, 1 if out of memory
+ */
+static uint8_t workers_alloc(sweep_t *sw, uint32_t threads)
+{
+    sw->workers = calloc(threads, sizeof(sweep_worker_t));
+    if (!sw->workers)
+        return 1;
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        sweep_worker_t *w = &sw->workers[t];
+
+        w->lines_size = lines_size(sw->opts);
+        w->lines = malloc(w->lines_size);
+        w->ir = malloc(sw->ir_len * sizeof(float));
+        w->edc = malloc(sw->ir_len * sizeof(float));
+        w->ned = malloc((sw->ned_len / sw->hop + 1) * sizeof(float));
+        w->spec = malloc(sw->plan.n * sizeof(fft_complex_t));
+        if (!w->lines || !w->ir || !w->edc || !w->ned || !w->spec)
+            return 1;
+    }
+    return 0;
+}
+
+static void workers_free(sweep_t *sw, uint32_t threads)
+{
+    if (!sw->workers)
+        return;
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        free(sw->workers[t].lines);
+        free(sw->workers[t].ir);
+        free(sw->workers[t].edc);
+        free(sw->workers[t].ned);
+        free(sw->workers[t].spec);
+    }
+    free(sw->workers);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    sweep_opts_t opts = {
+        {0.6f, 0.85f}, {20.0f, 250.0f}, {0.5f, 0.75f}, {1.0f, 50.0f}, SWEEP_COUNT_DEFAULT, JCREV_RATE_MAX,
+        SWEEP_LENGTH_DEFAULT, SWEEP_TOP_DEFAULT, 1, 1, SWEEP_TARGET_DEFAULT, NULL,
+    };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    sweep_t sw;
+    thread_pool_t pool;
+    sweep_job_t *jobs = NULL;
+    uint32_t *order = NULL;
+    uint32_t job_count;
+    uint32_t valid = 0;
+    double start;
+    double wall;
+    int ret = 1;
+    int opt;
+
+    opts.threads = (cpus > 0) ? (uint32_t)cpus : 1;
+    while ((opt = getopt(argc, argv, "n:g:m:G:M:r:l:T:k:s:t:o:")) != -1)
+    {
+        uint8_t bad = 0;
+
+        switch (opt)
+        {
+        case 'n':
+            opts.count = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.count;
+            break;
+        case 'g':
+            bad = parse_range(optarg, &opts.g_comb);
+            break;
+        case 'm':
+            bad = parse_range(optarg, &opts.ms_comb) || (opts.ms_comb.lo <= 0.0f);
+            break;
+        case 'G':
+            bad = parse_range(optarg, &opts.g_ap);
+            break;
+        case 'M':
+            bad = parse_range(optarg, &opts.ms_ap) || (opts.ms_ap.lo <= 0.0f);
+            break;
+        case 'r':
+            opts.rate = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.rate || (opts.rate > JCREV_RATE_MAX);
+            break;
+        case 'l':
+            opts.length_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = (opts.length_ms < SWEEP_FLAT_MS);
+            break;
+        case 'T':
+            opts.target = strtof(optarg, NULL);
+            bad = !(opts.target > 0.0f);
+            break;
+        case 'k':
+            opts.top = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            opts.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            opts.threads = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.threads || (opts.threads > SWEEP_THREADS_MAX);
+            break;
+        case 'o':
+            opts.csv = optarg;
+            break;
+        default:
+            bad = 1;
+            break;
+        }
+        if (bad)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&sw, 0, sizeof(sw));
+    sw.opts = &opts;
+    sw.ir_len = (uint32_t)((uint64_t)opts.length_ms * opts.rate / 1000);
+    sw.ned_len = SWEEP_NED_MS * opts.rate / 1000;
+    sw.flat_len = SWEEP_FLAT_MS * opts.rate / 1000;
+    sw.window = (uint32_t)(IR_NED_WINDOW_MS * opts.rate / 1000.0f);
+    sw.hop = SWEEP_NED_HOP_MS * opts.rate / 1000;
+    job_count = (opts.count + SWEEP_CHUNK - 1) / SWEEP_CHUNK;
+    if (opts.threads > job_count)
+        opts.threads = job_count;
+
+    sw.cands = malloc(opts.count * sizeof(sweep_candidate_t));
+    jobs = malloc(job_count * sizeof(sweep_job_t));
+    order = malloc(opts.count * sizeof(uint32_t));
+    if (!sw.cands || !jobs || !order || fft_init(&sw.plan, fft_size(sw.flat_len)) || workers_alloc(&sw, opts.threads))
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    sw.lo_bin = (uint32_t)ceilf(SWEEP_FLAT_LO_HZ * sw.plan.n / opts.rate);
+    sw.hi_bin = (uint32_t)(0.45f * sw.plan.n);
+    draw_candidates(&opts, sw.cands);
+
+    if (pool_init(&pool, opts.threads, sweep_job, &sw))
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    for (uint32_t j = 0; j < job_count; j++)
+    {
+        jobs[j].first = j * SWEEP_CHUNK;
+        jobs[j].count = (opts.count - jobs[j].first < SWEEP_CHUNK) ? opts.count - jobs[j].first : SWEEP_CHUNK;
+        if (pool_submit(&pool, &jobs[j]))
+        {
+            fprintf(stderr, "not enough memory\n");
+            goto out_pool;
+        }
+    }
+
+    fprintf(stderr, "%u candidate(s), %u ms responses at %u Hz, on %u thread(s)\n", opts.count, opts.length_ms,
+            opts.rate, opts.threads);
+    start = now_s();
+    if (pool_run(&pool))
+        fprintf(stderr, "some threads could not be started\n");
+    wall = now_s() - start;
+
+    for (uint32_t c = 0; c < opts.count; c++)
+    {
+        order[c] = c;
+        valid += sw.cands[c].valid;
+    }
+    sort_base = sw.cands;
+    qsort(order, opts.count, sizeof(uint32_t), by_score);
+
+    printf("score = echo density + flatness - %.1f x |log2(RT60 / %.2f s)|, * default configuration\n",
+           (double)SWEEP_RT_WEIGHT, (double)opts.target);
+    printf("%5s %7s %7s %6s %5s %5s %6s  %-23s  %-27s  %-17s  %s\n", "rank", "cand", "score", "rt60", "ned",
+           "flat", "margin", "comb gains", "comb ms", "allpass gains", "allpass ms");
+    for (uint32_t r = 0; r < opts.count; r++)
+    {
+        if ((r < opts.top) || !order[r])
+            print_row(r + 1, order[r], &sw.cands[order[r]]);
+    }
+    fprintf(stderr, "%u candidate(s), %u valid, in %.2f s (%.0f candidates/s)\n", opts.count, valid, wall,
+            (wall > 0.0) ? opts.count / wall : 0.0);
+
+    ret = 0;
+    if (opts.csv && write_csv(opts.csv, sw.cands, opts.count))
+    {
+        fprintf(stderr, "cannot write %s\n", opts.csv);
+        ret = 1;
+    }
+
+out_pool:
+    pool_deinit(&pool);
+out:
+    workers_free(&sw, opts.threads);
+    fft_deinit(&sw.plan);
+    free(order);
+    free(jobs);
+    free(sw.cands);
+    return ret;
+}
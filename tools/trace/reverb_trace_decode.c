@@ -0,0 +1,199 @@
+/**
+ * @file    reverb_trace_decode.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   decoder of the reverb trace ring (reverb_trace.h) into Chrome trace JSON
+ *
+ * The events are put back in order, the 32-bit time stamps are unwrapped and converted to
+ * microseconds from the first kept event. Every stage gets its own track, the kernel output is also
+ * written as a counter. The JSON opens in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <reverb_trace.h>
+
+/* Names of a stage and of its fields, NULL when the field is not used */
+typedef struct
+{
+    const char *name;
+    const char *index;
+    const char *a;
+    const char *b;
+} stage_info_t;
+
+static const stage_info_t stages[REVERB_TRACE_STAGES] = {
+    [REVERB_TRACE_INIT] = {"init", NULL, "samples", NULL},
+    [REVERB_TRACE_PUT] = {"put", "head", "x", "y"},
+    [REVERB_TRACE_POP] = {"pop", "tail", "x", "y"},
+    [REVERB_TRACE_GET] = {"get", "delay", "x", "y"},
+    [REVERB_TRACE_ALLPASS] = {"allpass", "delay", "x", "y"},
+    [REVERB_TRACE_COMB] = {"comb", "delay", "x", "y"},
+    [REVERB_TRACE_OUTPUT] = {"output", NULL, "in", "out"},
+};
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s trace.bin [trace.json]\n"
+            "  trace.bin   ring saved by reverb_trace_save() or dumped from the board memory\n"
+            "  trace.json  Chrome trace output (default stdout)\n",
+            name);
+}
+
+/**
+ * @brief Read and check a saved ring
+ *
+ * @param path file name
+ * @param hdr header of the ring
+ * @param events allocated array of hdr->size events, to be freed
+ * @return uint8_t 0 if success, 1 if the file cannot be read, 3 if it is not a trace
+ */
+static uint8_t trace_load(const char *path, reverb_trace_t *hdr, reverb_trace_event_t **events)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t ret = 0;
+
+    *events = NULL;
+    if (!f)
+        return 1;
+    if (fread(hdr, offsetof(reverb_trace_t, events), 1, f) != 1)
+    {
+        ret = 1;
+    }
+    else if ((hdr->magic != REVERB_TRACE_MAGIC) || (hdr->version != REVERB_TRACE_VERSION) ||
+             (hdr->event_size != sizeof(reverb_trace_event_t)) || !hdr->size ||
+             (hdr->size & (hdr->size - 1)) || !hdr->clock_hz)
+    {
+        ret = 3; // BADARG
+    }
+    else
+    {
+        *events = malloc((size_t)hdr->size * sizeof(reverb_trace_event_t));
+        if (!*events || (fread(*events, sizeof(reverb_trace_event_t), hdr->size, f) != hdr->size))
+            ret = 1;
+    }
+    fclose(f);
+    if (ret)
+    {
+        free(*events);
+        *events = NULL;
+    }
+    return ret;
+}
+
+/**
+ * @brief Write one event
+ *
+ * @param out JSON file
+ * @param e event
+ * @param us time in microseconds
+ */
+static void trace_write_event(FILE *out, const reverb_trace_event_t *e, double us)
+{
+    const stage_info_t *s = &stages[e->stage];
+    const char *sep = "";
+
+    fprintf(out, ",\n{\"name\": \"%s\", \"cat\": \"reverb\", \"ph\": \"i\", \"s\": \"t\", \"ts\": %.3f, "
+                 "\"pid\": 1, \"tid\": %u, \"args\": {",
+            s->name, us, e->stage + 1u);
+    if (s->index)
+    {
+        fprintf(out, "\"%s\": %u", s->index, e->index);
+        sep = ", ";
+    }
+    if (s->a)
+    {
+        fprintf(out, "%s\"%s\": %d", sep, s->a, (int)e->a);
+        sep = ", ";
+    }
+    if (s->b)
+        fprintf(out, "%s\"%s\": %d", sep, s->b, (int)e->b);
+    fprintf(out, "}}");
+
+    if (e->stage == REVERB_TRACE_OUTPUT)
+        fprintf(out, ",\n{\"name\": \"signal\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, "
+                     "\"args\": {\"in\": %d, \"out\": %d}}",
+                us, (int)e->a, (int)e->b);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    static reverb_trace_t hdr;
+    reverb_trace_event_t *events;
+    uint32_t count;
+    uint32_t first;
+    uint32_t unknown = 0;
+    uint64_t ticks = 0;
+    uint32_t last;
+    FILE *out = stdout;
+    uint8_t ret;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    ret = trace_load(argv[1], &hdr, &events);
+    if (ret)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], (ret == 3) ? "not a reverb trace" : "cannot be read");
+        return 1;
+    }
+    if ((argc == 3) && !(out = fopen(argv[2], "w")))
+    {
+        fprintf(stderr, "cannot create %s\n", argv[2]);
+        free(events);
+        return 1;
+    }
+
+    /* the ring keeps the last size events, the oldest one is at head once it has wrapped */
+    count = (hdr.head < hdr.size) ? hdr.head : hdr.size;
+    first = (hdr.head < hdr.size) ? 0 : (hdr.head & (hdr.size - 1));
+    last = count ? events[first].time : 0;
+
+    fprintf(out, "{\"displayTimeUnit\": \"ns\",\n\"otherData\": {\"clock_hz\": %u, \"events\": %u, "
+                 "\"dropped\": %u},\n\"traceEvents\": [\n"
+                 "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"reverb\"}}",
+            hdr.clock_hz, count, hdr.head - count);
+    for (uint32_t s = 0; s < REVERB_TRACE_STAGES; s++)
+        fprintf(out, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                     "\"args\": {\"name\": \"%s\"}}",
+                s + 1, stages[s].name);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const reverb_trace_event_t *e = &events[(first + i) & (hdr.size - 1)];
+
+        /* consecutive events are less than one counter period apart */
+        ticks += (uint32_t)(e->time - last);
+        last = e->time;
+        if (e->stage >= REVERB_TRACE_STAGES)
+        {
+            unknown++;
+            continue;
+        }
+        trace_write_event(out, e, (double)ticks * 1e6 / hdr.clock_hz);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (unknown)
+        fprintf(stderr, "%u events of unknown stages skipped\n", unknown);
+    fprintf(stderr, "%u events, %u overwritten\n", count, hdr.head - count);
+    free(events);
+    return (out != stdout) ? (fclose(out) != 0) : 0;
+}
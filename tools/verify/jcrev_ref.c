@@ -0,0 +1,128 @@
+/**
+ * @file    jcrev_ref.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   double precision reference of the JCRev difference equations
+ *
+ * The filters are the equations documented in comb() and all_pass(), computed in double precision
+ * without any truncation or shift:
+ * - allpass: y[n] = −g·x[n] + x[n−M] + g·y[n−M]
+ * - comb:    y[n] = x[n] + g·y[n−M]
+ * - output:  volume·(dry·in[n] + wet·(sum of the combs)/4)
+ * Each filter runs over the whole signal: y[n] only depends on samples at least M earlier, so the
+ * signal is cut in segments of M samples whose loops have no dependency and are vectorized.
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include "jcrev_ref.h"
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief One segment of an allpass, not longer than its delay
+ *
+ * @param x input
+ * @param xd input M samples earlier
+ * @param yd output M samples earlier
+ * @param y output
+ * @param n number of samples
+ * @param g gain
+ */
+static void all_pass_segment(const double *restrict x, const double *restrict xd, const double *restrict yd,
+                             double *restrict y, uint32_t n, double g)
+{
+    for (uint32_t i = 0; i < n; i++)
+        y[i] = -g * x[i] + xd[i] + g * yd[i];
+}
+
+/**
+ * @brief One segment of a comb, not longer than its delay
+ *
+ * @param x input
+ * @param yd output M samples earlier
+ * @param y output
+ * @param n number of samples
+ * @param g gain
+ */
+static void comb_segment(const double *restrict x, const double *restrict yd, double *restrict y, uint32_t n,
+                         double g)
+{
+    for (uint32_t i = 0; i < n; i++)
+        y[i] = x[i] + g * yd[i];
+}
+
+/**
+ * @brief allpass filter over a whole signal, the state starts silent
+ *
+ * @param x input
+ * @param y output, not the same buffer as x
+ * @param n number of samples
+ * @param m delay
+ * @param g gain
+ */
+static void all_pass(const double *x, double *y, uint32_t n, uint32_t m, double g)
+{
+    uint32_t first = (n < m) ? n : m;
+
+    for (uint32_t i = 0; i < first; i++)
+        y[i] = -g * x[i];
+    for (uint32_t s = m; s < n; s += m)
+        all_pass_segment(&x[s], &x[s - m], &y[s - m], &y[s], (n - s < m) ? n - s : m, g);
+}
+
+/**
+ * @brief feedback comb filter over a whole signal, the state starts silent
+ *
+ * @param x input
+ * @param y output, not the same buffer as x
+ * @param n number of samples
+ * @param m delay
+ * @param g gain
+ */
+static void comb(const double *x, double *y, uint32_t n, uint32_t m, double g)
+{
+    uint32_t first = (n < m) ? n : m;
+
+    for (uint32_t i = 0; i < first; i++)
+        y[i] = x[i];
+    for (uint32_t s = m; s < n; s += m)
+        comb_segment(&x[s], &y[s - m], &y[s], (n - s < m) ? n - s : m, g);
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+/**
+ * @brief Reference JCRev over a whole signal: three allpass filters in series, four parallel comb
+ *        filters and the output stage, without saturation
+ *
+ * @param params gains and delays, every delay at least 1
+ * @param dry gain of the input signal
+ * @param wet gain of the reverb signal
+ * @param volume output gain
+ * @param in input samples (int16 scale)
+ * @param out output samples, not the same buffer as in
+ * @param n number of samples
+ * @param work JCREV_REF_WORK(n) doubles
+ */
+void jcrev_ref_process(const jcrev_params_t *params, double dry, double wet, double volume, const double *in,
+                       double *out, uint32_t n, double *work)
+{
+    double *a = work;
+    double *b = &work[n];
+    double *c = &work[2 * (size_t)n];
+    double wet_gain = wet * volume * 0.25;
+
+    all_pass(in, a, n, params->m_ap[0], params->g_ap[0]);
+    all_pass(a, b, n, params->m_ap[1], params->g_ap[1]);
+    all_pass(b, a, n, params->m_ap[2], params->g_ap[2]);
+
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = dry * volume * in[i];
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        comb(a, c, n, params->m_comb[k], params->g_comb[k]);
+        for (uint32_t i = 0; i < n; i++)
+            out[i] += wet_gain * c[i];
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef JCREV_REF_H
+#define JCREV_REF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <jcrev.h>
+
+/* Scratch of jcrev_ref_process() in doubles, for a signal of n samples */
+#define JCREV_REF_WORK(n) (3 * (size_t)(n))
+
+void jcrev_ref_process(const jcrev_params_t *params, double dry, double wet, double volume, const double *in,
+                       double *out, uint32_t n, double *work);
+
+#endif /*JCREV_REF_H*/
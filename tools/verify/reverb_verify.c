@@ -0,0 +1,1959 @@
+/**
+ * @file    reverb_verify.c
+ * @author  Marcin Sosnowski (marcin.sosnow@gmail.com)
+ * @brief   verification of the reverb kernels against the double precision reference
+ *
+ * Every case draws at random a configuration (gains, delays from one sample to 250 ms), a sample
+ * rate, a block size, an output stage and an input signal, then runs each kernel on it (with calls
+ * of random lengths, so the blocks are split in every way) and compares the output with
+ * jcrev_ref_process(). For each kernel and case it reports the largest error in LSB, the SNR of the
+ * output against the reference and the first sample further than VERIFY_DIVERGE from it.
+ *
+ * The engines truncate every product to an integer. A truncation is below 1 LSB and the filters
+ * are stable, so the error of a kernel is bounded: an error e entering a comb of gain g is at most
+ * e / (1 - |g|) at its output, through an allpass (e + 1)·(1 + |g|) / (1 - |g|) + 1. This worst
+ * case grows fast with the gains, so the RMS error is also checked against the noise of
+ * uncorrelated truncations (times VERIFY_RMS_FACTOR: truncation toward zero is biased on slowly
+ * varying signals). A wrong delay, a block boundary bug or a lost sample gives errors of the order
+ * of the signal and fails one of the two checks, while the SNR depends on the level of the case
+ * and is only reported. A kernel which departs from the equations by design (the silence gate drops
+ * what is below its level) has its own tolerance, which adds what it is allowed to drop. With
+ * early reflections the reference adds the taps (delayed, one-pole filtered, in double precision)
+ * to the network input and to the wet signal, and the bound adds the float sum of the taps and its
+ * truncation.
+ *
+ * The multirate engines run the network between half-band stages. Their reference passes the
+ * input through the responses of the stages (probed once with impulses) in double precision, runs
+ * jcrev_ref_process() at the low rate and interpolates back: the block splitting of the stages, the
+ * queue of the wet signal and the network at the low rate are checked, the coefficients of the
+ * stages are not. The error of the network input is the rounding of the decimated signal, and the
+ * bound of the network at the low rate goes through the L1 gain of the interpolation.
+ *
+ * The resampler converts the input of a case to another of the rates. Its reference designs the
+ * windowed-sinc phases again in double precision and applies them with the direct formula, so the
+ * phase and index stepping across the calls is checked, and its bound is the float rounding of
+ * the coefficients and of the dot products.
+ *
+ * The biquad cascades filter the input of a case cut into interleaved frames, with sections drawn
+ * from the RBJ designs and an input scaled so that no signal of the cascade can leave the int16
+ * range. The reference runs the same coefficients (the Q2.29 ones for the Q31 cascade) in double
+ * precision and measures the peaks of each section, from which the roundings are bounded.
+ *
+ * A case a kernel cannot take is reported as not run: a rate which is not a multiple of the factor
+ * of a multirate engine, a ratio of rates with more than RESAMPLE_PHASES_MAX phases (11025 and
+ * 32000 Hz), a cascade with a coefficient beyond the ±4 of Q2.29 for the Q31 cascade.
+ *
+ * The legacy reverb() does not compute these equations (the allpass outputs are not used, the
+ * combs share one history and are scaled by >>2 each), it is reported for information only.
+ * Cases are reproducible from the seed and their number (-c runs one case and prints its details).
+ *
+ * @version 0.1
+ * @date    2026-10-19
+ *
+ * @copyright Copyright (c) copyright GNU Public License.
+ *
+ */
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <biquad.h>
+#include <jcrev.h>
+#include <jcrev_mailbox.h>
+#include <jcrev_multirate.h>
+#include <resample.h>
+#include <reverb.h>
+
+#include "jcrev_ref.h"
+#include "thread_pool.h"
+
+#define VERIFY_COUNT_DEFAULT 1000
+#define VERIFY_LENGTH_DEFAULT 250 /* ms of signal per case */
+#define VERIFY_LENGTH_MAX 10000
+#define VERIFY_GAIN_DEFAULT 0.95f /* highest |g| drawn */
+#define VERIFY_THREADS_MAX 256
+#define VERIFY_CHUNK 8 /* cases per pool job */
+#define VERIFY_BLOCK_MAX 4096
+#define VERIFY_COMB_MS_MIN 0.05f
+#define VERIFY_COMB_MS_MAX 250.0f
+#define VERIFY_AP_MS_MIN 0.05f
+#define VERIFY_AP_MS_MAX 50.0f
+#define VERIFY_LINE_SLACK 64 /* samples added to a delay to make it mutually prime with the others */
+#define VERIFY_DIVERGE 2.0   /* LSB, first divergence reported */
+#define VERIFY_SLACK 0.5     /* LSB added to the bounds for the float rounding of the gains */
+#define VERIFY_RMS_FACTOR 4.0 /* margin of the RMS error over the noise of uncorrelated truncations */
+#define VERIFY_GATE_LEVEL 8   /* RMS level of the silence gate in LSB, the one of the firmware */
+#define VERIFY_REPOST 8       /* the settings in use are posted again before one call out of this many */
+#define VERIFY_HB_PROBE HALFBAND_TAPS /* samples of the low rate holding the response of a half-band stage */
+#define VERIFY_HB_ACC 0.25    /* LSB, float accumulation of the half-band stages */
+#define VERIFY_RS_CUTOFF 0.44 /* design of the resampler: cut off in periods of the lower rate, */
+#define VERIFY_RS_BETA 8.0    /* Kaiser window, */
+#define VERIFY_RS_LANES 8     /* taps rounded up to a multiple of its independent sums */
+#define VERIFY_MISSING 1e9    /* LSB, error of every sample of a run with a wrong number of them */
+#define VERIFY_ER_PREDELAY_MAX 50.0f /* ms */
+#define VERIFY_ER_MS_MAX 100.0f      /* ms, longest reflection after the pre-delay */
+#define VERIFY_ER_DAMP_MAX 0.95f     /* highest pole of a damped reflection */
+#define VERIFY_ER_L1_MAX 2.0f        /* highest sum of the |gains| of the reflections */
+#define VERIFY_BQ_F0_MIN 20.0f   /* Hz */
+#define VERIFY_BQ_F0_MAX 0.45f   /* of the rate */
+#define VERIFY_BQ_Q_MIN 0.3f
+#define VERIFY_BQ_Q_MAX 4.0f
+#define VERIFY_BQ_GAIN_DB 12.0f  /* highest |gain| of a peak or a shelf */
+#define VERIFY_BQ_HEADROOM 0.9   /* highest bound of a signal of the cascades, of full scale */
+#define VERIFY_BQ_ORDER 2.0      /* margin of the float bound, which keeps the first order terms */
+#define VERIFY_BQ_SLACK 1e-6     /* LSB, rounding of the reference */
+#define VERIFY_BQ_IMPULSE_MAX (1u << 22) /* longest impulse response of a section */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Input signals of the cases */
+enum
+{
+    VERIFY_NOISE,
+    VERIFY_IMPULSE,
+    VERIFY_SINE,
+    VERIFY_BURST,  /* noise, then silence: the tail alone */
+    VERIFY_SQUARE, /* full scale: the output saturates */
+    VERIFY_SIGNALS
+};
+
+static const char *const signal_names[VERIFY_SIGNALS] = {"noise", "impulse", "sine", "burst", "square"};
+
+static const uint32_t rates[] = {8000, 11025, 16000, 22050, 32000, 44100, 48000};
+
+/* Command line */
+typedef struct
+{
+    uint32_t count;
+    uint32_t length_ms;
+    uint32_t threads;
+    uint64_t seed;
+    float gain;
+    int64_t only;  /* case to run alone, -1 for all */
+    int32_t kernel; /* kernel to run alone, -1 for all */
+    uint8_t verbose;
+} verify_opts_t;
+
+/* One randomized case */
+typedef struct
+{
+    jcrev_config_t config;
+    jcrev_params_t params; /* at rate */
+    uint32_t rate;
+    uint32_t block;
+    uint32_t n;
+    uint32_t signal;
+    float level; /* peak of the input, full scale at 1 */
+    float dry;
+    float wet;
+    float volume;
+    uint64_t seed; /* of the samples and of the call lengths */
+} verify_case_t;
+
+/* Comparison of one kernel with the reference on one case */
+typedef struct
+{
+    double max_err; /* LSB */
+    double rms_err; /* LSB */
+    double snr;     /* dB */
+    double bound;   /* LSB, 0 when the kernel is not checked */
+    double rms_max; /* LSB, highest RMS error of a passing case */
+    uint32_t at;    /* sample of the largest error */
+    int64_t first;  /* first sample further than VERIFY_DIVERGE from the reference, -1 if none */
+    uint8_t status; /* 0 if the kernel ran, else its set up error */
+    uint8_t pass;
+} verify_result_t;
+
+/* Biquad cascade drawn for a case */
+typedef struct
+{
+    uint32_t channels;
+    uint32_t stages;
+    uint8_t shared; /* the same sections on every channel, set with BIQUAD_ALL */
+    biquad_coef_t coef[BIQUAD_LANES][BIQUAD_STAGES_MAX];
+    double c[BIQUAD_LANES][BIQUAD_STAGES_MAX][5]; /* b0, b1, b2, a1, a2 of the reference */
+    double h_l1[BIQUAD_LANES][BIQUAD_STAGES_MAX];   /* L1 norm of a section */
+    double inv_l1[BIQUAD_LANES][BIQUAD_STAGES_MAX]; /* L1 and L2 norms of its recursion 1 / A(z) */
+    double inv_l2[BIQUAD_LANES][BIQUAD_STAGES_MAX];
+    double atten;  /* gain of the input of the case, which keeps the cascade in the int16 range */
+    uint8_t q31;   /* the reference coefficients are those of the Q31 cascade */
+    double bound;  /* LSB, largest error, set by the reference */
+    double rms;    /* LSB, largest RMS error, set by the reference */
+} verify_biquad_t;
+
+/* Scratch of one worker, allocated once */
+typedef struct
+{
+    void *fast; /* memory tiers of the instances */
+    void *slow;
+    size_t size;
+    int16_t *in16;
+    int16_t *out16;
+    float *in_f32;
+    float *out_f32;
+    double *in;
+    double *ref;
+    double *out; /* output of the kernel, int16 scale */
+    double *work;
+    double *kref;     /* reference of a kernel with its own */
+    double *stage[2]; /* signals of the reference at the low rates, n / 2 + 1 each */
+    double *aux[2];   /* signals of the reference at the rate of the case */
+    double *coef;     /* phases of the resampler reference */
+    double kref_gain; /* L1 gain of the filter of the reference, for the tolerance */
+    uint32_t n_out;   /* samples of out and kref: n, unless the kernel changes the rate */
+    verify_biquad_t bq; /* cascade drawn by a biquad kernel for its reference */
+} verify_worker_t;
+
+/* Kernel under test, its output goes to w->out */
+typedef struct
+{
+    const char *name;
+    uint8_t (*run)(verify_worker_t *w, const verify_case_t *vc);
+    uint8_t checked; /* 0 for a kernel of other equations, reported only */
+    /* bound of the largest and of the RMS error, NULL for those of the integer jcrev kernels */
+    void (*tolerance)(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms);
+    /* reference of the case in w->kref, NULL for jcrev_ref_process() */
+    void (*reference)(verify_worker_t *w, const verify_case_t *vc);
+} verify_kernel_t;
+
+/* State shared by the workers */
+typedef struct
+{
+    const verify_opts_t *opts;
+    verify_case_t *cases;
+    verify_result_t *results; /* case after case, one per kernel */
+    verify_worker_t *workers;
+    uint32_t count;
+    uint32_t first; /* number of the first case */
+} verify_t;
+
+/* Settings of a case passed through a mailbox, like the UI does on the target */
+typedef struct
+{
+    jcrev_mailbox_t box;
+    jcrev_settings_t settings;
+} verify_updates_t;
+
+/* Responses of the half-band stages, from silence (see halfband_probe()) */
+typedef struct
+{
+    double dec[2][VERIFY_HB_PROBE]; /* decimator output for an impulse on an even, an odd input */
+    double up[2 * VERIFY_HB_PROBE]; /* interpolator output for an impulse */
+    double gain[JCREV_MULTIRATE_FACTOR_MAX + 1]; /* L1 gain of the interpolation by 2 and by 4 */
+} verify_halfband_t;
+
+/* Chunk of cases run by one pool job */
+typedef struct
+{
+    uint32_t first;
+    uint32_t count;
+} verify_job_t;
+
+/* The legacy engine has one global state, its runs go one at a time */
+static pthread_mutex_t legacy_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Set before the workers start, read only by them */
+static verify_halfband_t halfband_ref;
+
+/* ----- Static function ------------------------------------------------------------------------ */
+/**
+ * @brief Monotonic time
+ *
+ * @return double seconds
+ */
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the command line help
+ *
+ * @param name program name
+ */
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -n  cases (default %u)\n"
+            "  -s  seed of the cases (default 1)\n"
+            "  -c  run only this case and print its details\n"
+            "  -e  run only this kernel: jcrev, jcrev_tiered, jcrev_rate, jcrev_f32, jcrev_ramp, jcrev_gate,\n"
+            "      jcrev_early, jcrev_mr2, jcrev_mr4, resample, biquad_f32, biquad_q31 or legacy\n"
+            "  -l  length of the signal of a case in ms, up to %u (default %u)\n"
+            "  -g  highest |gain| drawn, below 1 (default %.2f)\n"
+            "  -t  worker threads (default the online CPUs)\n"
+            "  -v  print every case\n",
+            name, VERIFY_COUNT_DEFAULT, VERIFY_LENGTH_MAX, VERIFY_LENGTH_DEFAULT, (double)VERIFY_GAIN_DEFAULT);
+}
+
+/**
+ * @brief Random number generator (xorshift64*)
+ *
+ * @param state seed, updated
+ * @return float uniform in [0, 1)
+ */
+static float rand_unit(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (float)((*state * 2685821657736338717ull) >> 40) / (float)(1u << 24);
+}
+
+static float rand_range(uint64_t *state, float lo, float hi)
+{
+    return lo + (hi - lo) * rand_unit(state);
+}
+
+/**
+ * @brief Uniform on a log scale, for delays and block sizes which span decades
+ */
+static float rand_log(uint64_t *state, float lo, float hi)
+{
+    return lo * powf(hi / lo, rand_unit(state));
+}
+
+/**
+ * @brief Gain of a filter: |g| up to max, negative one time out of four
+ */
+static float rand_gain(uint64_t *state, float max)
+{
+    float g = rand_range(state, 0.0f, max);
+
+    return (rand_unit(state) < 0.25f) ? -g : g;
+}
+
+/**
+ * @brief Seed of a case from the seed of the run and its number (splitmix64), so any case can
+ *        be drawn again alone
+ *
+ * @param seed seed of the run
+ * @param index case number
+ * @return uint64_t seed of the case, never 0
+ */
+static uint64_t case_seed(uint64_t seed, uint64_t index)
+{
+    uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ull;
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+/**
+ * @brief Draw a case
+ *
+ * @param opts ranges
+ * @param index case number
+ * @param vc case
+ */
+static void draw_case(const verify_opts_t *opts, uint32_t index, verify_case_t *vc)
+{
+    uint64_t state = case_seed(opts->seed, index);
+
+    memset(vc, 0, sizeof(*vc));
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        vc->config.g_comb[k] = rand_gain(&state, opts->gain);
+        vc->config.ms_comb[k] = rand_log(&state, VERIFY_COMB_MS_MIN, VERIFY_COMB_MS_MAX);
+    }
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        vc->config.g_ap[k] = rand_gain(&state, opts->gain);
+        vc->config.ms_ap[k] = rand_log(&state, VERIFY_AP_MS_MIN, VERIFY_AP_MS_MAX);
+    }
+    vc->rate = rates[(uint32_t)(rand_unit(&state) * (sizeof(rates) / sizeof(rates[0])))];
+    jcrev_params_from_config(&vc->config, vc->rate, &vc->params);
+    vc->block = (uint32_t)rand_log(&state, 1.0f, VERIFY_BLOCK_MAX + 1.0f);
+    vc->block = (vc->block > VERIFY_BLOCK_MAX) ? VERIFY_BLOCK_MAX : vc->block;
+    vc->n = (uint32_t)((uint64_t)opts->length_ms * vc->rate / 1000);
+    vc->signal = (uint32_t)(rand_unit(&state) * VERIFY_SIGNALS);
+    vc->level = (vc->signal == VERIFY_SQUARE) ? 1.0f : powf(10.0f, rand_range(&state, -40.0f, 0.0f) / 20.0f);
+    vc->dry = rand_range(&state, 0.0f, 1.0f);
+    vc->wet = rand_range(&state, 0.0f, 2.0f);
+    vc->volume = rand_range(&state, 0.25f, 1.5f);
+    vc->seed = state;
+}
+
+/**
+ * @brief Input samples of a case, int16 and the same values as float and double
+ *
+ * @param vc case
+ * @param w scratch of the worker
+ */
+static void make_input(const verify_case_t *vc, verify_worker_t *w)
+{
+    uint64_t state = vc->seed;
+    double peak = vc->level * 32767.0;
+    double freq = rand_range(&state, 20.0f, vc->rate / 2.5f);
+    uint32_t period = 2 + (uint32_t)rand_log(&state, 1.0f, 2000.0f);
+
+    memset(w->in16, 0, vc->n * sizeof(int16_t));
+    switch (vc->signal)
+    {
+    case VERIFY_NOISE:
+        for (uint32_t i = 0; i < vc->n; i++)
+            w->in16[i] = (int16_t)lrint(peak * (2.0 * rand_unit(&state) - 1.0));
+        break;
+    case VERIFY_IMPULSE:
+        w->in16[0] = (int16_t)lrint(peak);
+        if (vc->n > 1)
+            w->in16[vc->n / 2] = (int16_t)lrint(-peak);
+        break;
+    case VERIFY_SINE:
+        for (uint32_t i = 0; i < vc->n; i++)
+            w->in16[i] = (int16_t)lrint(peak * sin(2.0 * M_PI * freq * i / vc->rate));
+        break;
+    case VERIFY_BURST:
+        for (uint32_t i = 0; i < vc->n / 4; i++)
+            w->in16[i] = (int16_t)lrint(peak * (2.0 * rand_unit(&state) - 1.0));
+        break;
+    default:
+        for (uint32_t i = 0; i < vc->n; i++)
+            w->in16[i] = ((i % period) < period / 2) ? INT16_MAX : INT16_MIN;
+        break;
+    }
+    for (uint32_t i = 0; i < vc->n; i++)
+    {
+        w->in_f32[i] = w->in16[i] * (1.0f / 32768.0f);
+        w->in[i] = w->in16[i];
+    }
+}
+
+/**
+ * @brief Bound of the error of the integer kernels: every truncation is below 1 LSB and is
+ *        amplified by the filters it goes through (see the file header)
+ *
+ * @param vc case
+ * @param in_err error of the network input in LSB, 0 when it is the input of the case
+ * @return double LSB
+ */
+static double rounding_bound(const verify_case_t *vc, double in_err)
+{
+    double ap = in_err;
+    double sum = 0.0;
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        double g = fabs(vc->params.g_ap[k]);
+
+        ap = (ap + 1.0) * (1.0 + g) / (1.0 - g) + 1.0;
+    }
+    for (int k = 0; k < JCREV_COMBS; k++)
+        sum += (ap + 1.0) / (1.0 - fabs(vc->params.g_comb[k]));
+    return fabs(vc->wet * vc->volume * 0.25) * sum + 1.0 + VERIFY_SLACK;
+}
+
+/**
+ * @brief RMS error of the integer kernels for truncations of at most 1 LSB RMS which are not
+ *        correlated over time: an allpass has a unit L2 gain and adds two truncations, a comb of
+ *        gain g has an L2 gain of 1 / sqrt(1 - g²). The comb inputs share the allpass error, their
+ *        outputs are summed coherently.
+ *
+ * @param vc case
+ * @param in_rms RMS error of the network input in LSB, 0 when it is the input of the case
+ * @return double LSB
+ */
+static double rms_noise(const verify_case_t *vc, double in_rms)
+{
+    double ap = in_rms * in_rms;
+    double sum = 0.0;
+
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        ap += 2.0;
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        double g = vc->params.g_comb[k];
+
+        sum += sqrt((ap + 1.0) / (1.0 - g * g));
+    }
+    return fabs(vc->wet * vc->volume * 0.25) * sum + 1.0 + VERIFY_SLACK;
+}
+
+/**
+ * @brief Length of the next call of a kernel: random, up to three blocks
+ *
+ * @param state random state
+ * @param block block of the case
+ * @param left samples (or frames) still to process
+ * @return uint32_t samples
+ */
+static uint32_t call_length(uint64_t *state, uint32_t block, uint32_t left)
+{
+    uint32_t len = 1 + (uint32_t)(rand_unit(state) * 3 * block);
+
+    return (len > left) ? left : len;
+}
+
+/**
+ * @brief Run an instance over the input of the case, with calls of random lengths (up to three
+ *        blocks), and copy its output to w->out
+ *
+ * @param rv instance
+ * @param w scratch of the worker
+ * @param vc case
+ * @param f32 use jcrev_process_f32()
+ * @param upd NULL to set the output stage of the case, else the mailbox the settings are fetched
+ *            from before each call; the settings in use are posted again now and then, which
+ *            starts a transition to the same settings
+ */
+static void feed(jcrev_t *rv, verify_worker_t *w, const verify_case_t *vc, uint8_t f32, verify_updates_t *upd)
+{
+    uint64_t state = vc->seed ^ 0x5bd1e995ull;
+    uint64_t repost = vc->seed ^ 0x27d4eb2full;
+    uint32_t len;
+
+    if (!upd)
+        jcrev_set_output(rv, vc->dry, vc->wet, vc->volume);
+    for (uint32_t pos = 0; pos < vc->n; pos += len)
+    {
+        len = call_length(&state, vc->block, vc->n - pos);
+        if (upd)
+        {
+            const jcrev_settings_t *settings;
+
+            if (rand_unit(&repost) * VERIFY_REPOST < 1.0f)
+                jcrev_mailbox_post(&upd->box, &upd->settings);
+            settings = jcrev_mailbox_fetch(&upd->box);
+            if (settings)
+                jcrev_update(rv, settings);
+        }
+        if (f32)
+            jcrev_process_f32(rv, &w->in_f32[pos], &w->out_f32[pos], len);
+        else
+            jcrev_process(rv, &w->in16[pos], &w->out16[pos], len);
+    }
+    for (uint32_t i = 0; i < vc->n; i++)
+        w->out[i] = f32 ? w->out_f32[i] * 32768.0 : w->out16[i];
+}
+
+/**
+ * @brief Responses of the half-band stages of the library, from silence: a decimator output for
+ *        an impulse on an even and on an odd input (the stage is invariant for shifts of two
+ *        inputs), an interpolator output for an impulse, and the L1 gain of the interpolation by 2
+ *        and by 4 (the largest over the output phases)
+ *
+ * @param hr responses
+ * @return uint8_t 0 if success, else the set up error of a stage
+ */
+static uint8_t halfband_probe(verify_halfband_t *hr)
+{
+    float mem[HALFBAND_TAPS + 2 * VERIFY_HB_PROBE + REVERB_MEM_ALIGN / sizeof(float)];
+    float in[2 * VERIFY_HB_PROBE];
+    float out[2 * VERIFY_HB_PROBE];
+    double up4[6 * VERIFY_HB_PROBE];
+    reverb_arena_t arena;
+    halfband_t hb;
+    uint8_t ret;
+
+    reverb_arena_init(&arena, mem, sizeof(mem));
+    ret = halfband_init(&hb, 2 * VERIFY_HB_PROBE, &arena);
+    if (ret)
+        return ret;
+    for (uint32_t odd = 0; odd < 2; odd++)
+    {
+        memset(in, 0, sizeof(in));
+        in[odd] = 1.0f;
+        halfband_reset(&hb);
+        halfband_decimate(&hb, in, out, 2 * VERIFY_HB_PROBE);
+        for (uint32_t m = 0; m < VERIFY_HB_PROBE; m++)
+            hr->dec[odd][m] = out[m];
+    }
+    memset(in, 0, sizeof(in));
+    in[0] = 1.0f;
+    halfband_reset(&hb);
+    halfband_interpolate(&hb, in, out, VERIFY_HB_PROBE);
+    for (uint32_t j = 0; j < 2 * VERIFY_HB_PROBE; j++)
+        hr->up[j] = out[j];
+
+    /* by 4: the response by 2 interpolated again */
+    memset(up4, 0, sizeof(up4));
+    for (uint32_t m = 0; m < 2 * VERIFY_HB_PROBE; m++)
+        for (uint32_t j = 0; j < 2 * VERIFY_HB_PROBE; j++)
+            up4[2 * m + j] += hr->up[m] * hr->up[j];
+    for (uint32_t factor = 2; factor <= JCREV_MULTIRATE_FACTOR_MAX; factor *= 2)
+    {
+        const double *r = (factor == 2) ? hr->up : up4;
+        uint32_t len = (factor == 2) ? 2 * VERIFY_HB_PROBE : 6 * VERIFY_HB_PROBE;
+
+        hr->gain[factor] = 0.0;
+        for (uint32_t p = 0; p < factor; p++)
+        {
+            double sum = 0.0;
+
+            for (uint32_t j = p; j < len; j += factor)
+                sum += fabs(r[j]);
+            hr->gain[factor] = fmax(hr->gain[factor], sum);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Memory of any case in each tier: the longest delays at JCREV_RATE_MAX, the block buffers
+ *        and the windows of the slow lines
+ *
+ * @return size_t bytes
+ */
+static size_t tier_size(void)
+{
+    size_t samples = (2 + 2 * (JCREV_COMBS + JCREV_ALLPASSES)) * (size_t)VERIFY_BLOCK_MAX;
+
+    samples += JCREV_COMBS * ((size_t)ceilf(VERIFY_COMB_MS_MAX * JCREV_RATE_MAX / 1000.0f) + VERIFY_LINE_SLACK);
+    samples += JCREV_ALLPASSES * ((size_t)ceilf(VERIFY_AP_MS_MAX * JCREV_RATE_MAX / 1000.0f) + VERIFY_LINE_SLACK);
+    return samples * sizeof(int32_t) + 4 * (JCREV_COMBS + JCREV_ALLPASSES) * REVERB_MEM_ALIGN;
+}
+
+static uint8_t run_jcrev(verify_worker_t *w, const verify_case_t *vc)
+{
+    reverb_mem_t mem;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_init(&rv, &vc->params, vc->block, &mem);
+    if (!ret)
+        feed(&rv, w, vc, 0, NULL);
+    return ret;
+}
+
+/**
+ * @brief jcrev with every line not shorter than the block in the slow tier, read through windows
+ */
+static uint8_t run_jcrev_tiered(verify_worker_t *w, const verify_case_t *vc)
+{
+    reverb_mem_t mem;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, w->slow, w->size);
+    mem.slow_threshold = 1;
+    ret = jcrev_init(&rv, &vc->params, vc->block, &mem);
+    if (!ret)
+        feed(&rv, w, vc, 0, NULL);
+    return ret;
+}
+
+/**
+ * @brief jcrev set up at JCREV_RATE_MAX and switched to the rate of the case: the rings are longer
+ *        than the delays
+ */
+static uint8_t run_jcrev_rate(verify_worker_t *w, const verify_case_t *vc)
+{
+    reverb_mem_t mem;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_init_config(&rv, &vc->config, JCREV_RATE_MAX, vc->block, &mem);
+    if (!ret)
+        ret = jcrev_set_rate(&rv, vc->rate);
+    if (!ret)
+        feed(&rv, w, vc, 0, NULL);
+    return ret;
+}
+
+static uint8_t run_jcrev_f32(verify_worker_t *w, const verify_case_t *vc)
+{
+    reverb_mem_t mem;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_init(&rv, &vc->params, vc->block, &mem);
+    if (!ret)
+        feed(&rv, w, vc, 1, NULL);
+    return ret;
+}
+
+/**
+ * @brief jcrev with the silence gate at VERIFY_GATE_LEVEL and the shortest hold
+ */
+static uint8_t run_jcrev_gate(verify_worker_t *w, const verify_case_t *vc)
+{
+    reverb_mem_t mem;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_init(&rv, &vc->params, vc->block, &mem);
+    if (!ret)
+    {
+        jcrev_set_gate(&rv, VERIFY_GATE_LEVEL, 0);
+        feed(&rv, w, vc, 0, NULL);
+    }
+    return ret;
+}
+
+/**
+ * @brief Tolerance of the gated kernel: the reverb of what the gate drops on top of the
+ *        truncations. A bypassed block has an RMS level below the gate level, so its samples are
+ *        below the level times the square root of the block: this is the error of the network
+ *        input while bypassed, and the RMS error of this input is the level.
+ */
+static void gate_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    (void)w;
+    *bound = rounding_bound(vc, VERIFY_GATE_LEVEL * sqrt((double)vc->block));
+    *rms = VERIFY_RMS_FACTOR * rms_noise(vc, VERIFY_GATE_LEVEL);
+}
+
+/**
+ * @brief Settings drawn from those of the case: other gains and output stage, and delays shortened
+ *        by up to half
+ *
+ * @param vc case
+ * @param state random state
+ * @param settings other settings
+ */
+static void other_settings(const verify_case_t *vc, uint64_t *state, jcrev_settings_t *settings)
+{
+    for (int k = 0; k < JCREV_COMBS; k++)
+    {
+        settings->config.g_comb[k] = rand_gain(state, VERIFY_GAIN_DEFAULT);
+        settings->config.ms_comb[k] = vc->config.ms_comb[k] * rand_range(state, 0.5f, 1.0f);
+    }
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+    {
+        settings->config.g_ap[k] = rand_gain(state, VERIFY_GAIN_DEFAULT);
+        settings->config.ms_ap[k] = vc->config.ms_ap[k] * rand_range(state, 0.5f, 1.0f);
+    }
+    settings->dry = rand_range(state, 0.0f, 1.0f);
+    settings->wet = rand_range(state, 0.0f, 2.0f);
+    settings->volume = rand_range(state, 0.25f, 1.5f);
+}
+
+/**
+ * @brief jcrev started with other settings and moved to those of the case through the mailbox:
+ *        two settings are posted before the first block, the last one (the case) has to win. Its
+ *        transition runs over a block of silence, which leaves the lines silent, and from then on
+ *        the settings in use are posted again now and then (see feed()). After the transition the
+ *        instance has to be in the state of the case, so the bound of jcrev holds.
+ */
+static uint8_t run_jcrev_ramp(verify_worker_t *w, const verify_case_t *vc)
+{
+    static const int16_t silence[VERIFY_BLOCK_MAX];
+    uint64_t state = vc->seed ^ 0x9e3779b9ull;
+    reverb_mem_t mem;
+    verify_updates_t upd;
+    jcrev_settings_t start;
+    jcrev_settings_t other;
+    jcrev_t rv;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_init_config(&rv, &vc->config, vc->rate, vc->block, &mem);
+    if (ret)
+        return ret;
+
+    /* delays which do not fit the lines sized for the case are kept */
+    other_settings(vc, &state, &start);
+    if (jcrev_load(&rv, &start))
+    {
+        start.config = vc->config;
+        jcrev_load(&rv, &start);
+    }
+    other_settings(vc, &state, &other);
+    upd.settings.config = vc->config;
+    upd.settings.dry = vc->dry;
+    upd.settings.wet = vc->wet;
+    upd.settings.volume = vc->volume;
+
+    jcrev_mailbox_init(&upd.box, &start);
+    jcrev_mailbox_post(&upd.box, &other);
+    jcrev_mailbox_post(&upd.box, &upd.settings);
+    ret = jcrev_update(&rv, jcrev_mailbox_fetch(&upd.box));
+    if (!ret)
+    {
+        jcrev_process(&rv, silence, w->out16, vc->block);
+        feed(&rv, w, vc, 0, &upd);
+    }
+    return ret;
+}
+
+/**
+ * @brief Pattern of early reflections of a case: 1 to EARLY_TAPS_MAX taps, some of them on the
+ *        current sample, half of them damped, the sum of the |gains| scaled to at most
+ *        VERIFY_ER_L1_MAX, and the send of the reflections to the network
+ *
+ * @param vc case
+ * @param config pattern
+ * @param send level of the reflections in the network input
+ */
+static void er_draw(const verify_case_t *vc, early_config_t *config, float *send)
+{
+    uint64_t state = vc->seed ^ 0xc2b2ae35ull;
+    float l1 = 0.0f;
+    float scale;
+
+    memset(config, 0, sizeof(*config));
+    config->taps = 1 + (uint32_t)(rand_unit(&state) * EARLY_TAPS_MAX);
+    config->predelay_ms = (rand_unit(&state) < 0.5f) ? 0.0f : rand_range(&state, 0.0f, VERIFY_ER_PREDELAY_MAX);
+    for (uint32_t t = 0; t < config->taps; t++)
+    {
+        early_tap_t *tap = &config->tap[t];
+
+        tap->ms = (rand_unit(&state) < 0.1f) ? 0.0f : rand_log(&state, VERIFY_AP_MS_MIN, VERIFY_ER_MS_MAX);
+        tap->gain = rand_gain(&state, 1.0f);
+        tap->damp = (rand_unit(&state) < 0.5f) ? 0.0f : rand_range(&state, 0.0f, VERIFY_ER_DAMP_MAX);
+        l1 += fabsf(tap->gain);
+    }
+    scale = (l1 > 0.0f) ? rand_range(&state, 0.05f, VERIFY_ER_L1_MAX) / l1 : 0.0f;
+    for (uint32_t t = 0; t < config->taps; t++)
+        config->tap[t].gain *= scale;
+    *send = rand_range(&state, 0.0f, 1.0f);
+}
+
+/**
+ * @brief jcrev with an early reflections stage of the rate of the case, its line in the slow
+ *        buffer of the worker
+ */
+static uint8_t run_jcrev_early(verify_worker_t *w, const verify_case_t *vc)
+{
+    early_config_t config;
+    reverb_arena_t arena;
+    reverb_mem_t mem;
+    early_t er;
+    jcrev_t rv;
+    float send;
+    uint8_t ret;
+
+    er_draw(vc, &config, &send);
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    reverb_arena_init(&arena, w->slow, w->size);
+    ret = jcrev_init(&rv, &vc->params, vc->block, &mem);
+    if (!ret)
+        ret = early_init(&er, &config, vc->rate, vc->rate, vc->block, &arena);
+    if (!ret)
+        ret = jcrev_set_early(&rv, &er, send);
+    if (!ret)
+        feed(&rv, w, vc, 0, NULL);
+    return ret;
+}
+
+/**
+ * @brief Reference of jcrev with early reflections: er[n] = sum(g·lp(x[n - d])) with the delays
+ *        rounded like early.c, the network on x + send·er without its dry path, then
+ *        volume·(dry·x + wet·er) added for the reflections in the wet signal
+ */
+static void ref_jcrev_early(verify_worker_t *w, const verify_case_t *vc)
+{
+    double *er = w->aux[0];
+    double *x = w->aux[1];
+    early_config_t config;
+    float send;
+
+    er_draw(vc, &config, &send);
+    memset(er, 0, vc->n * sizeof(double));
+    for (uint32_t t = 0; t < config.taps; t++)
+    {
+        const early_tap_t *tap = &config.tap[t];
+        uint32_t d = (uint32_t)((config.predelay_ms + tap->ms) * vc->rate / 1000.0f + 0.5f);
+        double damp = tap->damp;
+        double y = 0.0;
+
+        for (uint32_t i = d; i < vc->n; i++)
+        {
+            y = (1.0 - damp) * w->in[i - d] + damp * y;
+            er[i] += tap->gain * y;
+        }
+    }
+    for (uint32_t i = 0; i < vc->n; i++)
+        x[i] = w->in[i] + send * er[i];
+    jcrev_ref_process(&vc->params, 0.0, vc->wet, vc->volume, x, w->kref, vc->n, w->work);
+    for (uint32_t i = 0; i < vc->n; i++)
+        w->kref[i] += vc->volume * ((double)vc->dry * w->in[i] + (double)vc->wet * er[i]);
+}
+
+/**
+ * @brief Tolerance of jcrev with early reflections: the float sum of the taps is within
+ *        (taps + 2) units of roundoff of the sum of their magnitudes, a damped tap adds 3 units
+ *        through the gain 1 / (1 - damp) of its filter, and the sum is truncated. This error of
+ *        the reflections reaches the network input times the send, with the truncation of the
+ *        send, and the output through the wet gain.
+ */
+static void er_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    early_config_t config;
+    double l1 = 0.0;
+    double damped = 0.0;
+    double er_err;
+    float send;
+
+    (void)w;
+    er_draw(vc, &config, &send);
+    for (uint32_t t = 0; t < config.taps; t++)
+    {
+        l1 += fabs(config.tap[t].gain);
+        damped += fabs(config.tap[t].gain) * 3.0 / (1.0 - config.tap[t].damp);
+    }
+    er_err = 1.0 + ((config.taps + 2) * l1 + damped) * (FLT_EPSILON / 2.0) * 32768.0;
+    *bound = rounding_bound(vc, send * er_err + 1.0) + fabs(vc->wet * vc->volume) * er_err;
+    *rms = VERIFY_RMS_FACTOR * (rms_noise(vc, send * er_err + 1.0) + fabs(vc->wet * vc->volume) * er_err);
+}
+
+/**
+ * @brief Multirate engine, network at 1/factor of the rate: the output stage of the case, calls
+ *        of random lengths
+ */
+static uint8_t run_jcrev_mr(verify_worker_t *w, const verify_case_t *vc, uint32_t factor)
+{
+    uint64_t state = vc->seed ^ 0x5bd1e995ull;
+    reverb_mem_t mem;
+    jcrev_multirate_t mr;
+    uint32_t len;
+    uint8_t ret;
+
+    reverb_mem_init(&mem, w->fast, w->size, NULL, 0);
+    ret = jcrev_multirate_init(&mr, &vc->config, vc->rate, factor, vc->block, &mem);
+    if (ret)
+        return ret;
+    jcrev_multirate_set_output(&mr, vc->dry, vc->wet, vc->volume);
+    for (uint32_t pos = 0; pos < vc->n; pos += len)
+    {
+        len = call_length(&state, vc->block, vc->n - pos);
+        jcrev_multirate_process(&mr, &w->in16[pos], &w->out16[pos], len);
+    }
+    for (uint32_t i = 0; i < vc->n; i++)
+        w->out[i] = w->out16[i];
+    return 0;
+}
+
+static uint8_t run_jcrev_mr2(verify_worker_t *w, const verify_case_t *vc)
+{
+    return run_jcrev_mr(w, vc, 2);
+}
+
+static uint8_t run_jcrev_mr4(verify_worker_t *w, const verify_case_t *vc)
+{
+    return run_jcrev_mr(w, vc, 4);
+}
+
+/**
+ * @brief Saturate a signal to int16 like the engines, without rounding
+ */
+static void clip16(double *x, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        x[i] = (x[i] > INT16_MAX) ? INT16_MAX : ((x[i] < INT16_MIN) ? INT16_MIN : x[i]);
+}
+
+/**
+ * @brief Decimation by 2 of a whole signal with the probed responses, from silence
+ *
+ * @param x input samples
+ * @param y output samples, not the same buffer as x
+ * @param n number of input samples
+ * @return uint32_t number of output samples, n / 2 like the stage
+ */
+static uint32_t ref_decimate(const double *x, double *y, uint32_t n)
+{
+    uint32_t count = n / 2;
+
+    memset(y, 0, count * sizeof(double));
+    for (uint32_t i = 0; i < n; i++)
+        for (uint32_t m = i / 2; (m < count) && (m - i / 2 < VERIFY_HB_PROBE); m++)
+            y[m] += x[i] * halfband_ref.dec[i & 1][m - i / 2];
+    return count;
+}
+
+/**
+ * @brief Interpolation by 2 of a whole signal with the probed response, from silence
+ *
+ * @param x input samples
+ * @param n number of input samples
+ * @param y output samples, not the same buffer as x
+ * @param nout number of output samples computed, up to 2n
+ */
+static void ref_interpolate(const double *x, uint32_t n, double *y, uint32_t nout)
+{
+    memset(y, 0, nout * sizeof(double));
+    for (uint32_t m = 0; (m < n) && (2 * m < nout); m++)
+        for (uint32_t j = 2 * m; (j < nout) && (j - 2 * m < 2 * VERIFY_HB_PROBE); j++)
+            y[j] += x[m] * halfband_ref.up[j - 2 * m];
+}
+
+/**
+ * @brief Reference of the multirate engine: the send decimated and saturated, the network at the
+ *        low rate saturated, interpolated and delayed by the factor - 1 zeros the queue starts
+ *        with, then mixed with the dry signal
+ */
+static void ref_jcrev_mr(verify_worker_t *w, const verify_case_t *vc, uint32_t factor)
+{
+    jcrev_params_t params;
+    double *low = w->stage[factor == 4];
+    double *wet = w->stage[factor != 4];
+    uint32_t lag = factor - 1;
+    uint32_t count;
+
+    count = ref_decimate(w->in, w->stage[0], vc->n);
+    if (factor == 4)
+        count = ref_decimate(w->stage[0], w->stage[1], count);
+    clip16(low, count);
+    jcrev_params_from_config(&vc->config, vc->rate / factor, &params);
+    jcrev_ref_process(&params, 0.0, vc->wet, vc->volume, low, wet, count, w->work);
+    clip16(wet, count);
+
+    if (factor == 4)
+    {
+        ref_interpolate(w->stage[0], count, w->stage[1], 2 * count);
+        wet = w->stage[1];
+        count *= 2;
+    }
+    ref_interpolate(wet, count, &w->kref[lag], (vc->n > lag) ? vc->n - lag : 0);
+    for (uint32_t i = 0; i < vc->n; i++)
+        w->kref[i] = (double)vc->dry * vc->volume * w->in[i] + ((i < lag) ? 0.0 : w->kref[i]);
+}
+
+static void ref_jcrev_mr2(verify_worker_t *w, const verify_case_t *vc)
+{
+    ref_jcrev_mr(w, vc, 2);
+}
+
+static void ref_jcrev_mr4(verify_worker_t *w, const verify_case_t *vc)
+{
+    ref_jcrev_mr(w, vc, 4);
+}
+
+/**
+ * @brief Tolerance of the multirate engine: the bound of the network at the low rate, with the
+ *        rounding of its input (0.5 LSB and the float accumulation of the decimators), through the
+ *        L1 gain of the interpolation, then the truncation of the output
+ */
+static void mr_tolerance(const verify_case_t *vc, uint32_t factor, double *bound, double *rms)
+{
+    verify_case_t low = *vc;
+    double gain = halfband_ref.gain[factor];
+
+    low.rate = vc->rate / factor;
+    jcrev_params_from_config(&vc->config, low.rate, &low.params);
+    *bound = gain * (rounding_bound(&low, 0.5 + VERIFY_HB_ACC) + VERIFY_HB_ACC) + 1.0 + VERIFY_SLACK;
+    *rms = VERIFY_RMS_FACTOR * (gain * rms_noise(&low, 0.5) + 1.0);
+}
+
+static void mr2_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    (void)w;
+    mr_tolerance(vc, 2, bound, rms);
+}
+
+static void mr4_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    (void)w;
+    mr_tolerance(vc, 4, bound, rms);
+}
+
+/**
+ * @brief Output rate of the resampler on a case, any of the rates
+ */
+static uint32_t rs_out_rate(const verify_case_t *vc)
+{
+    uint64_t state = vc->seed ^ 0x85ebca6bull;
+
+    return rates[(uint32_t)(rand_unit(&state) * (sizeof(rates) / sizeof(rates[0])))];
+}
+
+/**
+ * @brief Shape of the converter between two rates, as resample_init() sets it: the reduced
+ *        ratio L / M and the taps of a phase (2 · RESAMPLE_ZEROS periods of the lower rate, rounded
+ *        up to a multiple of VERIFY_RS_LANES)
+ *
+ * @param in_rate input rate
+ * @param out_rate output rate
+ * @param up L
+ * @param down M
+ * @return uint32_t taps
+ */
+static uint32_t rs_shape(uint32_t in_rate, uint32_t out_rate, uint32_t *up, uint32_t *down)
+{
+    uint32_t a = in_rate;
+    uint32_t b = out_rate;
+    uint32_t span;
+
+    while (b)
+    {
+        uint32_t t = a % b;
+
+        a = b;
+        b = t;
+    }
+    *up = out_rate / a;
+    *down = in_rate / a;
+    span = (2 * RESAMPLE_ZEROS * ((*up > *down) ? *up : *down) + *up - 1) / *up;
+    return (span + VERIFY_RS_LANES - 1) / VERIFY_RS_LANES * VERIFY_RS_LANES;
+}
+
+/**
+ * @brief Largest number of coefficients of the resampler reference over every pair of rates
+ */
+static size_t rs_coef_max(void)
+{
+    size_t count = 0;
+
+    for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+    {
+        for (uint32_t o = 0; o < sizeof(rates) / sizeof(rates[0]); o++)
+        {
+            uint32_t up;
+            uint32_t down;
+            uint32_t taps = rs_shape(rates[i], rates[o], &up, &down);
+
+            count = ((size_t)up * taps > count) ? (size_t)up * taps : count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Modified Bessel function of the first kind, order 0
+ */
+static double bessel_i0(double x)
+{
+    double term = 1.0;
+    double sum = 1.0;
+
+    for (int k = 1; term > sum * 1e-15; k++)
+    {
+        term *= (x * x) / (4.0 * k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * @brief Sample rate converter from the rate of the case to another one, float samples, calls of
+ *        random lengths. A number of output samples other than ceil(n · L / M) fails the case:
+ *        every sample is then set VERIFY_MISSING away.
+ */
+static uint8_t run_resample(verify_worker_t *w, const verify_case_t *vc)
+{
+    uint64_t state = vc->seed ^ 0x5bd1e995ull;
+    uint32_t out_rate = rs_out_rate(vc);
+    uint32_t up;
+    uint32_t down;
+    uint32_t count = 0;
+    uint32_t len;
+    reverb_arena_t arena;
+    resample_t rs;
+    uint8_t ret;
+
+    rs_shape(vc->rate, out_rate, &up, &down);
+    w->n_out = (uint32_t)(((uint64_t)vc->n * up + down - 1) / down);
+    reverb_arena_init(&arena, w->fast, w->size);
+    ret = resample_init(&rs, vc->rate, out_rate, 3 * vc->block, &arena);
+    if (ret)
+        return ret;
+    for (uint32_t pos = 0; pos < vc->n; pos += len)
+    {
+        len = call_length(&state, vc->block, vc->n - pos);
+        count += resample_process(&rs, &w->in_f32[pos], &w->out_f32[count], len);
+    }
+    /* saturated like the reference in compare() */
+    for (uint32_t i = 0; i < w->n_out; i++)
+    {
+        double y = w->out_f32[i] * 32768.0;
+
+        y = (y > INT16_MAX) ? INT16_MAX : ((y < INT16_MIN) ? INT16_MIN : y);
+        w->out[i] = (count != w->n_out) ? VERIFY_MISSING : y;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reference of the resampler in double precision: the Kaiser windowed-sinc prototype cut at
+ *        VERIFY_RS_CUTOFF of the lower rate, each phase normalised to a gain of 1, and
+ *        y[j] = sum(h[k · L + p] · x[i - k]) with i = floor(j · M / L) and p = j · M mod L. The L1
+ *        gain of the phases goes to w->kref_gain.
+ */
+static void ref_resample(verify_worker_t *w, const verify_case_t *vc)
+{
+    uint32_t up;
+    uint32_t down;
+    uint32_t taps = rs_shape(vc->rate, rs_out_rate(vc), &up, &down);
+    double centre = 0.5 * ((double)up * taps - 1.0);
+    double fc = VERIFY_RS_CUTOFF / ((up > down) ? up : down);
+    double norm = 1.0 / bessel_i0(VERIFY_RS_BETA);
+
+    w->kref_gain = 0.0;
+    for (uint32_t p = 0; p < up; p++)
+    {
+        double *h = &w->coef[(size_t)p * taps];
+        double sum = 0.0;
+        double l1 = 0.0;
+
+        for (uint32_t k = 0; k < taps; k++)
+        {
+            double t = (double)k * up + p - centre;
+            double r = t / centre;
+            double win = (r * r < 1.0) ? bessel_i0(VERIFY_RS_BETA * sqrt(1.0 - r * r)) * norm : 0.0;
+
+            h[k] = (t == 0.0) ? win : win * sin(2.0 * M_PI * fc * t) / (2.0 * M_PI * fc * t);
+            sum += h[k];
+        }
+        for (uint32_t k = 0; k < taps; k++)
+        {
+            h[k] /= sum;
+            l1 += fabs(h[k]);
+        }
+        w->kref_gain = fmax(w->kref_gain, l1);
+    }
+
+    for (uint32_t j = 0; j < w->n_out; j++)
+    {
+        uint32_t i = (uint32_t)((uint64_t)j * down / up);
+        const double *h = &w->coef[(uint64_t)j * down % up * taps];
+        double y = 0.0;
+
+        for (uint32_t k = 0; (k < taps) && (k <= i); k++)
+            y += h[k] * w->in[i - k];
+        w->kref[j] = y;
+    }
+}
+
+/**
+ * @brief Tolerance of the resampler: float rounding only. A coefficient is within 3 units of
+ *        roundoff of the normalised one, a dot product within taps / VERIFY_RS_LANES + 4 of the
+ *        sum of the magnitudes of its products (the lanes, then their pairwise sum), and this sum
+ *        is below the L1 gain of the phases times full scale. One more unit covers the second
+ *        order terms.
+ */
+static void rs_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    uint32_t up;
+    uint32_t down;
+    uint32_t taps = rs_shape(vc->rate, rs_out_rate(vc), &up, &down);
+
+    *bound = (taps / VERIFY_RS_LANES + 8) * (FLT_EPSILON / 2.0) * w->kref_gain * 32768.0;
+    *rms = *bound;
+}
+
+/**
+ * @brief Norms of a section from its impulse response, run until its states are negligible
+ *
+ * @param c b0, b1, b2, a1, a2
+ * @param h_l1 L1 norm of the section
+ * @param inv_l1 L1 norm of its recursion 1 / A(z), the gain from a rounding to its output
+ * @param inv_l2 L2 norm of its recursion
+ */
+static void section_norms(const double c[5], double *h_l1, double *inv_l1, double *inv_l2)
+{
+    double s1 = 0.0;
+    double s2 = 0.0;
+    double r1 = 0.0;
+    double r2 = 0.0;
+
+    *h_l1 = 0.0;
+    *inv_l1 = 0.0;
+    *inv_l2 = 0.0;
+    for (uint32_t i = 0; i < VERIFY_BQ_IMPULSE_MAX; i++)
+    {
+        double x = (i == 0) ? 1.0 : 0.0;
+        double y = c[0] * x + s1;
+        double r = x + r1;
+
+        s1 = c[1] * x - c[3] * y + s2;
+        s2 = c[2] * x - c[4] * y;
+        r1 = -c[3] * r + r2;
+        r2 = -c[4] * r;
+        *h_l1 += fabs(y);
+        *inv_l1 += fabs(r);
+        *inv_l2 += r * r;
+        if ((i > 2) && (fabs(s1) + fabs(s2) + fabs(r1) + fabs(r2) < 1e-15 * (*h_l1 + *inv_l1)))
+            break;
+    }
+    *inv_l2 = sqrt(*inv_l2);
+}
+
+/**
+ * @brief Draw the cascade of a case: 1 to BIQUAD_LANES channels, 1 to BIQUAD_STAGES_MAX sections
+ *        of every RBJ design, the same on every channel one time out of four. With X and Y the
+ *        bounds of the input and of the output of a section (the peak of the input times the L1
+ *        norms of the sections up to there), its states are below Y + |b0|·X and |b2|·X + |a2|·Y:
+ *        the input is scaled so that every one stays within VERIFY_BQ_HEADROOM of full scale, and
+ *        the Q31 cascade never saturates.
+ *
+ * @param vc case
+ * @param peak largest |input| of the case
+ * @param q31 reference coefficients in Q2.29 like biquad_q31_set(), else the float ones
+ * @param bq cascade
+ * @return uint8_t 0 if success, 3 if a design fails
+ */
+static uint8_t bq_draw(const verify_case_t *vc, double peak, uint8_t q31, verify_biquad_t *bq)
+{
+    uint64_t state = vc->seed ^ 0x1b873593ull;
+    double need = 0.0;
+
+    bq->channels = 1 + (uint32_t)(rand_unit(&state) * BIQUAD_LANES);
+    bq->stages = 1 + (uint32_t)(rand_unit(&state) * BIQUAD_STAGES_MAX);
+    bq->shared = rand_unit(&state) < 0.25f;
+    bq->q31 = q31;
+    for (uint32_t l = 0; l < bq->channels; l++)
+    {
+        double x = 1.0;
+
+        for (uint32_t s = 0; s < bq->stages; s++)
+        {
+            biquad_coef_t *coef = &bq->coef[l][s];
+            biquad_type_t type = (biquad_type_t)(rand_unit(&state) * (BIQUAD_HIGHSHELF + 1));
+            float f0 = rand_log(&state, VERIFY_BQ_F0_MIN, VERIFY_BQ_F0_MAX * vc->rate);
+            float q = rand_log(&state, VERIFY_BQ_Q_MIN, VERIFY_BQ_Q_MAX);
+            float gain_db = rand_range(&state, -VERIFY_BQ_GAIN_DB, VERIFY_BQ_GAIN_DB);
+            const float *f = &coef->b0;
+            double *c = bq->c[l][s];
+            double y;
+
+            if (bq->shared && l)
+                *coef = bq->coef[0][s];
+            else if (biquad_design(coef, type, vc->rate, f0, q, gain_db))
+                return 3;
+            for (int k = 0; k < 5; k++)
+                c[k] = q31 ? ldexp((double)lrint(ldexp(f[k], BIQUAD_Q31_SHIFT)), -BIQUAD_Q31_SHIFT) : f[k];
+            section_norms(c, &bq->h_l1[l][s], &bq->inv_l1[l][s], &bq->inv_l2[l][s]);
+
+            /* bounds of the signals for an input peak of 1 */
+            y = x * bq->h_l1[l][s];
+            need = fmax(need, fmax(y + fabs(c[0]) * x, fabs(c[2]) * x + fabs(c[4]) * y));
+            x = y;
+        }
+    }
+    bq->atten = (peak * need > VERIFY_BQ_HEADROOM * INT16_MAX) ? VERIFY_BQ_HEADROOM * INT16_MAX / (peak * need) : 1.0;
+    return 0;
+}
+
+/**
+ * @brief Input of the cascade, the int16 input of the case scaled by the attenuation of the draw
+ */
+static int16_t bq_input(const verify_worker_t *w, uint32_t i)
+{
+    return (int16_t)lrint(w->in16[i] * w->bq.atten);
+}
+
+/**
+ * @brief Cascade of the case over interleaved frames (the input of the case cut into frames), calls
+ *        of random lengths, in place
+ *
+ * @param w scratch of the worker, the cascade drawn in w->bq
+ * @param vc case
+ * @param q31 biquad_q31_process(), else biquad_f32_process()
+ * @return uint8_t 0 if success, else the set up error
+ */
+static uint8_t run_biquad(verify_worker_t *w, const verify_case_t *vc, uint8_t q31)
+{
+    uint64_t state = vc->seed ^ 0x5bd1e995ull;
+    verify_biquad_t *bq = &w->bq;
+    biquad_f32_t f32;
+    biquad_q31_t fixed;
+    double peak = 0.0;
+    uint32_t frames;
+    uint32_t len;
+    uint8_t ret;
+
+    for (uint32_t i = 0; i < vc->n; i++)
+        peak = fmax(peak, fabs(w->in[i]));
+    ret = bq_draw(vc, peak, q31, bq);
+    if (ret)
+        return ret;
+    frames = vc->n / bq->channels;
+    w->n_out = frames * bq->channels;
+
+    ret = q31 ? biquad_q31_init(&fixed, bq->channels, bq->stages) : biquad_f32_init(&f32, bq->channels, bq->stages);
+    for (uint32_t s = 0; !ret && (s < bq->stages); s++)
+    {
+        for (uint32_t l = 0; !ret && (l < (bq->shared ? 1 : bq->channels)); l++)
+        {
+            uint32_t ch = bq->shared ? BIQUAD_ALL : l;
+
+            ret = q31 ? biquad_q31_set(&fixed, s, ch, &bq->coef[l][s]) : biquad_f32_set(&f32, s, ch, &bq->coef[l][s]);
+        }
+    }
+    if (ret)
+        return ret;
+
+    for (uint32_t i = 0; i < w->n_out; i++)
+    {
+        w->out16[i] = bq_input(w, i);
+        w->out_f32[i] = w->out16[i] * (1.0f / 32768.0f);
+    }
+    for (uint32_t pos = 0; pos < frames; pos += len)
+    {
+        len = call_length(&state, vc->block, frames - pos);
+        if (q31)
+            biquad_q31_process(&fixed, &w->out16[pos * bq->channels], &w->out16[pos * bq->channels], len);
+        else
+            biquad_f32_process(&f32, &w->out_f32[pos * bq->channels], &w->out_f32[pos * bq->channels], len);
+    }
+    for (uint32_t i = 0; i < w->n_out; i++)
+        w->out[i] = q31 ? w->out16[i] : w->out_f32[i] * 32768.0;
+    return 0;
+}
+
+static uint8_t run_biquad_f32(verify_worker_t *w, const verify_case_t *vc)
+{
+    return run_biquad(w, vc, 0);
+}
+
+static uint8_t run_biquad_q31(verify_worker_t *w, const verify_case_t *vc)
+{
+    return run_biquad(w, vc, 1);
+}
+
+/**
+ * @brief Reference of the cascades: the sections in double precision, channel after channel, with
+ *        the coefficients drawn by the kernel. The peaks of the signals of each section give the
+ *        error: half a Q31 LSB (2^-16 LSB of int16) for each of its three roundings, or the float
+ *        roundings of its three lines, reach its output through 1 / A(z) and then go through the
+ *        sections after it. The RMS error takes the L2 norm of 1 / A(z) instead.
+ */
+static void ref_biquad(verify_worker_t *w, const verify_case_t *vc)
+{
+    verify_biquad_t *bq = &w->bq;
+
+    (void)vc;
+    bq->bound = 0.0;
+    bq->rms = 0.0;
+    for (uint32_t l = 0; l < bq->channels; l++)
+    {
+        double s1[BIQUAD_STAGES_MAX] = {0.0};
+        double s2[BIQUAD_STAGES_MAX] = {0.0};
+        double peak[BIQUAD_STAGES_MAX][4] = {{0.0}}; /* x, y, s1, s2 */
+        double err = 0.0;
+        double rms = 0.0;
+
+        for (uint32_t i = l; i < w->n_out; i += bq->channels)
+        {
+            double x = bq_input(w, i);
+
+            for (uint32_t s = 0; s < bq->stages; s++)
+            {
+                const double *c = bq->c[l][s];
+                double y = c[0] * x + s1[s];
+
+                s1[s] = c[1] * x - c[3] * y + s2[s];
+                s2[s] = c[2] * x - c[4] * y;
+                peak[s][0] = fmax(peak[s][0], fabs(x));
+                peak[s][1] = fmax(peak[s][1], fabs(y));
+                peak[s][2] = fmax(peak[s][2], fabs(s1[s]));
+                peak[s][3] = fmax(peak[s][3], fabs(s2[s]));
+                x = y;
+            }
+            w->kref[i] = x;
+        }
+
+        for (uint32_t s = 0; s < bq->stages; s++)
+        {
+            const double *c = bq->c[l][s];
+            const double *p = peak[s];
+            double local = bq->q31 ? 1.5 * ldexp(1.0, -16)
+                                   : (FLT_EPSILON / 2.0) * ((fabs(c[0]) + 2.0 * fabs(c[1]) + fabs(c[2])) * p[0] +
+                                                            (1.0 + 2.0 * fabs(c[3]) + fabs(c[4])) * p[1] + p[2] + p[3]);
+
+            err = err * bq->h_l1[l][s] + local * bq->inv_l1[l][s];
+            rms = rms * bq->h_l1[l][s] + local * bq->inv_l2[l][s];
+        }
+        bq->bound = fmax(bq->bound, err);
+        bq->rms = fmax(bq->rms, rms);
+    }
+    /* the Q31 cascade rounds its output to int16, the float one keeps the first order terms only */
+    if (bq->q31)
+    {
+        bq->bound += 0.5 + VERIFY_BQ_SLACK;
+        bq->rms = VERIFY_RMS_FACTOR * bq->rms + 0.5 + VERIFY_BQ_SLACK;
+    }
+    else
+    {
+        bq->bound = VERIFY_BQ_ORDER * bq->bound + VERIFY_BQ_SLACK;
+        bq->rms = VERIFY_BQ_ORDER * VERIFY_RMS_FACTOR * bq->rms + VERIFY_BQ_SLACK;
+    }
+}
+
+/**
+ * @brief Tolerance of the cascades, computed by bq_draw()
+ */
+static void bq_tolerance(const verify_worker_t *w, const verify_case_t *vc, double *bound, double *rms)
+{
+    (void)vc;
+    *bound = w->bq.bound;
+    *rms = w->bq.rms;
+}
+
+/**
+ * @brief The legacy per-sample reverb(), wet signal only and with its own equations
+ */
+static uint8_t run_legacy(verify_worker_t *w, const verify_case_t *vc)
+{
+    const jcrev_params_t *p = &vc->params;
+    uint8_t ret;
+
+    for (int k = 0; k < JCREV_COMBS; k++)
+        if (p->m_comb[k] > INT16_MAX)
+            return 3;
+    for (int k = 0; k < JCREV_ALLPASSES; k++)
+        if (p->m_ap[k] > INT16_MAX)
+            return 3;
+
+    pthread_mutex_lock(&legacy_lock);
+    ret = reverb_init((int)p->m_comb[0]);
+    if (!ret)
+    {
+        for (uint32_t i = 0; i < vc->n; i++)
+            w->out[i] = reverb(w->in16[i], p->g_comb[0], p->g_comb[1], (int16_t)p->m_comb[1], p->g_comb[2],
+                               (int16_t)p->m_comb[2], p->g_comb[3], (int16_t)p->m_comb[3], p->g_ap[0],
+                               (int16_t)p->m_ap[0], p->g_ap[1], (int16_t)p->m_ap[1], p->g_ap[2], (int16_t)p->m_ap[2]);
+    }
+    reverb_deinit();
+    pthread_mutex_unlock(&legacy_lock);
+    return ret;
+}
+
+static const verify_kernel_t kernels[] = {
+    {"jcrev", run_jcrev, 1, NULL, NULL},
+    {"jcrev_tiered", run_jcrev_tiered, 1, NULL, NULL},
+    {"jcrev_rate", run_jcrev_rate, 1, NULL, NULL},
+    {"jcrev_f32", run_jcrev_f32, 1, NULL, NULL},
+    {"jcrev_ramp", run_jcrev_ramp, 1, NULL, NULL},
+    {"jcrev_gate", run_jcrev_gate, 1, gate_tolerance, NULL},
+    {"jcrev_early", run_jcrev_early, 1, er_tolerance, ref_jcrev_early},
+    {"jcrev_mr2", run_jcrev_mr2, 1, mr2_tolerance, ref_jcrev_mr2},
+    {"jcrev_mr4", run_jcrev_mr4, 1, mr4_tolerance, ref_jcrev_mr4},
+    {"resample", run_resample, 1, rs_tolerance, ref_resample},
+    {"biquad_f32", run_biquad_f32, 1, bq_tolerance, ref_biquad},
+    {"biquad_q31", run_biquad_q31, 1, bq_tolerance, ref_biquad},
+    {"legacy", run_legacy, 0, NULL, NULL},
+};
+
+#define KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+/**
+ * @brief Compare the output of a kernel with the reference saturated to int16 like the engines
+ *
+ * @param ref reference output
+ * @param out kernel output
+ * @param n number of samples
+ * @param res largest error, SNR and first divergence
+ */
+static void compare(const double *ref, const double *out, uint32_t n, verify_result_t *res)
+{
+    double sig = 0.0;
+    double noise = 0.0;
+
+    res->max_err = 0.0;
+    res->at = 0;
+    res->first = -1;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double r = (ref[i] > INT16_MAX) ? INT16_MAX : ((ref[i] < INT16_MIN) ? INT16_MIN : ref[i]);
+        double e = fabs(out[i] - r);
+
+        sig += r * r;
+        noise += e * e;
+        if (e > res->max_err)
+        {
+            res->max_err = e;
+            res->at = i;
+        }
+        if ((e > VERIFY_DIVERGE) && (res->first < 0))
+            res->first = i;
+    }
+    res->rms_err = n ? sqrt(noise / n) : 0.0;
+    res->snr = (noise > 0.0) ? 10.0 * log10(sig / noise) : INFINITY;
+}
+
+/**
+ * @brief Run the reference and every selected kernel on a case
+ *
+ * @param v verification
+ * @param w scratch of the calling worker
+ * @param c index of the case in v->cases
+ */
+static void run_case(verify_t *v, verify_worker_t *w, uint32_t c)
+{
+    const verify_case_t *vc = &v->cases[c];
+    verify_result_t *res = &v->results[(size_t)c * KERNELS];
+    double bound = rounding_bound(vc, 0.0);
+    double rms = VERIFY_RMS_FACTOR * rms_noise(vc, 0.0);
+
+    make_input(vc, w);
+    jcrev_ref_process(&vc->params, vc->dry, vc->wet, vc->volume, w->in, w->ref, vc->n, w->work);
+    for (uint32_t k = 0; k < KERNELS; k++)
+    {
+        if ((v->opts->kernel >= 0) && (k != (uint32_t)v->opts->kernel))
+            continue;
+        w->n_out = vc->n;
+        res[k].status = kernels[k].run(w, vc);
+        if (res[k].status)
+            continue;
+        if (kernels[k].reference)
+            kernels[k].reference(w, vc);
+        compare(kernels[k].reference ? w->kref : w->ref, w->out, w->n_out, &res[k]);
+        res[k].bound = kernels[k].checked ? bound : 0.0;
+        res[k].rms_max = kernels[k].checked ? rms : 0.0;
+        if (kernels[k].checked && kernels[k].tolerance)
+            kernels[k].tolerance(w, vc, &res[k].bound, &res[k].rms_max);
+        res[k].pass = !kernels[k].checked || ((res[k].max_err <= res[k].bound) && (res[k].rms_err <= res[k].rms_max));
+    }
+}
+
+/**
+ * @brief Pool job: run a chunk of cases with the scratch of the worker
+ *
+ * @param arg verify_job_t
+ * @param worker index of the thread
+ * @param ctx verify_t
+ */
+static void verify_job(void *arg, uint32_t worker, void *ctx)
+{
+    const verify_job_t *job = (const verify_job_t *)arg;
+    verify_t *v = (verify_t *)ctx;
+
+    for (uint32_t c = job->first; c < job->first + job->count; c++)
+        run_case(v, &v->workers[worker], c);
+}
+
+/**
+ * @brief Print the settings of a case
+ *
+ * @param index case number
+ * @param vc case
+ */
+static void print_case(uint32_t index, const verify_case_t *vc)
+{
+    const jcrev_params_t *p = &vc->params;
+
+    printf("case %u: %s %.1f dBFS, %u Hz, %u samples, block %u, dry %.3f wet %.3f volume %.3f\n", index,
+           signal_names[vc->signal], 20.0 * log10((double)vc->level), vc->rate, vc->n, vc->block, (double)vc->dry,
+           (double)vc->wet, (double)vc->volume);
+    printf("  combs     g %.4f,%.4f,%.4f,%.4f  M %u,%u,%u,%u\n", (double)p->g_comb[0], (double)p->g_comb[1],
+           (double)p->g_comb[2], (double)p->g_comb[3], p->m_comb[0], p->m_comb[1], p->m_comb[2], p->m_comb[3]);
+    printf("  allpasses g %.4f,%.4f,%.4f  M %u,%u,%u\n", (double)p->g_ap[0], (double)p->g_ap[1],
+           (double)p->g_ap[2], p->m_ap[0], p->m_ap[1], p->m_ap[2]);
+}
+
+/**
+ * @brief Print the comparison of one kernel on a case
+ *
+ * @param k kernel
+ * @param res result
+ */
+static void print_result(uint32_t k, const verify_result_t *res)
+{
+    printf("  %-12s ", kernels[k].name);
+    if (res->status)
+    {
+        printf("not run (%s)\n", (res->status == 1) ? "no memory" : "settings not supported");
+        return;
+    }
+    printf("max error %9.2f LSB at %-7u", res->max_err, res->at);
+    if (kernels[k].checked)
+        printf(" (bound %8.2f)  rms %7.2f (%7.2f)", res->bound, res->rms_err, res->rms_max);
+    else
+        printf(" %16s  rms %7.2f %9s", "", res->rms_err, "");
+    printf("  SNR %6.1f dB  first divergence ", res->snr);
+    if (res->first >= 0)
+        printf("%-7lld", (long long)res->first);
+    else
+        printf("%-7s", "-");
+    printf("  %s\n", !kernels[k].checked ? "other equations" : (res->pass ? "ok" : "FAIL"));
+}
+
+/**
+ * @brief Allocate the scratch of every worker
+ *
+ * @param v verification, v->workers set
+ * @param threads workers
+ * @param n longest signal
+ * @return uint8_t 0 if success, 1 if out of memory
+ */
+static uint8_t workers_alloc(verify_t *v, uint32_t threads, uint32_t n)
+{
+    v->workers = calloc(threads, sizeof(verify_worker_t));
+    if (!v->workers)
+        return 1;
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        verify_worker_t *w = &v->workers[t];
+
+        w->size = tier_size();
+        w->fast = malloc(w->size);
+        w->slow = malloc(w->size);
+        w->in16 = malloc(n * sizeof(int16_t));
+        w->out16 = malloc(n * sizeof(int16_t));
+        w->in_f32 = malloc(n * sizeof(float));
+        w->out_f32 = malloc(n * sizeof(float));
+        w->in = malloc(n * sizeof(double));
+        w->ref = malloc(n * sizeof(double));
+        w->out = malloc(n * sizeof(double));
+        w->work = malloc(JCREV_REF_WORK(n) * sizeof(double));
+        w->kref = malloc(n * sizeof(double));
+        w->stage[0] = malloc((n / 2 + 1) * sizeof(double));
+        w->stage[1] = malloc((n / 2 + 1) * sizeof(double));
+        w->coef = malloc(rs_coef_max() * sizeof(double));
+        w->aux[0] = malloc(n * sizeof(double));
+        w->aux[1] = malloc(n * sizeof(double));
+        if (!w->fast || !w->slow || !w->in16 || !w->out16 || !w->in_f32 || !w->out_f32 || !w->in || !w->ref ||
+            !w->out || !w->work || !w->kref || !w->stage[0] || !w->stage[1] || !w->coef ||
+            !w->aux[0] || !w->aux[1])
+            return 1;
+    }
+    return 0;
+}
+
+static void workers_free(verify_t *v, uint32_t threads)
+{
+    if (!v->workers)
+        return;
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        verify_worker_t *w = &v->workers[t];
+
+        free(w->fast);
+        free(w->slow);
+        free(w->in16);
+        free(w->out16);
+        free(w->in_f32);
+        free(w->out_f32);
+        free(w->in);
+        free(w->ref);
+        free(w->out);
+        free(w->work);
+        free(w->kref);
+        free(w->stage[0]);
+        free(w->stage[1]);
+        free(w->coef);
+        free(w->aux[0]);
+        free(w->aux[1]);
+    }
+    free(v->workers);
+}
+
+/**
+ * @brief Print every failing case (every case with -v), then the summary of each kernel
+ *
+ * @param v verification
+ * @return uint32_t failed kernel runs
+ */
+static uint32_t report(const verify_t *v)
+{
+    uint32_t failed = 0;
+
+    for (uint32_t c = 0; c < v->count; c++)
+    {
+        const verify_result_t *res = &v->results[(size_t)c * KERNELS];
+        uint8_t bad = 0;
+
+        for (uint32_t k = 0; k < KERNELS; k++)
+        {
+            if ((v->opts->kernel < 0) || (k == (uint32_t)v->opts->kernel))
+                bad |= kernels[k].checked && !res[k].status && !res[k].pass;
+        }
+        if (!bad && !v->opts->verbose)
+            continue;
+        print_case(v->first + c, &v->cases[c]);
+        for (uint32_t k = 0; k < KERNELS; k++)
+        {
+            if ((v->opts->kernel < 0) || (k == (uint32_t)v->opts->kernel))
+                print_result(k, &res[k]);
+        }
+        if (bad)
+            printf("  rerun with -s %llu -c %u\n", (unsigned long long)v->opts->seed, v->first + c);
+    }
+
+    printf("%-12s %6s %6s %6s %12s %11s %11s %9s %9s\n", "kernel", "cases", "not run", "failed", "max err LSB",
+           "err / bound", "rms / max", "min SNR", "mean SNR");
+    for (uint32_t k = 0; k < KERNELS; k++)
+    {
+        double max_err = 0.0;
+        double ratio = 0.0;
+        double rms_ratio = 0.0;
+        double snr_min = INFINITY;
+        double snr_sum = 0.0;
+        uint32_t finite = 0;
+        uint32_t ran = 0;
+        uint32_t skipped = 0;
+        uint32_t bad = 0;
+
+        if ((v->opts->kernel >= 0) && (k != (uint32_t)v->opts->kernel))
+            continue;
+        for (uint32_t c = 0; c < v->count; c++)
+        {
+            const verify_result_t *res = &v->results[(size_t)c * KERNELS + k];
+
+            if (res->status)
+            {
+                skipped++;
+                continue;
+            }
+            ran++;
+            bad += !res->pass;
+            max_err = fmax(max_err, res->max_err);
+            if (res->bound > 0.0)
+                ratio = fmax(ratio, res->max_err / res->bound);
+            if (res->rms_max > 0.0)
+                rms_ratio = fmax(rms_ratio, res->rms_err / res->rms_max);
+            snr_min = fmin(snr_min, res->snr);
+            if (isfinite(res->snr))
+            {
+                snr_sum += res->snr;
+                finite++;
+            }
+        }
+        printf("%-12s %6u %7u %6u %12.2f ", kernels[k].name, ran, skipped, bad, max_err);
+        if (kernels[k].checked)
+            printf("%11.3f %11.3f", ratio, rms_ratio);
+        else
+            printf("%11s %11s", "-", "-");
+        printf(" %9.1f %9.1f%s\n", ran ? snr_min : 0.0, finite ? snr_sum / finite : INFINITY,
+               kernels[k].checked ? "" : "  (other equations, not checked)");
+        failed += bad;
+    }
+    return failed;
+}
+
+/* ----- API function ---------------------------------------------------------------------------- */
+int main(int argc, char **argv)
+{
+    verify_opts_t opts = {VERIFY_COUNT_DEFAULT, VERIFY_LENGTH_DEFAULT, 1, 1, VERIFY_GAIN_DEFAULT, -1, -1, 0};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    verify_t v;
+    thread_pool_t pool;
+    verify_job_t *jobs = NULL;
+    uint32_t job_count;
+    uint32_t failed;
+    double start;
+    double wall;
+    int ret = 1;
+    int opt;
+
+    opts.threads = (cpus > 0) ? (uint32_t)cpus : 1;
+    while ((opt = getopt(argc, argv, "n:s:c:e:l:g:t:v")) != -1)
+    {
+        uint8_t bad = 0;
+
+        switch (opt)
+        {
+        case 'n':
+            opts.count = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.count;
+            break;
+        case 's':
+            opts.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'c':
+            opts.only = (int64_t)strtoul(optarg, NULL, 0);
+            opts.verbose = 1;
+            break;
+        case 'e':
+            bad = 1;
+            for (uint32_t k = 0; k < KERNELS; k++)
+            {
+                if (!strcmp(optarg, kernels[k].name))
+                {
+                    opts.kernel = (int32_t)k;
+                    bad = 0;
+                }
+            }
+            break;
+        case 'l':
+            opts.length_ms = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.length_ms || (opts.length_ms > VERIFY_LENGTH_MAX);
+            break;
+        case 'g':
+            opts.gain = strtof(optarg, NULL);
+            bad = !(opts.gain > 0.0f) || !(opts.gain < 1.0f);
+            break;
+        case 't':
+            opts.threads = (uint32_t)strtoul(optarg, NULL, 0);
+            bad = !opts.threads || (opts.threads > VERIFY_THREADS_MAX);
+            break;
+        case 'v':
+            opts.verbose = 1;
+            break;
+        default:
+            bad = 1;
+            break;
+        }
+        if (bad)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&v, 0, sizeof(v));
+    v.opts = &opts;
+    v.count = (opts.only >= 0) ? 1 : opts.count;
+    v.first = (opts.only >= 0) ? (uint32_t)opts.only : 0;
+    job_count = (v.count + VERIFY_CHUNK - 1) / VERIFY_CHUNK;
+    if (opts.threads > job_count)
+        opts.threads = job_count;
+
+    v.cases = malloc(v.count * sizeof(verify_case_t));
+    v.results = calloc((size_t)v.count * KERNELS, sizeof(verify_result_t));
+    jobs = malloc(job_count * sizeof(verify_job_t));
+    if (!v.cases || !v.results || !jobs ||
+        workers_alloc(&v, opts.threads, (uint32_t)((uint64_t)opts.length_ms * JCREV_RATE_MAX / 1000)))
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    if (halfband_probe(&halfband_ref))
+    {
+        fprintf(stderr, "cannot set up a half-band stage\n");
+        goto out;
+    }
+    for (uint32_t c = 0; c < v.count; c++)
+        draw_case(&opts, v.first + c, &v.cases[c]);
+
+    if (pool_init(&pool, opts.threads, verify_job, &v))
+    {
+        fprintf(stderr, "not enough memory\n");
+        goto out;
+    }
+    for (uint32_t j = 0; j < job_count; j++)
+    {
+        jobs[j].first = j * VERIFY_CHUNK;
+        jobs[j].count = (v.count - jobs[j].first < VERIFY_CHUNK) ? v.count - jobs[j].first : VERIFY_CHUNK;
+        if (pool_submit(&pool, &jobs[j]))
+        {
+            fprintf(stderr, "not enough memory\n");
+            goto out_pool;
+        }
+    }
+
+    fprintf(stderr, "%u case(s) of %u ms, seed %llu, on %u thread(s)\n", v.count, opts.length_ms,
+            (unsigned long long)opts.seed, opts.threads);
+    start = now_s();
+    if (pool_run(&pool))
+        fprintf(stderr, "some threads could not be started\n");
+    wall = now_s() - start;
+
+    failed = report(&v);
+    fprintf(stderr, "%u case(s) in %.2f s (%.0f cases/s), %u failure(s)\n", v.count, wall,
+            (wall > 0.0) ? v.count / wall : 0.0, failed);
+    ret = failed ? 1 : 0;
+
+out_pool:
+    pool_deinit(&pool);
+out:
+    workers_free(&v, opts.threads);
+    free(jobs);
+    free(v.results);
+    free(v.cases);
+    return ret;
+}